@@ -2,9 +2,7 @@
 #ifndef ACCELERATEDMATRIX_HPP
 #define ACCELERATEDMATRIX_HPP
 
-#ifdef __APPLE__
-#include <Accelerate/Accelerate.h>
-#endif
+#include "MatrixBackend.hpp"
 
 #include <vector>
 #include <stdexcept>
@@ -13,27 +11,100 @@
 #include <iomanip>
 #include <chrono>
 #include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <type_traits>
+#include <limits>
+#include <tuple>
+
+#include "MatrixAllocator.hpp"
+#include "MatrixView.hpp"
+#include "MatrixKernels.hpp"
+
+// Dense matrix over a floating-point scalar. AcceleratedMatrix (double) is
+// the default; AcceleratedMatrixF32 halves memory and bandwidth and runs
+// the float (sgemm / sgetrf) paths of the kernels and backends, for jobs
+// that can live with about seven significant digits. Converting between
+// the two is explicit: AcceleratedMatrixF32(a) or AcceleratedMatrix(f).
+template <typename T>
+class AcceleratedMatrixT {
+    static_assert(std::is_same<T, double>::value || std::is_same<T, float>::value,
+                  "AcceleratedMatrixT supports double and float");
 
-class AcceleratedMatrix {
 private:
-    std::vector<double> data;  // Column-major storage for BLAS compatibility
+    // Column-major storage for BLAS compatibility, 64-byte aligned. Column j
+    // starts at data[j * ld]; rows [rows, ld) of each column are padding and
+    // always hold zero, so whole-buffer element-wise kernels stay valid.
+    std::vector<T, MatrixAllocator<T>> data;
     size_t rows, cols;
+    size_t ld;
     
     // Convert (row, col) to linear index in column-major order
     size_t getIndex(size_t r, size_t c) const {
-        return c * rows + r;
+        return c * ld + r;
+    }
+    
+    // Overwrite the n x nrhs block b with A^{-1} b (square A)
+    void solveInPlace(T* b, size_t nrhs, size_t ldb) const {
+        if (rows == 0 || nrhs == 0) return;
+        const MatrixBackend& backend = MatrixBackends::active();
+        AcceleratedMatrixT a_copy = *this;
+        std::vector<int> pivots(rows);
+        if (MatrixBackends::luFactor(backend, rows, a_copy.getData(), a_copy.getLeadingDimension(),
+                                     pivots.data()) > 0) {
+            throw std::runtime_error("Matrix is singular: cannot solve system");
+        }
+        MatrixBackends::luSolve(backend, false, rows, nrhs, a_copy.getData(), a_copy.getLeadingDimension(),
+                                pivots.data(), b, ldb);
     }
+    
+#ifdef __APPLE__
+    // vDSP / CBLAS entry points for each precision
+    static void vdspAdd(const double* a, const double* b, double* out, size_t n) { vDSP_vaddD(a, 1, b, 1, out, 1, n); }
+    static void vdspAdd(const float* a, const float* b, float* out, size_t n) { vDSP_vadd(a, 1, b, 1, out, 1, n); }
+    // out = a - b (vDSP_vsub takes the subtrahend first)
+    static void vdspSubtract(const double* a, const double* b, double* out, size_t n) { vDSP_vsubD(b, 1, a, 1, out, 1, n); }
+    static void vdspSubtract(const float* a, const float* b, float* out, size_t n) { vDSP_vsub(b, 1, a, 1, out, 1, n); }
+    static void vdspScale(const double* a, double factor, double* out, size_t n) { vDSP_vsmulD(a, 1, &factor, out, 1, n); }
+    static void vdspScale(const float* a, float factor, float* out, size_t n) { vDSP_vsmul(a, 1, &factor, out, 1, n); }
+    static void vdspTranspose(const double* in, double* out, size_t m, size_t n) { vDSP_mtransD(in, 1, out, 1, m, n); }
+    static void vdspTranspose(const float* in, float* out, size_t m, size_t n) { vDSP_mtrans(in, 1, out, 1, m, n); }
+    static double vdspSumOfSquares(const double* a, size_t n) { double r; vDSP_svesqD(a, 1, &r, n); return r; }
+    static double vdspSumOfSquares(const float* a, size_t n) { float r; vDSP_svesq(a, 1, &r, n); return r; }
+    static void cblasAxpy(size_t n, double alpha, const double* x, double* y) { cblas_daxpy(static_cast<int>(n), alpha, x, 1, y, 1); }
+    static void cblasAxpy(size_t n, float alpha, const float* x, float* y) { cblas_saxpy(static_cast<int>(n), alpha, x, 1, y, 1); }
+#endif
 
 public:
+    using value_type = T;
+    using View = BasicMatrixView<T>;
+    using ConstView = BasicMatrixView<const T>;
+    
+    // Leading dimension used for a matrix with r rows. Tall enough columns are
+    // padded to a whole cache line (8 doubles or 16 floats, so every column is
+    // cache-line aligned), and strides that are a multiple of 4 KB are bumped
+    // by one cache line so a row walk does not map every column to the same
+    // cache sets. Depends on r only: matrices of equal shape share a layout.
+    static size_t paddedLeadingDimension(size_t r) {
+        constexpr size_t line = MATRIX_ALIGNMENT / sizeof(T);
+        constexpr size_t page = 4096 / sizeof(T);
+        if (r < 32) return r;
+        size_t padded = (r + line - 1) / line * line;
+        if (padded % page == 0) padded += line;
+        return padded;
+    }
+    
     // Constructors
-    AcceleratedMatrix(size_t r, size_t c) : rows(r), cols(c) {
-        data.resize(rows * cols, 0.0);
+    AcceleratedMatrixT(size_t r, size_t c) : rows(r), cols(c), ld(paddedLeadingDimension(r)) {
+        data.resize(ld * cols, T(0));
     }
     
-    AcceleratedMatrix(const std::vector<std::vector<double>>& input) {
+    AcceleratedMatrixT(const std::vector<std::vector<T>>& input) {
         rows = input.size();
         cols = rows > 0 ? input[0].size() : 0;
-        data.resize(rows * cols);
+        ld = paddedLeadingDimension(rows);
+        data.resize(ld * cols, T(0));
         
         // Convert to column-major storage
         for (size_t i = 0; i < rows; ++i) {
@@ -43,13 +114,29 @@ public:
         }
     }
 
+    // Copy the elements of a view (block, row, column or transpose) into a new matrix
+    explicit AcceleratedMatrixT(ConstView source)
+        : rows(source.getRows()), cols(source.getCols()), ld(paddedLeadingDimension(source.getRows())) {
+        data.resize(ld * cols, T(0));
+        MatrixKernels::copy(source, view());
+    }
+    
+    // Precision conversion: AcceleratedMatrixF32(a) rounds a double matrix
+    // to float, AcceleratedMatrix(f) widens a float matrix to double
+    template <typename U, typename = std::enable_if_t<!std::is_same<U, T>::value>>
+    explicit AcceleratedMatrixT(const AcceleratedMatrixT<U>& other)
+        : rows(other.getRows()), cols(other.getCols()), ld(paddedLeadingDimension(other.getRows())) {
+        data.resize(ld * cols, T(0));
+        MatrixKernels::convert(other.view(), view());
+    }
+
     // Accessors
-    double get(size_t r, size_t c) const {
+    T get(size_t r, size_t c) const {
         if (r >= rows || c >= cols) throw std::out_of_range("Matrix index out of range");
         return data[getIndex(r, c)];
     }
     
-    void set(size_t r, size_t c, double value) {
+    void set(size_t r, size_t c, T value) {
         if (r >= rows || c >= cols) throw std::out_of_range("Matrix index out of range");
         data[getIndex(r, c)] = value;
     }
@@ -57,126 +144,168 @@ public:
     size_t getRows() const { return rows; }
     size_t getCols() const { return cols; }
     
-    // Raw data access for BLAS operations
-    double* getData() { return data.data(); }
-    const double* getData() const { return data.data(); }
-
-#ifdef __APPLE__
-    // High-performance matrix multiplication using Accelerate BLAS
-    AcceleratedMatrix multiplyAccelerate(const AcceleratedMatrix& other) const {
+    // Raw data access for BLAS operations. Column j starts at
+    // getData() + j * getLeadingDimension(); pass that as lda/ldb/ldc.
+    T* getData() { return data.data(); }
+    const T* getData() const { return data.data(); }
+    size_t getLeadingDimension() const { return std::max<size_t>(ld, 1); }
+    
+    // Total buffer length including padding (getLeadingDimension() * cols)
+    size_t getStorageSize() const { return data.size(); }
+    
+    // Restore the zero-padding invariant after a whole-buffer operation that
+    // may not map 0 to 0 (adding a scalar, scaling by inf or NaN)
+    void zeroPadding() {
+        if (ld == rows) return;
+        for (size_t j = 0; j < cols; ++j) {
+            std::fill(data.begin() + j * ld + rows, data.begin() + (j + 1) * ld, T(0));
+        }
+    }
+    
+    // Non-owning views (see MatrixView.hpp); no element is copied
+    View view() { return View::columnMajor(data.data(), rows, cols, getLeadingDimension()); }
+    ConstView view() const { return ConstView::columnMajor(data.data(), rows, cols, getLeadingDimension()); }
+    
+    View view(size_t r0, size_t c0, size_t nr, size_t nc) { return view().block(r0, c0, nr, nc); }
+    ConstView view(size_t r0, size_t c0, size_t nr, size_t nc) const { return view().block(r0, c0, nr, nc); }
+    
+    View row(size_t r) { return view().row(r); }
+    ConstView row(size_t r) const { return view().row(r); }
+    View column(size_t c) { return view().column(c); }
+    ConstView column(size_t c) const { return view().column(c); }
+    
+    // C = alpha * A * B + beta * C on views (BLAS dgemm / sgemm semantics),
+    // computed by the active backend (see MatrixBackend.hpp)
+    static void gemm(T alpha, ConstView a, ConstView b, T beta, View c) {
+        if (a.getCols() != b.getRows() || a.getRows() != c.getRows() || b.getCols() != c.getCols()) {
+            throw std::invalid_argument("Matrix view dimensions incompatible for multiplication");
+        }
+        MatrixBackends::gemm(MatrixBackends::active(), alpha, a, b, beta, c);
+    }
+    
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+    // Matrix multiplication that always calls Accelerate / system BLAS dgemm,
+    // whichever backend is active
+    AcceleratedMatrixT multiplyAccelerate(const AcceleratedMatrixT& other) const {
+        static_assert(std::is_same<T, double>::value, "multiplyAccelerate is double precision only");
         if (cols != other.rows) {
             throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
         }
         
-        AcceleratedMatrix result(rows, other.cols);
+        AcceleratedMatrixT result(rows, other.cols);
         
         // BLAS parameters
         const double alpha = 1.0, beta = 0.0;
         const int m = static_cast<int>(rows);
         const int n = static_cast<int>(other.cols);
         const int k = static_cast<int>(cols);
-        const int lda = m, ldb = static_cast<int>(other.rows), ldc = m;
+        const int lda = static_cast<int>(getLeadingDimension());
+        const int ldb = static_cast<int>(other.getLeadingDimension());
+        const int ldc = static_cast<int>(result.getLeadingDimension());
+        
+        if (m == 0 || n == 0 || k == 0) return result;
         
+#ifdef __APPLE__
         // Call Accelerate BLAS dgemm
         cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans,
                     m, n, k, alpha,
                     getData(), lda,
                     other.getData(), ldb,
                     beta, result.getData(), ldc);
+#else
+        // Call system BLAS dgemm
+        const char trans = 'N';
+        dgemm_(&trans, &trans, &m, &n, &k, &alpha,
+               getData(), &lda,
+               other.getData(), &ldb,
+               &beta, result.getData(), &ldc);
+#endif
         
         return result;
     }
     
-    // Matrix-vector multiplication using Accelerate BLAS
-    std::vector<double> multiplyVector(const std::vector<double>& vec) const {
+#endif // ACCELERATED_MATRIX_HAS_LAPACK
+    
+    // Matrix-vector multiplication (active backend's gemv)
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const {
         if (cols != vec.size()) {
             throw std::invalid_argument("Vector size incompatible with matrix columns");
         }
         
-        std::vector<double> result(rows, 0.0);
-        
-        const double alpha = 1.0, beta = 0.0;
-        const int m = static_cast<int>(rows);
-        const int n = static_cast<int>(cols);
-        const int incx = 1, incy = 1;
-        
-        cblas_dgemv(CblasColMajor, CblasNoTrans,
-                    m, n, alpha,
-                    getData(), m,
-                    vec.data(), incx,
-                    beta, result.data(), incy);
-        
+        std::vector<T> result(rows, T(0));
+        if (rows > 0) MatrixBackends::gemv(MatrixBackends::active(), view(), vec.data(), result.data());
         return result;
     }
     
-    // LU factorization using Accelerate LAPACK
-    std::pair<AcceleratedMatrix, std::vector<int>> luFactorization() const {
+    // LU factorization with partial pivoting (active backend; LAPACK dgetrf /
+    // sgetrf when that is Accelerate / system LAPACK). Pivots are 1-based.
+    std::pair<AcceleratedMatrixT, std::vector<int>> luFactorization() const {
         if (rows != cols) throw std::invalid_argument("LU factorization requires square matrix");
         
-        AcceleratedMatrix lu_matrix = *this;  // Copy
+        AcceleratedMatrixT lu_matrix = *this;  // Copy
         std::vector<int> pivots(std::min(rows, cols));
         
-        int m = static_cast<int>(rows);
-        int n = static_cast<int>(cols);
-        int lda = m;
-        int info;
-        
-        // Call LAPACK LU factorization
-        dgetrf_(&m, &n, lu_matrix.getData(), &lda, pivots.data(), &info);
-        
-        if (info < 0) {
-            throw std::runtime_error("LAPACK dgetrf: illegal parameter at position " + std::to_string(-info));
-        } else if (info > 0) {
+        int info = MatrixBackends::luFactor(MatrixBackends::active(), rows, lu_matrix.getData(),
+                                            lu_matrix.getLeadingDimension(), pivots.data());
+        if (info > 0) {
             throw std::runtime_error("Matrix is singular: U[" + std::to_string(info-1) + "," + std::to_string(info-1) + "] = 0");
         }
         
         return {lu_matrix, pivots};
     }
     
-    // Matrix inversion using Accelerate LAPACK
-    AcceleratedMatrix inverse() const {
+    // Matrix inversion: LU factorization, then a solve against the identity
+    AcceleratedMatrixT inverse() const {
         if (rows != cols) throw std::invalid_argument("Only square matrices can be inverted");
         
-        // First, perform LU factorization
         auto [lu_matrix, pivots] = luFactorization();
         
-        int n = static_cast<int>(rows);
-        int lda = n;
-        int info;
-        
-        // Query optimal workspace size
-        double work_query;
-        int lwork = -1;
-        dgetri_(&n, lu_matrix.getData(), &lda, pivots.data(), &work_query, &lwork, &info);
-        
-        // Allocate workspace and compute inverse
-        lwork = static_cast<int>(work_query);
-        std::vector<double> work(lwork);
-        
-        dgetri_(&n, lu_matrix.getData(), &lda, pivots.data(), work.data(), &lwork, &info);
+        AcceleratedMatrixT result(rows, cols);
+        result.fillIdentity();
+        MatrixBackends::luSolve(MatrixBackends::active(), false, rows, cols, lu_matrix.getData(),
+                                lu_matrix.getLeadingDimension(), pivots.data(),
+                                result.getData(), result.getLeadingDimension());
+        return result;
+    }
+    
+    // Solve linear system Ax = b (LU factorization and solve, as dgesv / sgesv)
+    std::vector<T> solve(const std::vector<T>& b) const {
+        if (rows != cols) throw std::invalid_argument("Coefficient matrix must be square");
+        if (b.size() != rows) throw std::invalid_argument("Right-hand side vector size mismatch");
         
-        if (info < 0) {
-            throw std::runtime_error("LAPACK dgetri: illegal parameter at position " + std::to_string(-info));
-        } else if (info > 0) {
-            throw std::runtime_error("Matrix is singular and cannot be inverted");
-        }
+        std::vector<T> x = b;  // Solution overwrites RHS
+        solveInPlace(x.data(), 1, std::max<size_t>(rows, 1));
+        return x;
+    }
+    
+    // Solve AX = B for all columns of B with a single factorization
+    AcceleratedMatrixT solve(const AcceleratedMatrixT& b) const {
+        if (rows != cols) throw std::invalid_argument("Coefficient matrix must be square");
+        if (b.rows != rows) throw std::invalid_argument("Right-hand side matrix row count mismatch");
         
-        return lu_matrix;
+        AcceleratedMatrixT x = b;  // Solution overwrites RHS
+        solveInPlace(x.getData(), b.cols, x.getLeadingDimension());
+        return x;
     }
     
-    // Eigenvalue computation using Accelerate LAPACK
-    std::pair<std::vector<double>, std::vector<double>> eigenvalues() const {
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+private:
+    // dgeev on a copy: eigenvalue parts in wr / wi, right eigenvectors into
+    // vr (n x n, leading dimension ldvr) when non-null
+    void generalEigen(std::vector<double>& wr, std::vector<double>& wi, double* vr, int ldvr) const {
+        static_assert(std::is_same<T, double>::value, "eigenvalues is double precision only");
         if (rows != cols) throw std::invalid_argument("Eigenvalues only defined for square matrices");
         
-        AcceleratedMatrix a_copy = *this;  // LAPACK modifies input
+        AcceleratedMatrixT a_copy = *this;  // LAPACK modifies input
         
         int n = static_cast<int>(rows);
-        char jobvl = 'N', jobvr = 'N';  // Don't compute eigenvectors
-        int lda = n, ldvl = 1, ldvr = 1;
+        char jobvl = 'N', jobvr = vr ? 'V' : 'N';
+        int lda = static_cast<int>(a_copy.getLeadingDimension()), ldvl = 1;
         
-        std::vector<double> wr(n), wi(n);  // Real and imaginary parts
+        wr.assign(n, 0.0);  // Real and imaginary parts
+        wi.assign(n, 0.0);
+        if (n == 0) return;
         double* vl = nullptr;
-        double* vr = nullptr;
         
         // Query optimal workspace size
         double work_query;
@@ -200,47 +329,42 @@ public:
         } else if (info > 0) {
             throw std::runtime_error("Eigenvalue computation failed to converge");
         }
-        
+    }
+    
+public:
+    // Eigenvalue computation using LAPACK
+    std::pair<std::vector<double>, std::vector<double>> eigenvalues() const {
+        std::vector<double> wr, wi;
+        generalEigen(wr, wi, nullptr, 1);
         return {wr, wi};
     }
     
-    // Solve linear system Ax = b using LAPACK
-    std::vector<double> solve(const std::vector<double>& b) const {
-        if (rows != cols) throw std::invalid_argument("Coefficient matrix must be square");
-        if (b.size() != rows) throw std::invalid_argument("Right-hand side vector size mismatch");
-        
-        AcceleratedMatrix a_copy = *this;
-        std::vector<double> x = b;  // Solution overwrites RHS
-        std::vector<int> pivots(rows);
-        
-        int n = static_cast<int>(rows);
-        int nrhs = 1;
-        int lda = n, ldb = n;
-        int info;
-        
-        // Solve using LU factorization
-        dgesv_(&n, &nrhs, a_copy.getData(), &lda, pivots.data(),
-               x.data(), &ldb, &info);
-        
-        if (info < 0) {
-            throw std::runtime_error("LAPACK dgesv: illegal parameter at position " + std::to_string(-info));
-        } else if (info > 0) {
-            throw std::runtime_error("Matrix is singular: cannot solve system");
-        }
-        
-        return x;
+    // Eigenvalues and right eigenvectors (dgeev, unit 2-norm columns), in
+    // LAPACK's real packing: a real eigenvalue j owns column j; a complex
+    // pair j, j + 1 (wi[j] > 0) shares columns j and j + 1, the real and
+    // imaginary parts of the vector for wr[j] + i wi[j] (its conjugate
+    // belongs to j + 1). ComplexMatrix::fromEigenvectors unpacks it.
+    std::tuple<std::vector<double>, std::vector<double>, AcceleratedMatrixT> eigenvectors() const {
+        std::vector<double> wr, wi;
+        AcceleratedMatrixT vectors(rows, cols);
+        generalEigen(wr, wi, vectors.getData(), static_cast<int>(vectors.getLeadingDimension()));
+        return std::make_tuple(wr, wi, vectors);
     }
     
-    // QR decomposition using Accelerate LAPACK
-    std::pair<AcceleratedMatrix, AcceleratedMatrix> qrDecomposition() const {
-        AcceleratedMatrix a_copy = *this;
+    // QR decomposition using LAPACK (dgeqrf + dorgqr). Full: Q is m x m and
+    // R m x n. Economy: Q is m x k and R k x n for k = min(m, n), which is
+    // all a least-squares solve needs and keeps a tall problem at O(mn)
+    // memory instead of O(m^2).
+    std::pair<AcceleratedMatrixT, AcceleratedMatrixT> qrDecomposition(bool economy = false) const {
+        static_assert(std::is_same<T, double>::value, "qrDecomposition is double precision only");
+        AcceleratedMatrixT a_copy = *this;
         
         int m = static_cast<int>(rows);
         int n = static_cast<int>(cols);
-        int lda = m;
+        int lda = static_cast<int>(a_copy.getLeadingDimension());
         int min_mn = std::min(m, n);
         
-        std::vector<double> tau(min_mn);
+        std::vector<double> tau(std::max(min_mn, 1));
         
         // Query optimal workspace size
         double work_query;
@@ -250,7 +374,7 @@ public:
         dgeqrf_(&m, &n, a_copy.getData(), &lda, tau.data(), &work_query, &lwork, &info);
         
         // Perform QR factorization
-        lwork = static_cast<int>(work_query);
+        lwork = std::max(1, static_cast<int>(work_query));
         std::vector<double> work(lwork);
         
         dgeqrf_(&m, &n, a_copy.getData(), &lda, tau.data(), work.data(), &lwork, &info);
@@ -259,18 +383,29 @@ public:
             throw std::runtime_error("QR decomposition failed");
         }
         
-        // Extract R matrix (upper triangular part)
-        AcceleratedMatrix R(min_mn, cols);
-        for (size_t i = 0; i < min_mn; ++i) {
-            for (size_t j = i; j < cols; ++j) {
-                R.set(i, j, a_copy.get(i, j));
-            }
+        // Extract R matrix (upper trapezoidal part)
+        const size_t r_rows = economy ? static_cast<size_t>(min_mn) : rows;
+        AcceleratedMatrixT R(r_rows, cols);
+        MatrixKernels::copy(a_copy.view(0, 0, static_cast<size_t>(min_mn), cols),
+                            R.view(0, 0, static_cast<size_t>(min_mn), cols));
+        for (size_t j = 0; j < std::min(r_rows, cols); ++j) {
+            double* column = R.getData() + j * R.getLeadingDimension();
+            std::fill(column + j + 1, column + r_rows, 0.0);
         }
         
-        // Generate Q matrix
-        AcceleratedMatrix Q = a_copy;  // Start with the factored form
-        
-        dorgqr_(&m, &min_mn, &min_mn, Q.getData(), &lda, tau.data(),
+        // Generate Q from the reflectors in the first min(m, n) columns
+        int q_cols = economy ? min_mn : m;
+        AcceleratedMatrixT Q(rows, static_cast<size_t>(q_cols));
+        MatrixKernels::copy(a_copy.view(0, 0, rows, static_cast<size_t>(min_mn)),
+                            Q.view(0, 0, rows, static_cast<size_t>(min_mn)));
+        int ldq = static_cast<int>(Q.getLeadingDimension());
+        if (q_cols == 0) return {Q, R};
+        
+        lwork = -1;
+        dorgqr_(&m, &q_cols, &min_mn, Q.getData(), &ldq, tau.data(), &work_query, &lwork, &info);
+        lwork = std::max(1, static_cast<int>(work_query));
+        work.resize(lwork);
+        dorgqr_(&m, &q_cols, &min_mn, Q.getData(), &ldq, tau.data(),
                 work.data(), &lwork, &info);
         
         if (info != 0) {
@@ -280,105 +415,424 @@ public:
         return {Q, R};
     }
     
-  //  SVDResult svd() const;
-  
-#endif // __APPLE__
+    // Singular value decomposition by divide and conquer (dgesdd), several
+    // times faster than dgesvd for large matrices. Full: U is m x m and VT
+    // n x n. Economy: U is m x k and VT k x n for k = min(m, n).
+    // ValuesOnly: U and VT are 0 x 0.
+    enum class SVDMode { Full, Economy, ValuesOnly };
     
-    // Basic operations (fallback when Accelerate not available)
-    AcceleratedMatrix multiply(const AcceleratedMatrix& other) const {
-#ifdef __APPLE__
-        return multiplyAccelerate(other);
+    struct SVDResult {
+        std::vector<double> singularValues;  // descending
+        AcceleratedMatrixT U{0, 0};
+        AcceleratedMatrixT VT{0, 0};
+    };
+    
+    SVDResult svd(SVDMode mode = SVDMode::Full) const {
+        static_assert(std::is_same<T, double>::value, "svd is double precision only");
+        AcceleratedMatrixT a_copy = *this;  // LAPACK destroys the input
+        
+        int m = static_cast<int>(rows);
+        int n = static_cast<int>(cols);
+        int lda = static_cast<int>(a_copy.getLeadingDimension());
+        int min_mn = std::min(m, n);
+        
+        SVDResult result;
+        result.singularValues.resize(min_mn);
+        char jobz = 'N';
+        if (mode == SVDMode::Full) {
+            jobz = 'A';
+            result.U = AcceleratedMatrixT(rows, rows);
+            result.VT = AcceleratedMatrixT(cols, cols);
+        } else if (mode == SVDMode::Economy) {
+            jobz = 'S';
+            result.U = AcceleratedMatrixT(rows, static_cast<size_t>(min_mn));
+            result.VT = AcceleratedMatrixT(static_cast<size_t>(min_mn), cols);
+        }
+        if (min_mn == 0) return result;
+        
+        double* u = jobz == 'N' ? nullptr : result.U.getData();
+        double* vt = jobz == 'N' ? nullptr : result.VT.getData();
+        int ldu = jobz == 'N' ? 1 : static_cast<int>(result.U.getLeadingDimension());
+        int ldvt = jobz == 'N' ? 1 : static_cast<int>(result.VT.getLeadingDimension());
+        std::vector<int> iwork(8 * static_cast<size_t>(min_mn));
+        
+        // Query optimal workspace size
+        double work_query;
+        int lwork = -1;
+        int info;
+        
+        dgesdd_(&jobz, &m, &n, a_copy.getData(), &lda, result.singularValues.data(),
+                u, &ldu, vt, &ldvt, &work_query, &lwork, iwork.data(), &info);
+        
+        lwork = std::max(1, static_cast<int>(work_query));
+        std::vector<double> work(lwork);
+        
+        dgesdd_(&jobz, &m, &n, a_copy.getData(), &lda, result.singularValues.data(),
+                u, &ldu, vt, &ldvt, work.data(), &lwork, iwork.data(), &info);
+        
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dgesdd: illegal parameter at position " + std::to_string(-info));
+        } else if (info > 0) {
+            throw std::runtime_error("SVD failed to converge");
+        }
+        return result;
+    }
+
+    // Minimum-norm least-squares solution x = V diag(1/s) U^T b, with the
+    // singular values below max(m, n) * eps * s_max treated as zero. Handles
+    // wide and rank-deficient matrices, where QR and the normal equations
+    // break down.
+    std::vector<double> solveMinimumNorm(const std::vector<double>& b) const {
+        static_assert(std::is_same<T, double>::value, "solveMinimumNorm is double precision only");
+        if (b.size() != rows) {
+            throw std::invalid_argument("Right-hand side size does not match the matrix rows");
+        }
+
+        SVDResult decomposition = svd(SVDMode::Economy);
+        const std::vector<double>& s = decomposition.singularValues;
+        std::vector<double> x(cols, 0.0);
+        if (s.empty()) return x;
+
+        const double cutoff = static_cast<double>(std::max(rows, cols)) *
+                              std::numeric_limits<double>::epsilon() * s[0];
+        // c = diag(1/s) U^T b over the retained singular values
+        std::vector<double> c = decomposition.U.transpose().multiplyVector(b);
+        size_t rank = 0;
+        while (rank < s.size() && s[rank] > cutoff) {
+            c[rank] /= s[rank];
+            ++rank;
+        }
+        c.resize(rank);
+        // x = V c, V^T being the first rank rows of VT
+        for (size_t j = 0; j < cols; ++j) {
+            double sum = 0.0;
+            for (size_t i = 0; i < rank; ++i) {
+                sum += decomposition.VT.get(i, j) * c[i];
+            }
+            x[j] = sum;
+        }
+        return x;
+    }
+
+#endif // ACCELERATED_MATRIX_HAS_LAPACK
+    
+    // Eigen-decomposition of a symmetric matrix (only the lower triangle is
+    // read): real eigenvalues in ascending order and, when computeVectors is
+    // set, orthonormal eigenvectors as the columns of the second matrix
+    // (0 x 0 otherwise). LAPACK dsyevd (divide and conquer) when linked,
+    // the built-in tridiagonal QL iteration otherwise.
+    std::pair<std::vector<double>, AcceleratedMatrixT> eigenSymmetric(bool computeVectors = true) const {
+        static_assert(std::is_same<T, double>::value, "eigenSymmetric is double precision only");
+        if (rows != cols) throw std::invalid_argument("Eigenvalues only defined for square matrices");
+        
+        AcceleratedMatrixT a = *this;  // Overwritten by the eigenvectors
+        std::vector<double> w(rows);
+        
+        if (rows > 0) {
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+            char jobz = computeVectors ? 'V' : 'N', uplo = 'L';
+            int n = static_cast<int>(rows);
+            int lda = static_cast<int>(a.getLeadingDimension());
+            int info;
+            
+            // Query optimal workspace sizes
+            double work_query;
+            int iwork_query;
+            int lwork = -1, liwork = -1;
+            dsyevd_(&jobz, &uplo, &n, a.getData(), &lda, w.data(),
+                    &work_query, &lwork, &iwork_query, &liwork, &info);
+            
+            lwork = static_cast<int>(work_query);
+            liwork = iwork_query;
+            std::vector<double> work(lwork);
+            std::vector<int> iwork(liwork);
+            dsyevd_(&jobz, &uplo, &n, a.getData(), &lda, w.data(),
+                    work.data(), &lwork, iwork.data(), &liwork, &info);
+            
+            if (info < 0) {
+                throw std::runtime_error("LAPACK dsyevd: illegal parameter at position " + std::to_string(-info));
+            } else if (info > 0) {
+                throw std::runtime_error("Symmetric eigenvalue computation failed to converge");
+            }
 #else
-        // Fallback to basic implementation
-        if (cols != other.rows) {
-            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+            if (MatrixKernels::symmetricEigen(rows, a.getData(), a.getLeadingDimension(), w.data(), computeVectors) != 0) {
+                throw std::runtime_error("Symmetric eigenvalue computation failed to converge");
+            }
+#endif
         }
         
-        AcceleratedMatrix result(rows, other.cols);
+        if (!computeVectors) a = AcceleratedMatrixT(0, 0);
+        return {w, a};
+    }
+    
+    // Eigenvalues first..last (0-based, inclusive, ascending order) of a
+    // symmetric matrix and, when computeVectors is set, their eigenvectors
+    // (n x (last - first + 1)). With LAPACK this is the MRRR driver dsyevr,
+    // which after the tridiagonal reduction only computes the requested
+    // pairs: the top 10 modes of a large matrix skip most of the work of a
+    // full decomposition. The built-in path decomposes fully and keeps the
+    // requested columns.
+    std::pair<std::vector<double>, AcceleratedMatrixT> eigenSymmetric(bool computeVectors, size_t first, size_t last) const {
+        static_assert(std::is_same<T, double>::value, "eigenSymmetric is double precision only");
+        if (rows != cols) throw std::invalid_argument("Eigenvalues only defined for square matrices");
+        if (first > last || last >= rows) {
+            throw std::out_of_range("Eigenvalue index range outside the spectrum");
+        }
+        const size_t count = last - first + 1;
         
-        for (size_t i = 0; i < rows; ++i) {
-            for (size_t j = 0; j < other.cols; ++j) {
-                double sum = 0.0;
-                for (size_t k = 0; k < cols; ++k) {
-                    sum += get(i, k) * other.get(k, j);
-                }
-                result.set(i, j, sum);
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        AcceleratedMatrixT a = *this;  // dsyevr destroys the input
+        AcceleratedMatrixT z(computeVectors ? rows : 0, computeVectors ? count : 0);
+        std::vector<double> w(rows);
+        std::vector<int> isuppz(2 * count);
+        
+        char jobz = computeVectors ? 'V' : 'N', range = 'I', uplo = 'L';
+        int n = static_cast<int>(rows);
+        int lda = static_cast<int>(a.getLeadingDimension());
+        int ldz = computeVectors ? static_cast<int>(z.getLeadingDimension()) : 1;
+        int il = static_cast<int>(first + 1), iu = static_cast<int>(last + 1);
+        double vl = 0.0, vu = 0.0;
+        double abstol = 0.0;  // Default tolerance; MRRR attains full accuracy regardless
+        int found;
+        int info;
+        
+        // Query optimal workspace sizes
+        double work_query;
+        int iwork_query;
+        int lwork = -1, liwork = -1;
+        dsyevr_(&jobz, &range, &uplo, &n, a.getData(), &lda, &vl, &vu, &il, &iu, &abstol, &found,
+                w.data(), z.getData(), &ldz, isuppz.data(), &work_query, &lwork, &iwork_query, &liwork, &info);
+        
+        lwork = static_cast<int>(work_query);
+        liwork = iwork_query;
+        std::vector<double> work(lwork);
+        std::vector<int> iwork(liwork);
+        dsyevr_(&jobz, &range, &uplo, &n, a.getData(), &lda, &vl, &vu, &il, &iu, &abstol, &found,
+                w.data(), z.getData(), &ldz, isuppz.data(), work.data(), &lwork, iwork.data(), &liwork, &info);
+        
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dsyevr: illegal parameter at position " + std::to_string(-info));
+        } else if (info > 0) {
+            throw std::runtime_error("Symmetric eigenvalue computation failed to converge");
+        }
+        w.resize(count);
+        return {w, z};
+#else
+        auto full = eigenSymmetric(computeVectors);
+        std::vector<double> w(full.first.begin() + first, full.first.begin() + last + 1);
+        if (!computeVectors) return {w, full.second};
+        return {w, AcceleratedMatrixT(full.second.view(0, first, rows, count))};
+#endif
+    }
+    
+    // True when |a_ij - a_ji| <= tolerance for all i, j
+    bool isSymmetric(T tolerance = T(0)) const {
+        if (rows != cols) return false;
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = j + 1; i < rows; ++i) {
+                if (std::abs(data[i + j * ld] - data[j + i * ld]) > tolerance) return false;
             }
         }
+        return true;
+    }
+    
+    // Basic operations
+    AcceleratedMatrixT multiply(const AcceleratedMatrixT& other) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+        
+        AcceleratedMatrixT result(rows, other.cols);
+        gemm(T(1), view(), other.view(), T(0), result.view());
+        return result;
+    }
+    
+    // A^T A (cols x cols), e.g. the normal-equations matrix. The result is
+    // symmetric, so the active backend's syrk computes only its lower
+    // triangle (BLAS syrk, or GEMMs on the column blocks on and below the
+    // diagonal) and it is then mirrored: about half the flops of
+    // transpose().multiply(*this).
+    AcceleratedMatrixT gram() const {
+        AcceleratedMatrixT result(cols, cols);
+        if (cols == 0 || rows == 0) return result;
+        
+        MatrixBackends::syrk(MatrixBackends::active(), view(), result.view());
+        
+        T* c = result.getData();
+        for (size_t j = 1; j < cols; ++j) {
+            for (size_t i = 0; i < j; ++i) c[i + j * result.ld] = c[j + i * result.ld];
+        }
         return result;
-#endif
     }
     
-    AcceleratedMatrix add(const AcceleratedMatrix& other) const {
+    AcceleratedMatrixT add(const AcceleratedMatrixT& other) const {
         if (rows != other.rows || cols != other.cols) {
             throw std::invalid_argument("Matrix dimensions must match for addition");
         }
         
-        AcceleratedMatrix result(rows, cols);
+        AcceleratedMatrixT result(rows, cols);
         
 #ifdef __APPLE__
         // Use Accelerate vDSP for vector addition
-        vDSP_vaddD(getData(), 1, other.getData(), 1, result.getData(), 1, rows * cols);
+        vdspAdd(getData(), other.getData(), result.getData(), data.size());
 #else
-        for (size_t i = 0; i < data.size(); ++i) {
-            result.data[i] = data[i] + other.data[i];
-        }
+        MatrixKernels::add(data.size(), data.data(), other.data.data(), result.data.data());
 #endif
         return result;
     }
     
-    AcceleratedMatrix subtract(const AcceleratedMatrix& other) const {
+    AcceleratedMatrixT subtract(const AcceleratedMatrixT& other) const {
         if (rows != other.rows || cols != other.cols) {
             throw std::invalid_argument("Matrix dimensions must match for subtraction");
         }
         
-        AcceleratedMatrix result(rows, cols);
+        AcceleratedMatrixT result(rows, cols);
         
 #ifdef __APPLE__
         // Use Accelerate vDSP for vector subtraction
-        vDSP_vsubD(other.getData(), 1, getData(), 1, result.getData(), 1, rows * cols);
+        vdspSubtract(getData(), other.getData(), result.getData(), data.size());
 #else
-        for (size_t i = 0; i < data.size(); ++i) {
-            result.data[i] = data[i] - other.data[i];
-        }
+        MatrixKernels::subtract(data.size(), data.data(), other.data.data(), result.data.data());
 #endif
         return result;
     }
     
-    AcceleratedMatrix scale(double factor) const {
-        AcceleratedMatrix result(rows, cols);
+    AcceleratedMatrixT scale(T factor) const {
+        AcceleratedMatrixT result(rows, cols);
         
 #ifdef __APPLE__
         // Use Accelerate vDSP for scalar multiplication
-        vDSP_vsmulD(getData(), 1, &factor, result.getData(), 1, rows * cols);
+        vdspScale(getData(), factor, result.getData(), data.size());
 #else
-        for (size_t i = 0; i < data.size(); ++i) {
-            result.data[i] = data[i] * factor;
-        }
+        MatrixKernels::scale(data.size(), data.data(), factor, result.data.data());
 #endif
+        if (!std::isfinite(factor)) result.zeroPadding();
         return result;
     }
     
-    AcceleratedMatrix transpose() const {
-        AcceleratedMatrix result(cols, rows);
-        
+    AcceleratedMatrixT transpose() const {
+        AcceleratedMatrixT result(cols, rows);
+        transposeInto(result);
+        return result;
+    }
+    
+    // In-place and output-parameter forms: these reuse existing storage and
+    // never allocate, so steady-state loops can run without temporaries
+    void addInPlace(const AcceleratedMatrixT& other) {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for addition");
+        }
 #ifdef __APPLE__
-        // Use Accelerate vDSP for matrix transpose
-        vDSP_mtransD(getData(), 1, result.getData(), 1, cols, rows);
+        vdspAdd(getData(), other.getData(), getData(), data.size());
 #else
-        for (size_t i = 0; i < rows; ++i) {
-            for (size_t j = 0; j < cols; ++j) {
-                result.set(j, i, get(i, j));
-            }
+        MatrixKernels::add(data.size(), data.data(), other.data.data(), data.data());
+#endif
+    }
+    
+    void subtractInPlace(const AcceleratedMatrixT& other) {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for subtraction");
         }
+#ifdef __APPLE__
+        vdspSubtract(getData(), other.getData(), getData(), data.size());
+#else
+        MatrixKernels::subtract(data.size(), data.data(), other.data.data(), data.data());
 #endif
-        return result;
+    }
+    
+    void scaleInPlace(T factor) {
+#ifdef __APPLE__
+        vdspScale(getData(), factor, getData(), data.size());
+#else
+        MatrixKernels::scale(data.size(), data.data(), factor, data.data());
+#endif
+        if (!std::isfinite(factor)) zeroPadding();
+    }
+    
+    // this = this + alpha * x (BLAS daxpy / saxpy)
+    void axpy(T alpha, const AcceleratedMatrixT& x) {
+        if (rows != x.rows || cols != x.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for accumulate");
+        }
+#ifdef __APPLE__
+        cblasAxpy(data.size(), alpha, x.getData(), getData());
+#else
+        MatrixKernels::axpy(alpha, x.view(), view());
+#endif
+    }
+    
+    // this = alpha * a * b + beta * this (BLAS dgemm semantics; beta = 0 ignores
+    // the current contents). The receiver must already be a.rows x b.cols.
+    void gemm(T alpha, const AcceleratedMatrixT& a, const AcceleratedMatrixT& b, T beta) {
+        if (&a == this || &b == this) {
+            throw std::invalid_argument("gemm output must not alias an input");
+        }
+        gemm(alpha, a.view(), b.view(), beta, view());
+    }
+    
+    // result = this * other, written into an existing matrix of the right shape
+    void multiplyInto(const AcceleratedMatrixT& other, AcceleratedMatrixT& result) const {
+        result.gemm(T(1), *this, other, T(0));
+    }
+    
+    // result = transpose of this, written into an existing cols x rows matrix
+    void transposeInto(AcceleratedMatrixT& result) const {
+        if (result.rows != cols || result.cols != rows) {
+            throw std::invalid_argument("Transpose output must be cols x rows");
+        }
+        if (&result == this) throw std::invalid_argument("transposeInto output must not alias the input");
+#ifdef __APPLE__
+        if (ld == rows && result.ld == cols) {
+            // Use Accelerate vDSP for matrix transpose (unpadded storage only)
+            vdspTranspose(getData(), result.getData(), cols, rows);
+            return;
+        }
+#endif
+        MatrixKernels::transpose(rows, cols, getData(), getLeadingDimension(),
+                                 result.getData(), result.getLeadingDimension());
+    }
+    
+    // Transpose without a second buffer. Square matrices swap tiles in place;
+    // rectangular ones are packed to ld == rows, permuted by cycle following
+    // and re-padded for the new row count (which may grow the buffer once).
+    // Views taken before a rectangular transpose are invalidated (so Lua only
+    // gets the square case).
+    void transposeInPlace() {
+        if (rows == cols) {
+            MatrixKernels::transposeSquareInPlace(rows, getData(), getLeadingDimension());
+            return;
+        }
+        if (ld != rows) {
+            for (size_t j = 1; j < cols; ++j) {
+                std::copy(data.begin() + j * ld, data.begin() + j * ld + rows, data.begin() + j * rows);
+            }
+        }
+        MatrixKernels::transposeInPlace(rows, cols, getData());
+        std::swap(rows, cols);
+        
+        const size_t newLd = paddedLeadingDimension(rows);
+        data.resize(newLd * cols);
+        if (newLd != rows) {
+            for (size_t j = cols; j-- > 1;) {
+                std::copy_backward(data.begin() + j * rows, data.begin() + (j + 1) * rows,
+                                   data.begin() + j * newLd + rows);
+            }
+        }
+        ld = newLd;
+        zeroPadding();
+    }
+    
+    // Overwrite with the contents of a same-shaped matrix without reallocating
+    void copyFrom(const AcceleratedMatrixT& other) {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for copy");
+        }
+        if (&other != this) std::copy(other.data.begin(), other.data.end(), data.begin());
     }
     
     double determinant() const {
         if (rows != cols) throw std::invalid_argument("Determinant only defined for square matrices");
         
-#ifdef __APPLE__
         try {
             auto [lu_matrix, pivots] = luFactorization();
             
@@ -397,19 +851,6 @@ public:
         } catch (...) {
             return 0.0;  // Singular matrix
         }
-#else
-        // Fallback: simple recursive determinant (not efficient for large matrices)
-        if (rows == 1) return get(0, 0);
-        if (rows == 2) return get(0, 0) * get(1, 1) - get(0, 1) * get(1, 0);
-        
-        double det = 0.0;
-        for (size_t c = 0; c < cols; ++c) {
-            AcceleratedMatrix minor = getMinor(0, c);
-            double cofactor = (c % 2 == 0 ? 1 : -1) * get(0, c) * minor.determinant();
-            det += cofactor;
-        }
-        return det;
-#endif
     }
 
     // Utility methods
@@ -421,39 +862,37 @@ public:
             seeded = true;
         }
         
-        for (double& val : data) {
-            double random_01 = static_cast<double>(std::rand()) / RAND_MAX;
-            val = min + (max - min) * random_01;
+        // Padding rows stay zero
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = 0; i < rows; ++i) {
+                double random_01 = static_cast<double>(std::rand()) / RAND_MAX;
+                data[getIndex(i, j)] = static_cast<T>(min + (max - min) * random_01);
+            }
         }
     }
 
     void fillIdentity() {
         if (rows != cols) throw std::invalid_argument("Identity matrix must be square");
         
-        std::fill(data.begin(), data.end(), 0.0);
+        std::fill(data.begin(), data.end(), T(0));
         for (size_t i = 0; i < rows; ++i) {
-            set(i, i, 1.0);
+            set(i, i, T(1));
         }
     }
     
     double norm() const {
 #ifdef __APPLE__
         // Use Accelerate vDSP for efficient norm calculation
-        double result;
-        vDSP_svesqD(getData(), 1, &result, data.size());
-        return std::sqrt(result);
+        return std::sqrt(vdspSumOfSquares(getData(), data.size()));
 #else
-        double sum = 0.0;
-        for (double val : data) {
-            sum += val * val;
-        }
-        return std::sqrt(sum);
+        return std::sqrt(MatrixKernels::sumOfSquares(data.size(), data.data()));
 #endif
     }
     
     std::string toString() const {
         std::stringstream ss;
-        ss << "AcceleratedMatrix " << rows << "x" << cols << ":\n";
+        ss << (std::is_same<T, float>::value ? "AcceleratedMatrixF32 " : "AcceleratedMatrix ")
+           << rows << "x" << cols << ":\n";
         ss << std::fixed << std::setprecision(6);
         
         for (size_t i = 0; i < rows; ++i) {
@@ -466,25 +905,9 @@ public:
         }
         return ss.str();
     }
-
-private:
-    AcceleratedMatrix getMinor(size_t row, size_t col) const {
-        AcceleratedMatrix minor(rows - 1, cols - 1);
-        size_t minor_row = 0;
-        
-        for (size_t i = 0; i < rows; ++i) {
-            if (i == row) continue;
-            size_t minor_col = 0;
-            
-            for (size_t j = 0; j < cols; ++j) {
-                if (j == col) continue;
-                minor.set(minor_row, minor_col, get(i, j));
-                minor_col++;
-            }
-            minor_row++;
-        }
-        return minor;
-    }
 };
 
+using AcceleratedMatrix = AcceleratedMatrixT<double>;
+using AcceleratedMatrixF32 = AcceleratedMatrixT<float>;
+
 #endif // ACCELERATEDMATRIX_HPP
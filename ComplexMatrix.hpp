@@ -0,0 +1,514 @@
+// ComplexMatrix.hpp - Dense complex matrices (zgemm / zgesv / zgeev)
+#ifndef COMPLEXMATRIX_HPP
+#define COMPLEXMATRIX_HPP
+
+#include "AcceleratedMatrix.hpp"
+
+#include <complex>
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+#include "MatrixAllocator.hpp"
+#include "MatrixThreadPool.hpp"
+
+// Built-in complex LU kernels, used when LAPACK is not linked. Column-major
+// with LAPACK conventions (1-based pivots, info-style return codes). Inner
+// loops spell the products out on the real and imaginary parts, so they
+// vectorize instead of calling the NaN-checking std::complex operator*.
+namespace MatrixKernels {
+namespace complex {
+
+using Complex = std::complex<double>;
+
+// y += alpha * x
+inline void axpy(size_t n, Complex alpha, const Complex* x, Complex* y) {
+    const double ar = alpha.real(), ai = alpha.imag();
+    const double* xs = reinterpret_cast<const double*>(x);
+    double* ys = reinterpret_cast<double*>(y);
+    for (size_t i = 0; i < n; ++i) {
+        const double xr = xs[2 * i], xi = xs[2 * i + 1];
+        ys[2 * i] += ar * xr - ai * xi;
+        ys[2 * i + 1] += ar * xi + ai * xr;
+    }
+}
+
+// out = alpha * x (out may alias x)
+inline void scale(size_t n, Complex alpha, const Complex* x, Complex* out) {
+    const double ar = alpha.real(), ai = alpha.imag();
+    const double* xs = reinterpret_cast<const double*>(x);
+    double* os = reinterpret_cast<double*>(out);
+    for (size_t i = 0; i < n; ++i) {
+        const double xr = xs[2 * i], xi = xs[2 * i + 1];
+        os[2 * i] = ar * xr - ai * xi;
+        os[2 * i + 1] = ar * xi + ai * xr;
+    }
+}
+
+// |Re z| + |Im z|, the pivot magnitude LAPACK's izamax uses
+inline double abs1(Complex z) { return std::abs(z.real()) + std::abs(z.imag()); }
+
+// In-place LU with partial pivoting of an n x n matrix (zgetrf semantics).
+// Right-looking; the rank-1 trailing update is parallel over columns.
+// Returns 0, or the 1-based index of the first exactly-zero pivot.
+inline int luFactor(size_t n, Complex* a, size_t lda, int* pivots) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    int info = 0;
+    for (size_t j = 0; j < n; ++j) {
+        Complex* colj = a + j * lda;
+
+        size_t p = j;
+        double maxAbs = abs1(colj[j]);
+        for (size_t i = j + 1; i < n; ++i) {
+            if (abs1(colj[i]) > maxAbs) {
+                maxAbs = abs1(colj[i]);
+                p = i;
+            }
+        }
+        pivots[j] = static_cast<int>(p + 1);
+
+        if (colj[p] == Complex(0.0)) {
+            if (info == 0) info = static_cast<int>(j + 1);
+            continue;
+        }
+        if (p != j) {
+            for (size_t c = 0; c < n; ++c) std::swap(a[j + c * lda], a[p + c * lda]);
+        }
+
+        const size_t rest = n - j - 1;
+        if (rest == 0) continue;
+        scale(rest, Complex(1.0) / colj[j], colj + j + 1, colj + j + 1);
+
+        const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / rest);
+        pool.parallelFor(j + 1, n, minCols, [=](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                Complex* colc = a + c * lda;
+                if (colc[j] != Complex(0.0)) axpy(rest, -colc[j], colj + j + 1, colc + j + 1);
+            }
+        });
+    }
+    return info;
+}
+
+// Solve A X = B in place (B is n x nrhs) from the factors of luFactor
+// (zgetrs 'N'), parallel over the columns of B
+inline void luSolve(size_t n, size_t nrhs, const Complex* lu, size_t lda, const int* pivots,
+                    Complex* b, size_t ldb) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(n * n, 1));
+    pool.parallelFor(0, nrhs, minCols, [=](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            Complex* x = b + c * ldb;
+            for (size_t i = 0; i < n; ++i) {
+                const size_t p = static_cast<size_t>(pivots[i] - 1);
+                if (p != i) std::swap(x[i], x[p]);
+            }
+            // L has a unit diagonal
+            for (size_t j = 0; j < n; ++j) {
+                if (x[j] != Complex(0.0)) axpy(n - j - 1, -x[j], lu + j + 1 + j * lda, x + j + 1);
+            }
+            for (size_t j = n; j-- > 0;) {
+                x[j] /= lu[j + j * lda];
+                if (x[j] != Complex(0.0)) axpy(j, -x[j], lu + j * lda, x);
+            }
+        }
+    });
+}
+
+} // namespace complex
+} // namespace MatrixKernels
+
+// Dense complex matrix, stored interleaved (std::complex<double>) and
+// column-major, so the buffer is handed to zgemm / zgetrf / zgeev as-is.
+// Built from one or two AcceleratedMatrix parts, or from the separate
+// real / imaginary eigenvalue vectors AcceleratedMatrix::eigenvalues()
+// returns. With BLAS/LAPACK linked, products and solves are zgemm and
+// zgetrf / zgetrs; otherwise a product is four real GEMMs on the active
+// backend and solves use the built-in complex LU. Eigenvalues need LAPACK,
+// as for AcceleratedMatrix.
+class ComplexMatrix {
+public:
+    using Complex = std::complex<double>;
+
+private:
+    // Column j starts at data[j * rows]; no padding
+    std::vector<Complex, MatrixAllocator<Complex>> data;
+    size_t rows, cols;
+
+    size_t getIndex(size_t r, size_t c) const { return c * rows + r; }
+
+    // Interleaved storage viewed as 2 * size doubles, for the real kernels
+    double* scalars() { return reinterpret_cast<double*>(data.data()); }
+    const double* scalars() const { return reinterpret_cast<const double*>(data.data()); }
+
+    // Real matrix of f(element)
+    template <typename F>
+    AcceleratedMatrix mapReal(F f) const {
+        AcceleratedMatrix result(rows, cols);
+        double* out = result.getData();
+        const size_t ldr = result.getLeadingDimension();
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = 0; i < rows; ++i) out[i + j * ldr] = f(data[getIndex(i, j)]);
+        }
+        return result;
+    }
+
+#ifdef __APPLE__
+    using LapackComplex = __CLPK_doublecomplex;
+#else
+    using LapackComplex = Complex;
+#endif
+    static LapackComplex* lapackData(const Complex* p) {
+        return reinterpret_cast<LapackComplex*>(const_cast<Complex*>(p));
+    }
+
+    // Factor a copy of this square matrix; throws if it is singular
+    ComplexMatrix luFactor(std::vector<int>& pivots) const {
+        if (rows != cols) throw std::invalid_argument("LU factorization requires square matrix");
+        ComplexMatrix lu = *this;
+        pivots.assign(rows, 0);
+        if (rows == 0) return lu;
+        int info;
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        int n = static_cast<int>(rows);
+        int lda = static_cast<int>(lu.getLeadingDimension());
+        zgetrf_(&n, &n, lapackData(lu.getData()), &lda, pivots.data(), &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK zgetrf: illegal parameter at position " + std::to_string(-info));
+        }
+#else
+        info = MatrixKernels::complex::luFactor(rows, lu.getData(), lu.getLeadingDimension(), pivots.data());
+#endif
+        if (info > 0) {
+            throw std::runtime_error("Matrix is singular: U[" + std::to_string(info-1) + "," + std::to_string(info-1) + "] = 0");
+        }
+        return lu;
+    }
+
+    // Overwrite the n x nrhs block b with A^{-1} b (zgesv)
+    void solveInPlace(Complex* b, size_t nrhs, size_t ldb) const {
+        std::vector<int> pivots;
+        const ComplexMatrix lu = luFactor(pivots);
+        if (rows == 0 || nrhs == 0) return;
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        char trans = 'N';
+        int n = static_cast<int>(rows), nr = static_cast<int>(nrhs);
+        int lda = static_cast<int>(lu.getLeadingDimension()), ldbi = static_cast<int>(ldb);
+        int info;
+        zgetrs_(&trans, &n, &nr, lapackData(lu.getData()), &lda, pivots.data(), lapackData(b), &ldbi, &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK zgetrs: illegal parameter at position " + std::to_string(-info));
+        }
+#else
+        MatrixKernels::complex::luSolve(rows, nrhs, lu.getData(), lu.getLeadingDimension(), pivots.data(), b, ldb);
+#endif
+    }
+
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+    // zgeev on a copy; vectors (n x n, right eigenvectors) is filled when non-null
+    std::vector<Complex> computeEigen(ComplexMatrix* vectors) const {
+        if (rows != cols) throw std::invalid_argument("Eigenvalues only defined for square matrices");
+        std::vector<Complex> w(rows);
+        if (rows == 0) return w;
+
+        ComplexMatrix a_copy = *this;  // LAPACK modifies input
+        char jobvl = 'N', jobvr = vectors ? 'V' : 'N';
+        int n = static_cast<int>(rows);
+        int lda = static_cast<int>(a_copy.getLeadingDimension()), ldvl = 1;
+        int ldvr = vectors ? n : 1;
+        Complex* vr = vectors ? vectors->getData() : nullptr;
+        std::vector<double> rwork(2 * rows);
+
+        // Query optimal workspace size
+        Complex work_query;
+        int lwork = -1;
+        int info;
+        zgeev_(&jobvl, &jobvr, &n, lapackData(a_copy.getData()), &lda, lapackData(w.data()),
+               nullptr, &ldvl, lapackData(vr), &ldvr, lapackData(&work_query), &lwork, rwork.data(), &info);
+
+        lwork = static_cast<int>(work_query.real());
+        std::vector<Complex> work(std::max(lwork, 1));
+        zgeev_(&jobvl, &jobvr, &n, lapackData(a_copy.getData()), &lda, lapackData(w.data()),
+               nullptr, &ldvl, lapackData(vr), &ldvr, lapackData(work.data()), &lwork, rwork.data(), &info);
+
+        if (info < 0) {
+            throw std::runtime_error("LAPACK zgeev: illegal parameter at position " + std::to_string(-info));
+        } else if (info > 0) {
+            throw std::runtime_error("Eigenvalue computation failed to converge");
+        }
+        return w;
+    }
+#endif
+
+public:
+    ComplexMatrix(size_t r, size_t c) : data(r * c, Complex(0.0)), rows(r), cols(c) {}
+
+    // Real matrix with zero imaginary part
+    explicit ComplexMatrix(const AcceleratedMatrix& real)
+        : ComplexMatrix(real.getRows(), real.getCols()) {
+        const double* re = real.getData();
+        const size_t ldr = real.getLeadingDimension();
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = 0; i < rows; ++i) data[getIndex(i, j)] = Complex(re[i + j * ldr], 0.0);
+        }
+    }
+
+    ComplexMatrix(const AcceleratedMatrix& real, const AcceleratedMatrix& imag)
+        : ComplexMatrix(real.getRows(), real.getCols()) {
+        if (imag.getRows() != rows || imag.getCols() != cols) {
+            throw std::invalid_argument("Real and imaginary parts must have the same dimensions");
+        }
+        const double* re = real.getData();
+        const double* im = imag.getData();
+        const size_t ldr = real.getLeadingDimension();
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = 0; i < rows; ++i) data[getIndex(i, j)] = Complex(re[i + j * ldr], im[i + j * ldr]);
+        }
+    }
+
+    // Column vector from separate parts, e.g. the pair AcceleratedMatrix::eigenvalues() returns
+    static ComplexMatrix fromParts(const std::vector<double>& real, const std::vector<double>& imag) {
+        if (real.size() != imag.size()) {
+            throw std::invalid_argument("Real and imaginary parts must have the same length");
+        }
+        ComplexMatrix result(real.size(), 1);
+        for (size_t i = 0; i < real.size(); ++i) result.data[i] = Complex(real[i], imag[i]);
+        return result;
+    }
+
+    // Unpacks real dgeev eigenvectors (AcceleratedMatrix::eigenvectors): for
+    // a complex pair (imag[j] > 0) columns j and j + 1 hold the real and
+    // imaginary parts of v_j, and v_{j+1} is its conjugate
+    static ComplexMatrix fromEigenvectors(const std::vector<double>& imag, const AcceleratedMatrix& packed) {
+        if (packed.getCols() != imag.size()) {
+            throw std::invalid_argument("Eigenvector count does not match eigenvalues");
+        }
+        const size_t n = packed.getRows();
+        ComplexMatrix result(n, packed.getCols());
+        const double* v = packed.getData();
+        const size_t ldv = packed.getLeadingDimension();
+        for (size_t j = 0; j < imag.size(); ++j) {
+            Complex* column = result.data.data() + j * n;
+            if (imag[j] == 0.0 || j + 1 == imag.size()) {
+                for (size_t i = 0; i < n; ++i) column[i] = Complex(v[i + j * ldv], 0.0);
+                continue;
+            }
+            Complex* next = column + n;
+            for (size_t i = 0; i < n; ++i) {
+                column[i] = Complex(v[i + j * ldv], v[i + (j + 1) * ldv]);
+                next[i] = std::conj(column[i]);
+            }
+            ++j;
+        }
+        return result;
+    }
+
+    // Accessors
+    Complex get(size_t r, size_t c) const {
+        if (r >= rows || c >= cols) throw std::out_of_range("Matrix index out of range");
+        return data[getIndex(r, c)];
+    }
+
+    void set(size_t r, size_t c, Complex value) {
+        if (r >= rows || c >= cols) throw std::out_of_range("Matrix index out of range");
+        data[getIndex(r, c)] = value;
+    }
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+
+    Complex* getData() { return data.data(); }
+    const Complex* getData() const { return data.data(); }
+    size_t getLeadingDimension() const { return std::max<size_t>(rows, 1); }
+
+    // Element-wise parts
+    AcceleratedMatrix real() const { return mapReal([](Complex z) { return z.real(); }); }
+    AcceleratedMatrix imag() const { return mapReal([](Complex z) { return z.imag(); }); }
+    AcceleratedMatrix abs() const { return mapReal([](Complex z) { return std::abs(z); }); }
+    AcceleratedMatrix arg() const { return mapReal([](Complex z) { return std::arg(z); }); }
+
+    // Basic operations; add / subtract / real scale run the real SIMD
+    // kernels over the interleaved buffer
+    ComplexMatrix add(const ComplexMatrix& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for addition");
+        }
+        ComplexMatrix result(rows, cols);
+        MatrixKernels::add(2 * data.size(), scalars(), other.scalars(), result.scalars());
+        return result;
+    }
+
+    ComplexMatrix subtract(const ComplexMatrix& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for subtraction");
+        }
+        ComplexMatrix result(rows, cols);
+        MatrixKernels::subtract(2 * data.size(), scalars(), other.scalars(), result.scalars());
+        return result;
+    }
+
+    ComplexMatrix scale(Complex factor) const {
+        ComplexMatrix result(rows, cols);
+        if (factor.imag() == 0.0) {
+            MatrixKernels::scale(2 * data.size(), scalars(), factor.real(), result.scalars());
+        } else {
+            MatrixKernels::complex::scale(data.size(), factor, data.data(), result.data.data());
+        }
+        return result;
+    }
+
+    ComplexMatrix multiply(const ComplexMatrix& other) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        ComplexMatrix result(rows, other.cols);
+        if (result.data.empty()) return result;
+        const Complex alpha(1.0), beta(0.0);
+        int m = static_cast<int>(rows), n = static_cast<int>(other.cols), k = static_cast<int>(cols);
+        int lda = static_cast<int>(getLeadingDimension()), ldb = static_cast<int>(other.getLeadingDimension());
+        int ldc = static_cast<int>(result.getLeadingDimension());
+#ifdef __APPLE__
+        cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, n, k, &alpha, getData(), lda,
+                    other.getData(), ldb, &beta, result.getData(), ldc);
+#else
+        char trans = 'N';
+        zgemm_(&trans, &trans, &m, &n, &k, &alpha, getData(), &lda, other.getData(), &ldb,
+               &beta, result.getData(), &ldc);
+#endif
+        return result;
+#else
+        // Four real GEMMs on split parts, so the work runs in the active
+        // backend's SIMD kernels: Re = Ar Br - Ai Bi, Im = Ar Bi + Ai Br
+        const AcceleratedMatrix ar = real(), ai = imag(), br = other.real(), bi = other.imag();
+        AcceleratedMatrix cr(rows, other.cols), ci(rows, other.cols);
+        const MatrixBackend& backend = MatrixBackends::active();
+        backend.gemm(1.0, ar.view(), br.view(), 0.0, cr.view());
+        backend.gemm(-1.0, ai.view(), bi.view(), 1.0, cr.view());
+        backend.gemm(1.0, ar.view(), bi.view(), 0.0, ci.view());
+        backend.gemm(1.0, ai.view(), br.view(), 1.0, ci.view());
+        return ComplexMatrix(cr, ci);
+#endif
+    }
+
+    std::vector<Complex> multiplyVector(const std::vector<Complex>& vec) const {
+        if (vec.size() != cols) throw std::invalid_argument("Vector size incompatible with matrix columns");
+        ComplexMatrix x(cols, 1);
+        std::copy(vec.begin(), vec.end(), x.data.begin());
+        const ComplexMatrix y = multiply(x);
+        return std::vector<Complex>(y.data.begin(), y.data.end());
+    }
+
+    ComplexMatrix transpose() const {
+        ComplexMatrix result(cols, rows);
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = 0; i < rows; ++i) result.data[result.getIndex(j, i)] = data[getIndex(i, j)];
+        }
+        return result;
+    }
+
+    ComplexMatrix conjugate() const {
+        ComplexMatrix result = *this;
+        double* s = result.scalars();
+        for (size_t i = 0; i < data.size(); ++i) s[2 * i + 1] = -s[2 * i + 1];
+        return result;
+    }
+
+    // Conjugate transpose A^H
+    ComplexMatrix adjoint() const {
+        ComplexMatrix result(cols, rows);
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = 0; i < rows; ++i) result.data[result.getIndex(j, i)] = std::conj(data[getIndex(i, j)]);
+        }
+        return result;
+    }
+
+    // Linear systems (zgesv: LU with partial pivoting, then a solve)
+    std::vector<Complex> solve(const std::vector<Complex>& b) const {
+        if (rows != cols) throw std::invalid_argument("Coefficient matrix must be square");
+        if (b.size() != rows) throw std::invalid_argument("Right-hand side vector size mismatch");
+        std::vector<Complex> x = b;
+        solveInPlace(x.data(), 1, std::max<size_t>(rows, 1));
+        return x;
+    }
+
+    ComplexMatrix solve(const ComplexMatrix& b) const {
+        if (rows != cols) throw std::invalid_argument("Coefficient matrix must be square");
+        if (b.rows != rows) throw std::invalid_argument("Right-hand side matrix row count mismatch");
+        ComplexMatrix x = b;
+        solveInPlace(x.getData(), b.cols, x.getLeadingDimension());
+        return x;
+    }
+
+    ComplexMatrix inverse() const {
+        if (rows != cols) throw std::invalid_argument("Only square matrices can be inverted");
+        ComplexMatrix result(rows, cols);
+        result.fillIdentity();
+        solveInPlace(result.getData(), cols, result.getLeadingDimension());
+        return result;
+    }
+
+    Complex determinant() const {
+        if (rows != cols) throw std::invalid_argument("Determinant only defined for square matrices");
+        try {
+            std::vector<int> pivots;
+            const ComplexMatrix lu = luFactor(pivots);
+            Complex det(1.0);
+            for (size_t i = 0; i < rows; ++i) {
+                det *= lu.get(i, i);
+                if (pivots[i] != static_cast<int>(i + 1)) det = -det;  // LAPACK uses 1-based indexing
+            }
+            return det;
+        } catch (const std::runtime_error&) {
+            return Complex(0.0);  // Singular matrix
+        }
+    }
+
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+    // Eigenvalues of a general complex matrix (zgeev)
+    std::vector<Complex> eigenvalues() const { return computeEigen(nullptr); }
+
+    // Eigenvalues and right eigenvectors (column j of the matrix belongs to
+    // eigenvalue j, normalized to unit 2-norm)
+    std::pair<std::vector<Complex>, ComplexMatrix> eigenvectors() const {
+        ComplexMatrix vectors(rows, rows);
+        std::vector<Complex> values = computeEigen(&vectors);
+        return {std::move(values), std::move(vectors)};
+    }
+#endif
+
+    // Frobenius norm
+    double norm() const {
+        return std::sqrt(MatrixKernels::sumOfSquares(2 * data.size(), scalars()));
+    }
+
+    void fillIdentity() {
+        if (rows != cols) throw std::invalid_argument("Identity matrix must be square");
+        std::fill(data.begin(), data.end(), Complex(0.0));
+        for (size_t i = 0; i < rows; ++i) data[getIndex(i, i)] = Complex(1.0);
+    }
+
+    std::string toString() const {
+        std::stringstream ss;
+        ss << "ComplexMatrix " << rows << "x" << cols << ":\n";
+        ss << std::fixed << std::setprecision(6);
+
+        for (size_t i = 0; i < rows; ++i) {
+            ss << "[";
+            for (size_t j = 0; j < cols; ++j) {
+                const Complex z = data[getIndex(i, j)];
+                ss << std::setw(10) << z.real() << (z.imag() < 0 ? " - " : " + ")
+                   << std::setw(8) << std::abs(z.imag()) << "i";
+                if (j < cols - 1) ss << "  ";
+            }
+            ss << "]\n";
+        }
+        return ss.str();
+    }
+};
+
+#endif // COMPLEXMATRIX_HPP
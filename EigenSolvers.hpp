@@ -0,0 +1,777 @@
+// EigenSolvers.hpp - Krylov (restarted Lanczos / Arnoldi) and randomized partial eigen- and singular value solvers
+#ifndef EIGENSOLVERS_HPP
+#define EIGENSOLVERS_HPP
+
+#include "AcceleratedMatrix.hpp"
+#include "LinearOperator.hpp"
+
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+// k extreme eigenvalues of an n x n operator from an m-dimensional Krylov
+// subspace (k < m << n), in the manner of ARPACK: an Arnoldi factorization
+// A V = V H + f e_m^T is extended to m columns, the m - k unwanted Ritz
+// values of H are applied as shifts (implicit QR steps on H), which
+// compresses the factorization back to k columns that already contain the
+// wanted directions, and the cycle repeats until the wanted Ritz pairs
+// have small residuals. Memory is O(n m) and each cycle costs m - k
+// operator applications plus O(n m^2) orthogonalization, so a handful of
+// extreme values of a 20k-dimensional sparse or matrix-free operator take
+// seconds where the dense eigenvalues() / svd would be O(n^3). Repeated
+// eigenvalues are recovered by locking converged vectors and re-running on
+// the deflated operator, which costs at least one more (smaller) run.
+//
+// Symmetric operators run Lanczos (H tridiagonal, real Ritz values from the
+// built-in tridiagonal QL), available in every build. Nonsymmetric
+// operators need LAPACK for the small Hessenberg eigenproblem (dgeev);
+// their Ritz vectors use dgeev's real packing for complex pairs. The basis
+// is fully reorthogonalized (two classical Gram-Schmidt passes), which
+// keeps Lanczos free of spurious copies at O(n m) extra work per step.
+namespace EigenSolvers {
+
+// Which end of the spectrum: algebraically largest / smallest (real part
+// for nonsymmetric operators) or largest in magnitude
+enum class Which { Largest, Smallest, LargestMagnitude };
+
+struct Options {
+    Which which = Which::Largest;
+    size_t subspaceSize = 0;            // Krylov dimension m; 0 picks max(2k + 1, 20), 60 if nonsymmetric
+    double tolerance = 1e-10;           // Ritz residual <= tolerance * |theta|
+    size_t maxRestarts = 300;
+    std::vector<double> initialVector;  // empty: random start with a fixed seed
+};
+
+struct EigenResult {
+    std::vector<double> values;         // real parts, most wanted first
+    std::vector<double> imag;           // imaginary parts (zero for symmetric operators)
+    AcceleratedMatrix vectors{0, 0};    // n x values.size(), complex pairs packed as in dgeev
+    bool converged = false;
+    size_t restarts = 0;
+    size_t operatorApplications = 0;
+};
+
+struct SingularResult {
+    std::vector<double> values;         // singular values, most wanted first
+    AcceleratedMatrix u{0, 0};          // rows x k left singular vectors
+    AcceleratedMatrix v{0, 0};          // cols x k right singular vectors
+    bool converged = false;
+    size_t restarts = 0;
+    size_t operatorApplications = 0;
+};
+
+namespace detail {
+
+// Eigenpairs of a small matrix: values (re, im) and packed vectors
+struct RitzPairs {
+    std::vector<double> re, im;
+    AcceleratedMatrix vectors{0, 0};
+};
+
+inline RitzPairs smallEigen(const AcceleratedMatrix& h, bool symmetric) {
+    const size_t m = h.getRows();
+    RitzPairs ritz;
+    if (symmetric) {
+        // Lanczos H is tridiagonal; the entries outside are rounding noise
+        ritz.re.resize(m);
+        ritz.im.assign(m, 0.0);
+        std::vector<double> offDiagonal(m, 0.0);
+        for (size_t i = 0; i < m; ++i) {
+            ritz.re[i] = h.get(i, i);
+            if (i + 1 < m) offDiagonal[i] = h.get(i + 1, i);
+        }
+        ritz.vectors = AcceleratedMatrix(m, m);
+        ritz.vectors.fillIdentity();
+        if (MatrixKernels::tridiagonalEigen(m, ritz.re.data(), offDiagonal.data(), ritz.vectors.getData(), m,
+                                            ritz.vectors.getLeadingDimension()) != 0) {
+            throw std::runtime_error("Lanczos: tridiagonal eigenvalue iteration failed to converge");
+        }
+        return ritz;
+    }
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+    std::tie(ritz.re, ritz.im, ritz.vectors) = h.eigenvectors();
+    return ritz;
+#else
+    throw std::runtime_error("Eigenvalues of nonsymmetric operators need LAPACK");
+#endif
+}
+
+// Indices of the Ritz values, most wanted first. Conjugate pairs share a
+// key and stay adjacent, positive imaginary part first (dgeev's order).
+inline double wantedKey(double re, double im, Which which) {
+    switch (which) {
+        case Which::Largest: return re;
+        case Which::Smallest: return -re;
+        default: return std::hypot(re, im);
+    }
+}
+
+inline std::vector<size_t> wantedOrder(const RitzPairs& ritz, Which which) {
+    std::vector<size_t> order(ritz.re.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    auto key = [&](size_t i) { return wantedKey(ritz.re[i], ritz.im[i], which); };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const double ka = key(a), kb = key(b);
+        if (ka != kb) return ka > kb;
+        return ritz.im[a] > ritz.im[b];
+    });
+    return order;
+}
+
+// Extend a count that would separate a conjugate pair
+inline size_t keepPairs(const RitzPairs& ritz, const std::vector<size_t>& order, size_t count) {
+    if (count > 0 && count < order.size() && ritz.im[order[count - 1]] > 0.0) ++count;
+    return count;
+}
+
+// Real and imaginary parts of Ritz vector i in the packed storage
+inline void ritzVectorParts(const RitzPairs& ritz, size_t i, const double*& re, const double*& im, double& imSign) {
+    const double* y = ritz.vectors.getData();
+    const size_t ld = ritz.vectors.getLeadingDimension();
+    imSign = 1.0;
+    im = nullptr;
+    if (ritz.im[i] == 0.0) {
+        re = y + i * ld;
+    } else if (ritz.im[i] > 0.0) {
+        re = y + i * ld;
+        im = y + (i + 1) * ld;
+    } else {
+        re = y + (i - 1) * ld;
+        im = y + i * ld;
+        imSign = -1.0;
+    }
+}
+
+// The first `count` wanted pairs as an m x count packed matrix of H's
+// eigenvectors (pairs occupy two columns: real, then imaginary part)
+inline AcceleratedMatrix selectedVectors(const RitzPairs& ritz, const std::vector<size_t>& order, size_t count,
+                                         EigenResult& result) {
+    const size_t m = ritz.vectors.getRows();
+    AcceleratedMatrix y(m, count);
+    result.values.resize(count);
+    result.imag.resize(count);
+    for (size_t c = 0; c < count; ++c) {
+        const size_t i = order[c];
+        result.values[c] = ritz.re[i];
+        result.imag[c] = ritz.im[i];
+        const double *re, *im;
+        double imSign;
+        ritzVectorParts(ritz, i, re, im, imSign);
+        // Column c gets the real part, or for the conjugate (second of a
+        // pair) the imaginary part of the first
+        const double* source = ritz.im[i] < 0.0 ? im : re;
+        for (size_t r = 0; r < m; ++r) y.set(r, c, source[r]);
+    }
+    return y;
+}
+
+// Eigenpairs of a small dense matrix (any symmetric one, not only tridiagonal)
+inline RitzPairs denseRitz(const AcceleratedMatrix& dense, bool symmetric) {
+    if (!symmetric) return smallEigen(dense, false);
+    RitzPairs ritz;
+    auto eigen = dense.eigenSymmetric(true);
+    ritz.re = eigen.first;
+    ritz.im.assign(ritz.re.size(), 0.0);
+    ritz.vectors = eigen.second;
+    return ritz;
+}
+
+// Solves small problems (m >= n) densely
+inline EigenResult denseEigs(const LinearOperator& a, size_t k, bool symmetric, Which which) {
+    const RitzPairs ritz = denseRitz(a.toDense(), symmetric);
+    const std::vector<size_t> order = wantedOrder(ritz, which);
+    EigenResult result;
+    result.vectors = selectedVectors(ritz, order, keepPairs(ritz, order, k), result);
+    result.converged = true;
+    result.operatorApplications = a.getCols();
+    return result;
+}
+
+// Reflector P = I - tau v v^T (len 2 or 3, v[0] = 1) with P u = beta e_1
+inline double smallReflector(size_t len, const double* u, double* v) {
+    double tailNorm = 0.0;
+    for (size_t t = 1; t < len; ++t) tailNorm = std::hypot(tailNorm, u[t]);
+    v[0] = 1.0;
+    if (tailNorm == 0.0) return 0.0;
+    const double alpha = u[0];
+    const double beta = -std::copysign(std::hypot(alpha, tailNorm), alpha);
+    for (size_t t = 1; t < len; ++t) v[t] = u[t] / (alpha - beta);
+    return (beta - alpha) / beta;
+}
+
+// H = P H P on indices [k, k + len): rows from column c0 on, columns in
+// rows [0, r1]; Q = Q P accumulates the transformation
+inline void applySmallReflector(AcceleratedMatrix& h, AcceleratedMatrix& q, size_t k, size_t len,
+                                const double* v, double tau, size_t c0, size_t r1) {
+    if (tau == 0.0) return;
+    const size_t m = h.getRows();
+    auto fromLeft = [&](AcceleratedMatrix& x, size_t j) {
+        double w = 0.0;
+        for (size_t t = 0; t < len; ++t) w += v[t] * x.get(k + t, j);
+        w *= tau;
+        for (size_t t = 0; t < len; ++t) x.set(k + t, j, x.get(k + t, j) - w * v[t]);
+    };
+    auto fromRight = [&](AcceleratedMatrix& x, size_t i) {
+        double w = 0.0;
+        for (size_t t = 0; t < len; ++t) w += x.get(i, k + t) * v[t];
+        w *= tau;
+        for (size_t t = 0; t < len; ++t) x.set(i, k + t, x.get(i, k + t) - w * v[t]);
+    };
+    for (size_t j = c0; j < m; ++j) fromLeft(h, j);
+    for (size_t i = 0; i <= r1; ++i) fromRight(h, i);
+    for (size_t i = 0; i < m; ++i) fromRight(q, i);
+}
+
+// One implicit QR step on the unreduced Hessenberg block [lo, hi] of h,
+// chasing the bulge down the subdiagonal (Francis; dnapps in ARPACK).
+// A real shift mu uses 2 x 2 reflectors from the first column of H - mu I;
+// a complex pair uses 3 x 3 ones from that of H^2 - sum H + product I, so
+// the step stays in real arithmetic and H never leaves Hessenberg form.
+inline void shiftedQrStep(AcceleratedMatrix& h, AcceleratedMatrix& q, size_t lo, size_t hi,
+                          bool doubleShift, double mu, double sum, double product) {
+    double u[3], v[3];
+    const size_t width = doubleShift ? 3 : 2;
+    for (size_t k = lo; k < hi; ++k) {
+        const size_t len = std::min(width, hi - k + 1);
+        if (k == lo) {
+            const double h00 = h.get(lo, lo), h10 = h.get(lo + 1, lo);
+            if (doubleShift) {
+                u[0] = h00 * h00 + h.get(lo, lo + 1) * h10 - sum * h00 + product;
+                u[1] = h10 * (h00 + h.get(lo + 1, lo + 1) - sum);
+                u[2] = lo + 2 <= hi ? h10 * h.get(lo + 2, lo + 1) : 0.0;
+            } else {
+                u[0] = h00 - mu;
+                u[1] = h10;
+            }
+        } else {
+            for (size_t t = 0; t < len; ++t) u[t] = h.get(k + t, k - 1);
+        }
+        const double tau = smallReflector(len, u, v);
+        applySmallReflector(h, q, k, len, v, tau, k > lo ? k - 1 : lo, std::min(k + len, hi));
+        // The bulge below the subdiagonal is annihilated exactly
+        if (k > lo) {
+            for (size_t t = 1; t < len; ++t) h.set(k + t, k - 1, 0.0);
+        }
+    }
+}
+
+// Applies a shift to every unreduced diagonal block of h, splitting at
+// negligible subdiagonal entries
+inline void applyShift(AcceleratedMatrix& h, AcceleratedMatrix& q, bool doubleShift, double mu,
+                       double sum, double product) {
+    const size_t m = h.getRows();
+    const double eps = std::numeric_limits<double>::epsilon();
+    size_t lo = 0;
+    for (size_t i = 0; i < m; ++i) {
+        const bool split = i + 1 == m ||
+            std::abs(h.get(i + 1, i)) <= eps * (std::abs(h.get(i, i)) + std::abs(h.get(i + 1, i + 1)));
+        if (!split) continue;
+        if (i + 1 < m) h.set(i + 1, i, 0.0);
+        if (i > lo) shiftedQrStep(h, q, lo, i, doubleShift, mu, sum, product);
+        lo = i + 1;
+    }
+}
+
+// Whether every packed Ritz pair has ||A x - lambda x|| / ||x|| within
+// tolerance * max(|lambda|, eps^(2/3)) + floor, measured with the operator
+inline bool residualsWithin(const LinearOperator& a, const EigenResult& result, double tolerance, double floor) {
+    const size_t n = a.getRows(), count = result.values.size();
+    const double eps23 = std::pow(std::numeric_limits<double>::epsilon(), 2.0 / 3.0);
+    const AcceleratedMatrix& x = result.vectors;
+    const AcceleratedMatrix ax = a.multiply(x);
+    for (size_t c = 0; c < count; ++c) {
+        const double re = result.values[c], im = result.imag[c];
+        if (im < 0.0) continue;  // checked with its partner
+        double error = 0.0, norm = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double xr = x.get(i, c), xi = im > 0.0 ? x.get(i, c + 1) : 0.0;
+            const double er = ax.get(i, c) - (re * xr - im * xi);
+            const double ei = im > 0.0 ? ax.get(i, c + 1) - (im * xr + re * xi) : 0.0;
+            error += er * er + ei * ei;
+            norm += xr * xr + xi * xi;
+        }
+        const double bound = tolerance * std::max(std::hypot(re, im), eps23) + floor;
+        if (!(std::sqrt(error) <= bound * std::sqrt(norm))) return false;
+    }
+    return true;
+}
+
+inline double columnNorm(const AcceleratedMatrix& v, size_t j) {
+    return std::sqrt(MatrixKernels::sumOfSquares(v.getRows(), v.getData() + j * v.getLeadingDimension()));
+}
+
+// Two classical Gram-Schmidt passes of w against columns [0, count) of v;
+// the projection coefficients are added to h (length count)
+inline void orthogonalize(const AcceleratedMatrix& v, size_t count, double* w, double* h) {
+    if (count == 0) return;
+    const size_t n = v.getRows();
+    const MatrixBackend& backend = MatrixBackends::active();
+    const ConstMatrixView basis = v.view(0, 0, n, count);
+    std::vector<double> c(count), correction(n);
+    for (int pass = 0; pass < 2; ++pass) {
+        backend.gemv(basis.transposed(), w, c.data());
+        backend.gemv(basis, c.data(), correction.data());
+        MatrixKernels::subtract(n, w, correction.data(), w);
+        for (size_t i = 0; i < count; ++i) h[i] += c[i];
+    }
+}
+
+// One implicitly restarted Arnoldi (Lanczos when symmetric) run with an
+// m-dimensional basis. Start and breakdown vectors are kept orthogonal to
+// the columns of `locked`; the caller deflates the operator to match.
+inline EigenResult arnoldiRun(const LinearOperator& a, size_t k, size_t m, const Options& options, bool symmetric,
+                              const AcceleratedMatrix& locked, unsigned seed) {
+    const size_t n = a.getRows();
+    std::vector<double> lockedScratch(locked.getCols());
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal;
+    AcceleratedMatrix v(n, m);
+    AcceleratedMatrix h(m, m);
+    std::vector<double> f(n), hColumn(m);
+
+    // A unit vector orthogonal to columns [0, count), for the start and breakdowns
+    auto randomColumn = [&](size_t column, bool useInitial) {
+        double* target = v.getData() + column * v.getLeadingDimension();
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            for (size_t i = 0; i < n; ++i) target[i] = useInitial ? options.initialVector[i] : normal(rng);
+            useInitial = false;
+            orthogonalize(locked, locked.getCols(), target, lockedScratch.data());
+            std::fill(hColumn.begin(), hColumn.end(), 0.0);
+            orthogonalize(v, column, target, hColumn.data());
+            const double norm = columnNorm(v, column);
+            if (norm > 0.0) {
+                MatrixKernels::scale(n, target, 1.0 / norm, target);
+                return;
+            }
+        }
+        throw std::runtime_error("Arnoldi: could not extend the Krylov basis");
+    };
+
+    randomColumn(0, !options.initialVector.empty());
+
+    EigenResult result;
+    const double eps = std::numeric_limits<double>::epsilon();
+    const double eps23 = std::pow(eps, 2.0 / 3.0);
+    size_t kept = 0;  // columns of the current factorization
+
+    for (;;) {
+        // Extend the factorization A V = V H + f e^T from kept to m columns
+        for (size_t j = kept; j < m; ++j) {
+            if (j > 0) {
+                const double beta = std::sqrt(MatrixKernels::sumOfSquares(n, f.data()));
+                double* vj = v.getData() + j * v.getLeadingDimension();
+                if (beta > eps * std::max(1.0, std::abs(h.get(j - 1, j - 1)))) {
+                    MatrixKernels::scale(n, f.data(), 1.0 / beta, vj);
+                    h.set(j, j - 1, beta);
+                } else {
+                    // Invariant subspace found: continue with a fresh direction
+                    randomColumn(j, false);
+                    h.set(j, j - 1, 0.0);
+                }
+            }
+            a.apply(v.getData() + j * v.getLeadingDimension(), f.data());
+            ++result.operatorApplications;
+            std::fill(hColumn.begin(), hColumn.end(), 0.0);
+            orthogonalize(v, j + 1, f.data(), hColumn.data());
+            for (size_t i = 0; i <= j; ++i) h.set(i, j, hColumn[i]);
+        }
+        if (symmetric) {
+            for (size_t j = 0; j < m; ++j) {
+                for (size_t i = 0; i < m; ++i) {
+                    if (i > j + 1 || j > i + 1) h.set(i, j, 0.0);
+                }
+            }
+        }
+
+        const RitzPairs ritz = smallEigen(h, symmetric);
+        const std::vector<size_t> order = wantedOrder(ritz, options.which);
+        const size_t wanted = keepPairs(ritz, order, k);
+
+        // Ritz residual of pair i: ||f|| |e_m^T y_i|
+        const double fNorm = std::sqrt(MatrixKernels::sumOfSquares(n, f.data()));
+        size_t convergedCount = 0;
+        for (size_t c = 0; c < wanted; ++c) {
+            const size_t i = order[c];
+            const double *re, *im;
+            double imSign;
+            ritzVectorParts(ritz, i, re, im, imSign);
+            const double last = std::hypot(re[m - 1], im ? im[m - 1] : 0.0);
+            const double size = std::max(eps23, std::hypot(ritz.re[i], ritz.im[i]));
+            if (fNorm * last <= options.tolerance * size) ++convergedCount;
+        }
+
+        if (convergedCount == wanted || result.restarts >= options.maxRestarts) {
+            const AcceleratedMatrix y = selectedVectors(ritz, order, wanted, result);
+            result.vectors = AcceleratedMatrix(n, wanted);
+            MatrixBackends::active().gemm(1.0, v.view(), y.view(), 0.0, result.vectors.view());
+
+            // The Ritz estimate assumes an exact factorization; confirm it
+            // against the operator so rounding in H cannot report success.
+            // The floor allows for rounding at the scale of ||A||.
+            bool accurate = false;
+            if (convergedCount == wanted) {
+                double spectralScale = 0.0;
+                for (size_t i = 0; i < m; ++i) {
+                    spectralScale = std::max(spectralScale, std::hypot(ritz.re[i], ritz.im[i]));
+                }
+                accurate = residualsWithin(a, result, options.tolerance, 1e3 * eps * spectralScale);
+                result.operatorApplications += wanted;
+            }
+            if (accurate || result.restarts >= options.maxRestarts) {
+                result.converged = accurate;
+                return result;
+            }
+        }
+        ++result.restarts;
+
+        // Keep a few more than wanted as pairs converge, so the search does
+        // not stagnate (ARPACK's adjustment), never separating a pair
+        kept = keepPairs(ritz, order, std::min(wanted + convergedCount, wanted + (m - wanted) / 2));
+        if (kept >= m) kept = wanted;
+
+        // Exact shifts: the unwanted Ritz values, each as an implicit QR
+        // step (complex pairs as one real double-shift step)
+        AcceleratedMatrix q(m, m);
+        q.fillIdentity();
+        for (size_t c = kept; c < m; ++c) {
+            const size_t i = order[c];
+            if (ritz.im[i] == 0.0) {
+                applyShift(h, q, false, ritz.re[i], 0.0, 0.0);
+            } else {
+                applyShift(h, q, true, 0.0, 2.0 * ritz.re[i], ritz.re[i] * ritz.re[i] + ritz.im[i] * ritz.im[i]);
+                ++c;  // the conjugate is consumed by the same step
+            }
+        }
+        if (symmetric) {
+            // Lanczos H stays tridiagonal up to rounding
+            for (size_t j = 0; j < m; ++j) {
+                for (size_t i = j + 2; i < m; ++i) h.set(j, i, 0.0);
+            }
+        }
+
+        // Compressed factorization: V_k = V Q(:, 0..k), f = v_k beta + f sigma
+        const double beta = h.get(kept, kept - 1), sigma = q.get(m - 1, kept - 1);
+        AcceleratedMatrix rotated(n, kept + 1);
+        MatrixBackends::active().gemm(1.0, v.view(), q.view(0, 0, m, kept + 1), 0.0, rotated.view());
+        const double* next = rotated.getData() + kept * rotated.getLeadingDimension();
+        for (size_t i = 0; i < n; ++i) f[i] = next[i] * beta + f[i] * sigma;
+        MatrixKernels::copy(rotated.view(0, 0, n, kept), v.view(0, 0, n, kept));
+
+        AcceleratedMatrix compressed(m, m);
+        MatrixKernels::copy(h.view(0, 0, kept, kept), compressed.view(0, 0, kept, kept));
+        h = compressed;
+    }
+}
+
+// Columns of `basis` followed by those of `extra` made orthonormal to them
+// (two Gram-Schmidt passes); numerically dependent columns are dropped
+inline AcceleratedMatrix extendBasis(const AcceleratedMatrix& basis, const AcceleratedMatrix& extra) {
+    const size_t n = basis.getRows(), p = basis.getCols();
+    AcceleratedMatrix grown(n, p + extra.getCols());
+    MatrixKernels::copy(basis.view(), grown.view(0, 0, n, p));
+    std::vector<double> scratch(grown.getCols());
+    size_t count = p;
+    for (size_t j = 0; j < extra.getCols(); ++j) {
+        double* column = grown.getData() + count * grown.getLeadingDimension();
+        MatrixKernels::copy(extra.view(0, j, n, 1), grown.view(0, count, n, 1));
+        const double before = columnNorm(grown, count);
+        orthogonalize(grown, count, column, scratch.data());
+        const double after = columnNorm(grown, count);
+        if (after > 1e-8 * before) {
+            MatrixKernels::scale(n, column, 1.0 / after, column);
+            ++count;
+        }
+    }
+    if (count == grown.getCols()) return grown;
+    return AcceleratedMatrix(grown.view(0, 0, n, count));
+}
+
+// Rayleigh-Ritz on the columns of an orthonormal basis of an (approximately)
+// invariant subspace: the k most wanted eigenpairs of W^T A W, lifted by W
+inline EigenResult projectedEigs(const LinearOperator& a, const AcceleratedMatrix& w, size_t k, bool symmetric,
+                                 Which which) {
+    const AcceleratedMatrix aw = a.multiply(w);
+    AcceleratedMatrix h(w.getCols(), w.getCols());
+    MatrixBackends::active().gemm(1.0, w.view().transposed(), aw.view(), 0.0, h.view());
+    if (symmetric) {
+        // Symmetrize away the rounding so the symmetric solver sees one triangle
+        for (size_t j = 0; j < h.getCols(); ++j) {
+            for (size_t i = j + 1; i < h.getRows(); ++i) {
+                const double mean = 0.5 * (h.get(i, j) + h.get(j, i));
+                h.set(i, j, mean);
+                h.set(j, i, mean);
+            }
+        }
+    }
+    const RitzPairs ritz = denseRitz(h, symmetric);
+    const std::vector<size_t> order = wantedOrder(ritz, which);
+    EigenResult result;
+    const AcceleratedMatrix y = selectedVectors(ritz, order, keepPairs(ritz, order, std::min(k, order.size())), result);
+    result.vectors = AcceleratedMatrix(w.getRows(), y.getCols());
+    MatrixBackends::active().gemm(1.0, w.view(), y.view(), 0.0, result.vectors.view());
+    result.operatorApplications = w.getCols();
+    return result;
+}
+
+// Implicitly restarted Arnoldi (Lanczos when symmetric) with locking.
+// From a single start vector, Krylov subspaces hold one direction per
+// eigenvalue, so a run finds one copy of a repeated eigenvalue and can
+// pass over the others. After the first run converges, its vectors are
+// locked (their span is invariant) and the run is repeated on the
+// deflated operator (I - W W^T) A from a fresh start orthogonal to them,
+// whose spectrum is what A has left. While that finds a value that ranks
+// among the k wanted, it is locked too; the answer is the Rayleigh-Ritz
+// projection of A on the locked space, checked against A.
+inline EigenResult restartedArnoldi(const LinearOperator& a, size_t k, const Options& options, bool symmetric) {
+    if (!a.isSquare()) throw std::invalid_argument("Eigenvalues require a square operator");
+    const size_t n = a.getRows();
+    if (k == 0 || k > n) throw std::invalid_argument("Number of eigenvalues must be between 1 and n");
+
+    // Nonsymmetric spectra crowd at the edge (a random matrix fills a disk),
+    // and a small basis then settles on accurate but not extreme pairs
+    const size_t defaultSize = std::max<size_t>(2 * k + 1, symmetric ? 20 : 60);
+    const size_t m = options.subspaceSize ? options.subspaceSize : defaultSize;
+    if (m >= n) return denseEigs(a, k, symmetric, options.which);
+    if (m < k + 2) throw std::invalid_argument("Krylov subspace size must exceed k + 1");
+    if (!options.initialVector.empty() && options.initialVector.size() != n) {
+        throw std::invalid_argument("Initial vector size does not match operator");
+    }
+
+    unsigned seed = 20240517u;
+    EigenResult first = arnoldiRun(a, k, m, options, symmetric, AcceleratedMatrix(n, 0), seed);
+    if (!first.converged) return first;
+
+    AcceleratedMatrix locked = extendBasis(AcceleratedMatrix(n, 0), first.vectors);
+    size_t restarts = first.restarts, applications = first.operatorApplications;
+    Options deflatedOptions = options;
+    deflatedOptions.initialVector.clear();
+    const double eps = std::numeric_limits<double>::epsilon();
+
+    for (;;) {
+        EigenResult result = projectedEigs(a, locked, k, symmetric, options.which);
+        applications += result.operatorApplications;
+        const size_t last = std::min(k, result.values.size()) - 1;
+        const double threshold = wantedKey(result.values[last], result.imag[last], options.which);
+        double spectralScale = 0.0;
+        for (size_t i = 0; i < result.values.size(); ++i) {
+            spectralScale = std::max(spectralScale, std::hypot(result.values[i], result.imag[i]));
+        }
+        auto finish = [&](bool converged) {
+            result.converged = converged && residualsWithin(a, result, options.tolerance, 1e3 * eps * spectralScale);
+            result.restarts = restarts;
+            result.operatorApplications = applications + result.values.size();
+            return result;
+        };
+
+        // Too little left to deflate into: the whole problem is small
+        if (locked.getCols() + m >= n) {
+            EigenResult dense = denseEigs(a, k, symmetric, options.which);
+            dense.restarts = restarts;
+            dense.operatorApplications += applications;
+            return dense;
+        }
+
+        const AcceleratedMatrix& w = locked;
+        const LinearOperator deflated(n, n, [&a, &w](size_t count, const double* x, double* y) {
+            a.applyMany(count, x, y);
+            const MatrixBackend& backend = MatrixBackends::active();
+            const MatrixView block = MatrixView::columnMajor(y, w.getRows(), count, w.getRows());
+            AcceleratedMatrix coefficients(w.getCols(), count);
+            for (int pass = 0; pass < 2; ++pass) {
+                backend.gemm(1.0, w.view().transposed(), block, 0.0, coefficients.view());
+                backend.gemm(-1.0, w.view(), coefficients.view(), 1.0, block);
+            }
+        });
+        const EigenResult next = arnoldiRun(deflated, 1, m, deflatedOptions, symmetric, locked, ++seed);
+        restarts += next.restarts;
+        applications += next.operatorApplications;
+        if (!next.converged) return finish(false);
+
+        // Nothing new among the wanted: the locked space holds all k
+        const double margin = options.tolerance * std::max(std::abs(threshold), std::pow(eps, 2.0 / 3.0));
+        if (wantedKey(next.values[0], next.imag[0], options.which) <= threshold + margin) return finish(true);
+        const size_t before = locked.getCols();
+        locked = extendBasis(locked, next.vectors);
+        if (locked.getCols() == before) return finish(true);
+    }
+}
+
+} // namespace detail
+
+// k eigenvalues of a symmetric operator (real, with orthonormal vectors)
+inline EigenResult symmetricEigs(const LinearOperator& a, size_t k, const Options& options = Options()) {
+    return detail::restartedArnoldi(a, k, options, true);
+}
+
+// k eigenvalues of a general operator (LAPACK builds). May return k + 1
+// values when the k-th is one of a complex conjugate pair.
+inline EigenResult eigs(const LinearOperator& a, size_t k, const Options& options = Options()) {
+    return detail::restartedArnoldi(a, k, options, false);
+}
+
+// k singular values through Lanczos on the smaller of A^T A and A A^T
+// (needs the transpose kernel). Squaring the operator halves the relative
+// accuracy of tiny singular values; the largest ones are unaffected.
+// Which::Smallest asks for the smallest, anything else for the largest.
+inline SingularResult svds(const LinearOperator& a, size_t k, const Options& options = Options()) {
+    if (!a.hasTranspose()) throw std::invalid_argument("Singular values require an operator with a transpose kernel");
+    const size_t rows = a.getRows(), cols = a.getCols();
+    if (k == 0 || k > std::min(rows, cols)) {
+        throw std::invalid_argument("Number of singular values must be between 1 and min(rows, cols)");
+    }
+
+    // Normal operator on the short side; products go through A and A^T in batches
+    const bool tall = rows >= cols;
+    const size_t small = tall ? cols : rows, large = tall ? rows : cols;
+    LinearOperator normal(small, small, [&a, tall, large](size_t count, const double* x, double* y) {
+        std::vector<double> middle(large * count);
+        if (tall) {
+            a.applyMany(count, x, middle.data());
+            a.applyTransposeMany(count, middle.data(), y);
+        } else {
+            a.applyTransposeMany(count, x, middle.data());
+            a.applyMany(count, middle.data(), y);
+        }
+    });
+
+    Options normalOptions = options;
+    normalOptions.which = options.which == Which::Smallest ? Which::Smallest : Which::Largest;
+    EigenResult eigen = symmetricEigs(normal, k, normalOptions);
+
+    SingularResult result;
+    result.converged = eigen.converged;
+    result.restarts = eigen.restarts;
+    result.operatorApplications = 2 * eigen.operatorApplications;
+    result.values.resize(k);
+    for (size_t i = 0; i < k; ++i) result.values[i] = std::sqrt(std::max(0.0, eigen.values[i]));
+
+    // The other side: u_i = A v_i / s_i (or v_i = A^T u_i / s_i)
+    AcceleratedMatrix known(small, k);
+    MatrixKernels::copy(eigen.vectors.view(0, 0, small, k), known.view());
+    AcceleratedMatrix other = tall ? a.multiply(known) : a.multiplyTranspose(known);
+    result.operatorApplications += k;
+    for (size_t j = 0; j < k; ++j) {
+        const double s = result.values[j];
+        double* column = other.getData() + j * other.getLeadingDimension();
+        if (s > 0.0) MatrixKernels::scale(large, column, 1.0 / s, column);
+        else std::fill(column, column + large, 0.0);
+    }
+    result.u = tall ? other : known;
+    result.v = tall ? known : other;
+    return result;
+}
+
+// --- Randomized truncated SVD -------------------------------------------------
+// Halko, Martinsson and Tropp: the range of A is captured by Q = orth(A G)
+// for a Gaussian n x (k + p) matrix G, sharpened by q power iterations
+// (A A^T)^q A G when the spectrum decays slowly; the SVD of the small
+// B = Q^T A then gives A ~= (Q U_B) S V_B^T. The cost is 2q + 2 block
+// products with A plus O((m + n) l^2) dense work for l = k + p, against
+// O(m n min(m, n)) for the full svd.
+
+struct RandomizedOptions {
+    size_t oversample = 10;       // p: extra sample columns beyond k
+    size_t powerIterations = 2;   // q: passes of A A^T
+    unsigned seed = 20240517u;
+};
+
+struct TruncatedSvd {
+    std::vector<double> values;   // S_k, descending
+    AcceleratedMatrix u{0, 0};    // rows x k
+    AcceleratedMatrix vt{0, 0};   // k x cols
+
+    // U_k diag(S_k) V_k^T, the rank-k approximation
+    AcceleratedMatrix approximation() const {
+        AcceleratedMatrix scaled = u;
+        for (size_t j = 0; j < values.size(); ++j) {
+            double* column = scaled.getData() + j * scaled.getLeadingDimension();
+            MatrixKernels::scale(scaled.getRows(), column, values[j], column);
+        }
+        return scaled.multiply(vt);
+    }
+};
+
+namespace detail {
+
+// Orthonormal basis of the columns of y (thin Householder Q), in place
+inline void orthonormalizeColumns(AcceleratedMatrix& y) {
+    const size_t m = y.getRows(), l = y.getCols();
+    AcceleratedMatrix factored = y;
+    std::vector<double> tau(l);
+    MatrixKernels::qrFactor(m, l, factored.getData(), factored.getLeadingDimension(), tau.data());
+    y = AcceleratedMatrix(m, l);
+    for (size_t j = 0; j < l; ++j) y.set(j, j, 1.0);
+    MatrixKernels::qrApplyQ(m, l, factored.getData(), factored.getLeadingDimension(), tau.data(),
+                            l, y.getData(), y.getLeadingDimension());
+}
+
+} // namespace detail
+
+// Rank-k SVD of a rows x cols operator (needs the transpose kernel); k + p
+// is clipped to min(rows, cols). Sparse and matrix-free operators are only
+// touched through block products.
+inline TruncatedSvd randomizedSvd(const LinearOperator& a, size_t k,
+                                  const RandomizedOptions& options = RandomizedOptions()) {
+    if (!a.hasTranspose()) throw std::invalid_argument("Randomized SVD requires an operator with a transpose kernel");
+    const size_t rows = a.getRows(), cols = a.getCols();
+    if (k == 0 || k > std::min(rows, cols)) {
+        throw std::invalid_argument("Rank must be between 1 and min(rows, cols)");
+    }
+    const size_t l = std::min(k + options.oversample, std::min(rows, cols));
+
+    std::mt19937 rng(options.seed);
+    std::normal_distribution<double> normal;
+    AcceleratedMatrix sample(cols, l);
+    for (size_t j = 0; j < l; ++j) {
+        for (size_t i = 0; i < cols; ++i) sample.set(i, j, normal(rng));
+    }
+
+    // Range finder; re-orthonormalizing between products keeps the small
+    // singular directions from being lost to rounding
+    AcceleratedMatrix q = a.multiply(sample);
+    detail::orthonormalizeColumns(q);
+    for (size_t iteration = 0; iteration < options.powerIterations; ++iteration) {
+        AcceleratedMatrix z = a.multiplyTranspose(q);
+        detail::orthonormalizeColumns(z);
+        q = a.multiply(z);
+        detail::orthonormalizeColumns(q);
+    }
+
+    // B^T = A^T Q = Q2 R, so B = R^T Q2^T and SVD(R^T) = Ur S Vr^T gives
+    // A ~= (Q Ur) S (Q2 Vr)^T
+    AcceleratedMatrix c = a.multiplyTranspose(q);
+    std::vector<double> tau(l);
+    MatrixKernels::qrFactor(cols, l, c.getData(), c.getLeadingDimension(), tau.data());
+    AcceleratedMatrix small(l, l);
+    for (size_t j = 0; j < l; ++j) {
+        for (size_t i = j; i < l; ++i) small.set(i, j, c.get(j, i));  // R^T, lower triangular
+    }
+    std::vector<double> sigma(l);
+    AcceleratedMatrix vr(l, l);
+    if (MatrixKernels::jacobiSvd(l, l, small.getData(), small.getLeadingDimension(), sigma.data(), vr.getData(),
+                                 vr.getLeadingDimension()) != 0) {
+        throw std::runtime_error("Randomized SVD: Jacobi SVD of the sketch failed to converge");
+    }
+
+    TruncatedSvd result;
+    result.values.assign(sigma.begin(), sigma.begin() + k);
+    result.u = AcceleratedMatrix(rows, k);
+    MatrixBackends::active().gemm(1.0, q.view(), small.view(0, 0, l, k), 0.0, result.u.view());
+
+    // V = Q2 [Vr(:, 0..k); 0]
+    AcceleratedMatrix v(cols, k);
+    MatrixKernels::copy(vr.view(0, 0, l, k), v.view(0, 0, l, k));
+    MatrixKernels::qrApplyQ(cols, l, c.getData(), c.getLeadingDimension(), tau.data(),
+                            k, v.getData(), v.getLeadingDimension());
+    result.vt = v.transpose();
+    return result;
+}
+
+} // namespace EigenSolvers
+
+#endif // EIGENSOLVERS_HPP
@@ -0,0 +1,580 @@
+// IterativeSolvers.hpp - Krylov solvers (CG, BiCGSTAB, GMRES) and preconditioners
+#ifndef ITERATIVESOLVERS_HPP
+#define ITERATIVESOLVERS_HPP
+
+#include "AcceleratedMatrix.hpp"
+#include "SparseMatrix.hpp"
+#include "LinearOperator.hpp"
+
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+
+#include "MatrixThreadPool.hpp"
+
+// The solvers only touch the system matrix through y = A x, so the same
+// code runs on dense matrices (backend gemv, O(n^2) per product), sparse
+// matrices (SpMV, O(nnz)) and any callable that applies A without storing
+// it. A tolerance-controlled solve then costs O(nnz * iterations) instead
+// of the O(n^3) of a dense factorization.
+//
+// LinearOperator (LinearOperator.hpp) packages such a callable with its
+// dimensions and an optional transpose for the rectangular least-squares
+// solver.
+//
+// Preconditioners apply z = M^-1 r for some M ~ A that is cheap to invert;
+// an empty Preconditioner means M = I. Jacobi works for any operator with
+// a known diagonal, ILU(0) and IC(0) factor the sparsity pattern of A.
+
+// y = A x, with x and y of the operator's size
+using OperatorApply = std::function<void(const double* x, double* y)>;
+
+// z = M^-1 r
+using Preconditioner = std::function<void(const double* r, double* z)>;
+
+// M = diag(A)
+class JacobiPreconditioner {
+private:
+    std::vector<double> inverseDiagonal;
+
+    void invert(std::vector<double> diagonal) {
+        for (size_t i = 0; i < diagonal.size(); ++i) {
+            if (diagonal[i] == 0.0) {
+                throw std::runtime_error("Jacobi preconditioner: zero diagonal entry at row " + std::to_string(i));
+            }
+            diagonal[i] = 1.0 / diagonal[i];
+        }
+        inverseDiagonal = std::move(diagonal);
+    }
+
+public:
+    explicit JacobiPreconditioner(const std::vector<double>& diagonal) {
+        invert(diagonal);
+    }
+
+    explicit JacobiPreconditioner(const AcceleratedMatrix& a) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Jacobi preconditioner requires a square matrix");
+        }
+        std::vector<double> diagonal(a.getRows());
+        for (size_t i = 0; i < diagonal.size(); ++i) diagonal[i] = a.get(i, i);
+        invert(std::move(diagonal));
+    }
+
+    explicit JacobiPreconditioner(const SparseMatrix& a) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Jacobi preconditioner requires a square matrix");
+        }
+        std::vector<double> diagonal(a.getRows());
+        for (size_t i = 0; i < diagonal.size(); ++i) diagonal[i] = a.get(i, i);
+        invert(std::move(diagonal));
+    }
+
+    size_t size() const { return inverseDiagonal.size(); }
+
+    void operator()(const double* r, double* z) const {
+        for (size_t i = 0; i < inverseDiagonal.size(); ++i) z[i] = r[i] * inverseDiagonal[i];
+    }
+};
+
+// Incomplete LU with zero fill: L U ~ A, where L (unit lower) and U keep
+// exactly the nonzero pattern of A. Stored together in one CSR copy of A.
+class ILU0Preconditioner {
+private:
+    size_t n;
+    std::vector<size_t> offsets;
+    std::vector<SparseMatrix::Index> columns;
+    std::vector<double> values;
+    std::vector<size_t> diagonal;  // position of a_ii within its row
+
+    void factor() {
+        // position[j] = slot of column j in the current row, or npos
+        const size_t npos = static_cast<size_t>(-1);
+        std::vector<size_t> position(n, npos);
+        diagonal.assign(n, npos);
+
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) position[columns[k]] = k;
+            if (position[i] == npos) {
+                throw std::runtime_error("ILU(0): missing diagonal entry at row " + std::to_string(i));
+            }
+            diagonal[i] = position[i];
+
+            // Eliminate the strictly lower entries in column order; the
+            // fill they would create outside the pattern is dropped
+            for (size_t k = offsets[i]; k < offsets[i + 1] && columns[k] < i; ++k) {
+                const size_t pivotRow = columns[k];
+                const double multiplier = values[k] / values[diagonal[pivotRow]];
+                values[k] = multiplier;
+                for (size_t p = diagonal[pivotRow] + 1; p < offsets[pivotRow + 1]; ++p) {
+                    const size_t slot = position[columns[p]];
+                    if (slot != npos) values[slot] -= multiplier * values[p];
+                }
+            }
+
+            if (values[diagonal[i]] == 0.0) {
+                throw std::runtime_error("ILU(0): zero pivot at row " + std::to_string(i));
+            }
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) position[columns[k]] = npos;
+        }
+    }
+
+public:
+    explicit ILU0Preconditioner(const SparseMatrix& a) : n(a.getRows()) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("ILU(0) requires a square matrix");
+        }
+        SparseMatrix csr = a.toCSR();
+        offsets = csr.getOffsets();
+        columns = csr.getIndices();
+        values = csr.getValues();
+        factor();
+    }
+
+    // The dense matrix's nonzeros define the pattern
+    explicit ILU0Preconditioner(const AcceleratedMatrix& a) : ILU0Preconditioner(SparseMatrix::fromDense(a)) {}
+
+    size_t size() const { return n; }
+
+    // Forward solve with unit L, then backward solve with U
+    void operator()(const double* r, double* z) const {
+        for (size_t i = 0; i < n; ++i) {
+            double sum = r[i];
+            for (size_t k = offsets[i]; k < diagonal[i]; ++k) sum -= values[k] * z[columns[k]];
+            z[i] = sum;
+        }
+        for (size_t i = n; i-- > 0;) {
+            double sum = z[i];
+            for (size_t k = diagonal[i] + 1; k < offsets[i + 1]; ++k) sum -= values[k] * z[columns[k]];
+            z[i] = sum / values[diagonal[i]];
+        }
+    }
+};
+
+// Incomplete Cholesky with zero fill for symmetric positive definite A:
+// L L^T ~ A with L on the lower-triangular pattern of A. Only the lower
+// triangle is read. Fails on a non-positive pivot, which can happen for
+// SPD matrices that are not diagonally dominant.
+class IncompleteCholeskyPreconditioner {
+private:
+    size_t n;
+    std::vector<size_t> offsets;               // CSR rows of L, diagonal last in each row
+    std::vector<SparseMatrix::Index> columns;
+    std::vector<double> values;
+
+    void factor() {
+        for (size_t i = 0; i < n; ++i) {
+            const size_t rowEnd = offsets[i + 1] - 1;  // diagonal slot
+            for (size_t k = offsets[i]; k <= rowEnd; ++k) {
+                const size_t j = columns[k];
+                // sum over the common pattern of rows i and j left of column j
+                double sum = values[k];
+                size_t p = offsets[i], q = offsets[j];
+                while (p < k && q < offsets[j + 1] - 1) {
+                    if (columns[p] < columns[q]) ++p;
+                    else if (columns[p] > columns[q]) ++q;
+                    else sum -= values[p++] * values[q++];
+                }
+                if (j < i) {
+                    values[k] = sum / values[offsets[j + 1] - 1];
+                } else {
+                    if (sum <= 0.0) {
+                        throw std::runtime_error("Incomplete Cholesky: non-positive pivot at row " + std::to_string(i));
+                    }
+                    values[k] = std::sqrt(sum);
+                }
+            }
+        }
+    }
+
+public:
+    explicit IncompleteCholeskyPreconditioner(const SparseMatrix& a) : n(a.getRows()) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Incomplete Cholesky requires a square matrix");
+        }
+        const SparseMatrix csr = a.toCSR();
+        const std::vector<size_t>& rowOffsets = csr.getOffsets();
+        const std::vector<SparseMatrix::Index>& rowColumns = csr.getIndices();
+        const std::vector<double>& rowValues = csr.getValues();
+
+        offsets.assign(n + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            bool hasDiagonal = false;
+            for (size_t k = rowOffsets[i]; k < rowOffsets[i + 1] && rowColumns[k] <= i; ++k) {
+                columns.push_back(rowColumns[k]);
+                values.push_back(rowValues[k]);
+                hasDiagonal = rowColumns[k] == i;
+            }
+            if (!hasDiagonal) {
+                throw std::runtime_error("Incomplete Cholesky: missing diagonal entry at row " + std::to_string(i));
+            }
+            offsets[i + 1] = columns.size();
+        }
+        factor();
+    }
+
+    explicit IncompleteCholeskyPreconditioner(const AcceleratedMatrix& a)
+        : IncompleteCholeskyPreconditioner(SparseMatrix::fromDense(a)) {}
+
+    size_t size() const { return n; }
+
+    // Forward solve with L by rows, then L^T by scattering the same rows backwards
+    void operator()(const double* r, double* z) const {
+        for (size_t i = 0; i < n; ++i) {
+            const size_t d = offsets[i + 1] - 1;
+            double sum = r[i];
+            for (size_t k = offsets[i]; k < d; ++k) sum -= values[k] * z[columns[k]];
+            z[i] = sum / values[d];
+        }
+        for (size_t i = n; i-- > 0;) {
+            const size_t d = offsets[i + 1] - 1;
+            z[i] /= values[d];
+            const double zi = z[i];
+            for (size_t k = offsets[i]; k < d; ++k) z[columns[k]] -= values[k] * zi;
+        }
+    }
+};
+
+struct IterativeOptions {
+    double tolerance = 1e-8;              // stop when ||b - A x|| <= tolerance * ||b||
+    size_t maxIterations = 1000;          // operator applications for CG/GMRES, twice that for BiCGSTAB
+    size_t restart = 30;                  // GMRES Krylov subspace size
+    std::vector<double> initialGuess;     // empty means x0 = 0
+};
+
+struct IterativeResult {
+    std::vector<double> x;
+    bool converged = false;
+    size_t iterations = 0;
+    double residualNorm = 0.0;            // ||b - A x|| / ||b|| at exit
+    std::vector<double> residualHistory;  // relative residual per iteration, [0] is the initial one
+};
+
+namespace IterativeSolvers {
+
+inline OperatorApply asOperator(const AcceleratedMatrix& a) {
+    if (a.getRows() != a.getCols()) {
+        throw std::invalid_argument("Iterative solvers require a square matrix");
+    }
+    return [&a](const double* x, double* y) { MatrixBackends::active().gemv(a.view(), x, y); };
+}
+
+inline OperatorApply asOperator(const SparseMatrix& a) {
+    if (a.getRows() != a.getCols()) {
+        throw std::invalid_argument("Iterative solvers require a square matrix");
+    }
+    return [&a](const double* x, double* y) { a.multiplyVector(x, y); };
+}
+
+inline OperatorApply asOperator(const LinearOperator& a) {
+    if (!a.isSquare()) {
+        throw std::invalid_argument("Iterative solvers require a square operator");
+    }
+    return [&a](const double* x, double* y) { a.apply(x, y); };
+}
+
+namespace detail {
+
+// y += alpha x
+inline void axpy(size_t count, double alpha, const double* x, double* y) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) y[i] += alpha * x[i];
+    });
+}
+
+inline double norm(const std::vector<double>& x) {
+    return std::sqrt(MatrixKernels::sumOfSquares(x.size(), x.data()));
+}
+
+inline double dot(const std::vector<double>& x, const std::vector<double>& y) {
+    return MatrixKernels::dot(x.size(), x.data(), y.data());
+}
+
+inline void precondition(const Preconditioner& m, const std::vector<double>& r, std::vector<double>& z) {
+    if (m) m(r.data(), z.data());
+    else z = r;
+}
+
+// Shared setup: validates sizes, fills x0 and r = b - A x0, and records
+// the initial residual. Returns ||b|| (1 when b = 0, so the history stays
+// absolute and x = 0 converges immediately).
+inline double start(size_t n, const OperatorApply& a, const std::vector<double>& b,
+                    const IterativeOptions& options, IterativeResult& result, std::vector<double>& r) {
+    if (b.size() != n) {
+        throw std::invalid_argument("Right-hand side size does not match operator");
+    }
+    if (!options.initialGuess.empty() && options.initialGuess.size() != n) {
+        throw std::invalid_argument("Initial guess size does not match operator");
+    }
+    if (!(options.tolerance > 0.0)) {
+        throw std::invalid_argument("Iterative solver tolerance must be positive");
+    }
+
+    result.x = options.initialGuess.empty() ? std::vector<double>(n, 0.0) : options.initialGuess;
+    r.assign(n, 0.0);
+    a(result.x.data(), r.data());
+    MatrixKernels::subtract(n, b.data(), r.data(), r.data());
+
+    double bnorm = norm(b);
+    if (bnorm == 0.0) bnorm = 1.0;
+    result.residualNorm = norm(r) / bnorm;
+    result.residualHistory.assign(1, result.residualNorm);
+    result.converged = result.residualNorm <= options.tolerance;
+    return bnorm;
+}
+
+inline bool record(IterativeResult& result, double relativeResidual, double tolerance) {
+    ++result.iterations;
+    result.residualNorm = relativeResidual;
+    result.residualHistory.push_back(relativeResidual);
+    result.converged = relativeResidual <= tolerance;
+    return result.converged;
+}
+
+} // namespace detail
+
+// Preconditioned conjugate gradients. A and M must be symmetric positive
+// definite; stops without converging if p^T A p <= 0 shows otherwise.
+inline IterativeResult conjugateGradient(size_t n, const OperatorApply& a, const std::vector<double>& b,
+                                         const IterativeOptions& options = IterativeOptions(),
+                                         const Preconditioner& m = Preconditioner()) {
+    IterativeResult result;
+    std::vector<double> r;
+    const double bnorm = detail::start(n, a, b, options, result, r);
+    if (result.converged) return result;
+
+    std::vector<double> z(n), ap(n);
+    detail::precondition(m, r, z);
+    std::vector<double> p = z;
+    double rz = detail::dot(r, z);
+
+    while (result.iterations < options.maxIterations) {
+        a(p.data(), ap.data());
+        const double pap = detail::dot(p, ap);
+        if (!(pap > 0.0)) break;
+
+        const double alpha = rz / pap;
+        detail::axpy(n, alpha, p.data(), result.x.data());
+        detail::axpy(n, -alpha, ap.data(), r.data());
+        if (detail::record(result, detail::norm(r) / bnorm, options.tolerance)) break;
+
+        detail::precondition(m, r, z);
+        const double rzNext = detail::dot(r, z);
+        const double beta = rzNext / rz;
+        rz = rzNext;
+        // p = z + beta p
+        MatrixKernels::scale(n, p.data(), beta, p.data());
+        MatrixKernels::add(n, z.data(), p.data(), p.data());
+    }
+    return result;
+}
+
+// Right-preconditioned BiCGSTAB for general nonsymmetric A. Each iteration
+// applies A (and M) twice; the history records the residual after both.
+inline IterativeResult bicgstab(size_t n, const OperatorApply& a, const std::vector<double>& b,
+                                const IterativeOptions& options = IterativeOptions(),
+                                const Preconditioner& m = Preconditioner()) {
+    IterativeResult result;
+    std::vector<double> r;
+    const double bnorm = detail::start(n, a, b, options, result, r);
+    if (result.converged) return result;
+
+    const std::vector<double> shadow = r;
+    std::vector<double> p(n, 0.0), v(n, 0.0), pHat(n), s(n), sHat(n), t(n);
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+
+    while (result.iterations < options.maxIterations) {
+        const double rhoNext = detail::dot(shadow, r);
+        if (rhoNext == 0.0) break;  // breakdown: the shadow residual is orthogonal to r
+
+        if (result.iterations == 0) {
+            p = r;
+        } else {
+            // p = r + beta (p - omega v)
+            const double beta = (rhoNext / rho) * (alpha / omega);
+            detail::axpy(n, -omega, v.data(), p.data());
+            MatrixKernels::scale(n, p.data(), beta, p.data());
+            MatrixKernels::add(n, r.data(), p.data(), p.data());
+        }
+        rho = rhoNext;
+
+        detail::precondition(m, p, pHat);
+        a(pHat.data(), v.data());
+        const double shadowV = detail::dot(shadow, v);
+        if (shadowV == 0.0) break;
+        alpha = rho / shadowV;
+
+        s = r;
+        detail::axpy(n, -alpha, v.data(), s.data());
+        const double sNorm = detail::norm(s) / bnorm;
+        if (sNorm <= options.tolerance) {
+            detail::axpy(n, alpha, pHat.data(), result.x.data());
+            detail::record(result, sNorm, options.tolerance);
+            break;
+        }
+
+        detail::precondition(m, s, sHat);
+        a(sHat.data(), t.data());
+        const double tt = detail::dot(t, t);
+        omega = tt > 0.0 ? detail::dot(t, s) / tt : 0.0;
+
+        detail::axpy(n, alpha, pHat.data(), result.x.data());
+        detail::axpy(n, omega, sHat.data(), result.x.data());
+        r = s;
+        detail::axpy(n, -omega, t.data(), r.data());
+        if (detail::record(result, detail::norm(r) / bnorm, options.tolerance)) break;
+        if (omega == 0.0) break;
+    }
+    return result;
+}
+
+// Restarted GMRES(m) with right preconditioning: Arnoldi with modified
+// Gram-Schmidt, Givens rotations on the Hessenberg matrix so the residual
+// norm of each inner iteration is known without forming x. The true
+// residual is recomputed at every restart.
+inline IterativeResult gmres(size_t n, const OperatorApply& a, const std::vector<double>& b,
+                             const IterativeOptions& options = IterativeOptions(),
+                             const Preconditioner& m = Preconditioner()) {
+    if (options.restart == 0) {
+        throw std::invalid_argument("GMRES restart length must be positive");
+    }
+    IterativeResult result;
+    std::vector<double> r;
+    const double bnorm = detail::start(n, a, b, options, result, r);
+    if (result.converged) return result;
+
+    const size_t restart = std::min(options.restart, n);
+    std::vector<std::vector<double>> basis(restart + 1, std::vector<double>(n));
+    std::vector<double> h((restart + 1) * restart);  // column-major Hessenberg, ld = restart + 1
+    std::vector<double> cs(restart), sn(restart), g(restart + 1), y(restart);
+    std::vector<double> z(n), w(n);
+    const size_t ldh = restart + 1;
+
+    while (result.iterations < options.maxIterations) {
+        const double beta = detail::norm(r);
+        MatrixKernels::scale(n, r.data(), 1.0 / beta, basis[0].data());
+        std::fill(g.begin(), g.end(), 0.0);
+        g[0] = beta;
+
+        size_t steps = 0;
+        while (steps < restart && result.iterations < options.maxIterations) {
+            const size_t j = steps;
+            detail::precondition(m, basis[j], z);
+            a(z.data(), w.data());
+
+            for (size_t i = 0; i <= j; ++i) {
+                const double hij = detail::dot(w, basis[i]);
+                h[i + j * ldh] = hij;
+                detail::axpy(n, -hij, basis[i].data(), w.data());
+            }
+            const double hNext = detail::norm(w);
+            h[j + 1 + j * ldh] = hNext;
+            if (hNext > 0.0) MatrixKernels::scale(n, w.data(), 1.0 / hNext, basis[j + 1].data());
+
+            for (size_t i = 0; i < j; ++i) {
+                const double upper = h[i + j * ldh], lower = h[i + 1 + j * ldh];
+                h[i + j * ldh] = cs[i] * upper + sn[i] * lower;
+                h[i + 1 + j * ldh] = -sn[i] * upper + cs[i] * lower;
+            }
+            const double diagonal = h[j + j * ldh];
+            const double radius = std::hypot(diagonal, hNext);
+            cs[j] = radius > 0.0 ? diagonal / radius : 1.0;
+            sn[j] = radius > 0.0 ? hNext / radius : 0.0;
+            h[j + j * ldh] = radius;
+            h[j + 1 + j * ldh] = 0.0;
+            g[j + 1] = -sn[j] * g[j];
+            g[j] = cs[j] * g[j];
+
+            ++steps;
+            const bool done = detail::record(result, std::abs(g[j + 1]) / bnorm, options.tolerance);
+            // A zero subdiagonal means the Krylov space is invariant: the
+            // least-squares solution is exact
+            if (done || hNext == 0.0) break;
+        }
+
+        // Back substitution with the triangularized Hessenberg matrix
+        for (size_t i = steps; i-- > 0;) {
+            double sum = g[i];
+            for (size_t k = i + 1; k < steps; ++k) sum -= h[i + k * ldh] * y[k];
+            y[i] = h[i + i * ldh] != 0.0 ? sum / h[i + i * ldh] : 0.0;
+        }
+        std::fill(w.begin(), w.end(), 0.0);
+        for (size_t i = 0; i < steps; ++i) detail::axpy(n, y[i], basis[i].data(), w.data());
+        detail::precondition(m, w, z);
+        MatrixKernels::add(n, result.x.data(), z.data(), result.x.data());
+
+        // True residual: the rotated estimate drifts in floating point
+        a(result.x.data(), r.data());
+        MatrixKernels::subtract(n, b.data(), r.data(), r.data());
+        result.residualNorm = detail::norm(r) / bnorm;
+        result.converged = result.residualNorm <= options.tolerance;
+        // Otherwise restart from the new x, also when the rotated
+        // estimate claimed convergence that the true residual denies
+        if (result.converged) break;
+    }
+    return result;
+}
+
+// Least squares min ||b - A x|| for a rectangular operator by CGLS:
+// conjugate gradients on A^T A x = A^T b, applying A and A^T once per
+// iteration instead of forming A^T A. Needs the transpose kernel. The
+// reported residual is the normal-equations one, ||A^T (b - A x)|| /
+// ||A^T b||, which goes to zero even when b is not in the range of A.
+inline IterativeResult leastSquares(const LinearOperator& a, const std::vector<double>& b,
+                                    const IterativeOptions& options = IterativeOptions()) {
+    const size_t m = a.getRows(), n = a.getCols();
+    if (b.size() != m) {
+        throw std::invalid_argument("Right-hand side size does not match operator rows");
+    }
+    if (!options.initialGuess.empty() && options.initialGuess.size() != n) {
+        throw std::invalid_argument("Initial guess size does not match operator columns");
+    }
+    if (!a.hasTranspose()) {
+        throw std::invalid_argument("Least squares requires an operator with a transpose kernel");
+    }
+
+    IterativeResult result;
+    result.x = options.initialGuess.empty() ? std::vector<double>(n, 0.0) : options.initialGuess;
+    std::vector<double> r(m), q(m), s(n);
+    a.apply(result.x.data(), r.data());
+    MatrixKernels::subtract(m, b.data(), r.data(), r.data());
+    a.applyTranspose(r.data(), s.data());
+
+    std::vector<double> atb(n);
+    a.applyTranspose(b.data(), atb.data());
+    double reference = detail::norm(atb);
+    if (reference == 0.0) reference = 1.0;
+
+    double gamma = MatrixKernels::sumOfSquares(n, s.data());
+    result.residualNorm = std::sqrt(gamma) / reference;
+    result.residualHistory.assign(1, result.residualNorm);
+    result.converged = result.residualNorm <= options.tolerance;
+
+    std::vector<double> p = s;
+    while (!result.converged && result.iterations < options.maxIterations) {
+        a.apply(p.data(), q.data());
+        const double qq = MatrixKernels::sumOfSquares(m, q.data());
+        if (qq == 0.0) break;
+
+        const double alpha = gamma / qq;
+        detail::axpy(n, alpha, p.data(), result.x.data());
+        detail::axpy(m, -alpha, q.data(), r.data());
+        a.applyTranspose(r.data(), s.data());
+
+        const double gammaNext = MatrixKernels::sumOfSquares(n, s.data());
+        if (detail::record(result, std::sqrt(gammaNext) / reference, options.tolerance)) break;
+        // p = s + beta p
+        MatrixKernels::scale(n, p.data(), gammaNext / gamma, p.data());
+        MatrixKernels::add(n, s.data(), p.data(), p.data());
+        gamma = gammaNext;
+    }
+    return result;
+}
+
+} // namespace IterativeSolvers
+
+#endif // ITERATIVESOLVERS_HPP
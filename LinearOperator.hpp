@@ -0,0 +1,247 @@
+// LinearOperator.hpp - Matrix-free linear operators (y = A x without storing A)
+#ifndef LINEAROPERATOR_HPP
+#define LINEAROPERATOR_HPP
+
+#include "AcceleratedMatrix.hpp"
+#include "SparseMatrix.hpp"
+
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <functional>
+#include <memory>
+#include <algorithm>
+
+// A rows x cols linear map known only through its action. Stencils,
+// Toeplitz and Kronecker structure can be applied in O(n) or O(n log n)
+// where the materialized AcceleratedMatrix would need O(n^2) storage and
+// work. Iterative solvers, least squares and eigensolvers that only form
+// products accept a LinearOperator in place of a matrix.
+//
+// Kernels work on batches: `count` vectors stored back to back (column-
+// major, ld = vector length), so block methods and callbacks with a high
+// per-call cost (Lua) pay that cost once per block. The transpose kernel
+// is optional; methods that need A^T check hasTranspose().
+class LinearOperator {
+public:
+    // Y = A X for count vectors: x holds count * cols values, y count * rows
+    using Kernel = std::function<void(size_t count, const double* x, double* y)>;
+    // y = A x for a single vector
+    using VectorKernel = std::function<void(const double* x, double* y)>;
+
+private:
+    size_t rows = 0, cols = 0;
+    Kernel forward;
+    Kernel adjoint;
+
+    // Applies a single-vector kernel to each vector of a batch
+    static Kernel columnByColumn(VectorKernel kernel, size_t inSize, size_t outSize) {
+        if (!kernel) return Kernel();
+        return [kernel, inSize, outSize](size_t count, const double* x, double* y) {
+            for (size_t k = 0; k < count; ++k) kernel(x + k * inSize, y + k * outSize);
+        };
+    }
+
+    // Product with a matrix whose columns may be padded: kernels expect
+    // packed vectors, so copy in and out unless already contiguous
+    AcceleratedMatrix applyToColumns(const Kernel& kernel, size_t inSize, size_t outSize,
+                                     const AcceleratedMatrix& x) const {
+        if (x.getRows() != inSize) {
+            throw std::invalid_argument("Operator dimensions incompatible for multiplication");
+        }
+        const size_t count = x.getCols();
+        AcceleratedMatrix y(outSize, count);
+        if (count == 0 || outSize == 0) return y;
+
+        const bool packedIn = x.view().isContiguous();
+        const bool packedOut = y.view().isContiguous();
+        std::vector<double> in, out;
+        if (!packedIn) {
+            in.resize(inSize * count);
+            MatrixKernels::copy(x.view(), MatrixView::columnMajor(in.data(), inSize, count, inSize));
+        }
+        if (!packedOut) out.resize(outSize * count);
+
+        kernel(count, packedIn ? x.getData() : in.data(), packedOut ? y.getData() : out.data());
+        if (!packedOut) {
+            MatrixKernels::copy(ConstMatrixView::columnMajor(out.data(), outSize, count, outSize), y.view());
+        }
+        return y;
+    }
+
+    static void checkKernel(const Kernel& kernel) {
+        if (!kernel) throw std::invalid_argument("Linear operator requires a forward kernel");
+    }
+
+public:
+    LinearOperator() = default;
+
+    // Batched kernels; applyTranspose may be empty
+    LinearOperator(size_t r, size_t c, Kernel apply, Kernel applyTranspose = Kernel())
+        : rows(r), cols(c), forward(std::move(apply)), adjoint(std::move(applyTranspose)) {
+        checkKernel(forward);
+    }
+
+    // Single-vector kernels, applied once per vector of a batch
+    static LinearOperator fromVectorKernel(size_t r, size_t c, VectorKernel apply,
+                                           VectorKernel applyTranspose = VectorKernel()) {
+        if (!apply) throw std::invalid_argument("Linear operator requires a forward kernel");
+        return LinearOperator(r, c, columnByColumn(std::move(apply), c, r),
+                              columnByColumn(std::move(applyTranspose), r, c));
+    }
+
+    // Owns its matrix: batches become one GEMM, single vectors one GEMV
+    explicit LinearOperator(AcceleratedMatrix a)
+        : LinearOperator(std::make_shared<const AcceleratedMatrix>(std::move(a))) {}
+
+    // Owns its sparse matrix: single vectors are one SpMV, batches one SpMM
+    // (or transposed SpMM) that reads the nonzeros once per block
+    explicit LinearOperator(SparseMatrix a)
+        : LinearOperator(std::make_shared<const SparseMatrix>(std::move(a))) {}
+
+    // Refers to `a` without copying it, for call-scoped use: `a` must
+    // outlive the operator and every copy of it
+    static LinearOperator borrow(const AcceleratedMatrix& a) {
+        return LinearOperator(std::shared_ptr<const AcceleratedMatrix>(&a, [](const AcceleratedMatrix*) {}));
+    }
+
+    static LinearOperator borrow(const SparseMatrix& a) {
+        return LinearOperator(std::shared_ptr<const SparseMatrix>(&a, [](const SparseMatrix*) {}));
+    }
+
+private:
+    // Kernels over a matrix that is either owned or borrowed by `matrix`
+    explicit LinearOperator(std::shared_ptr<const AcceleratedMatrix> matrix)
+        : rows(matrix->getRows()), cols(matrix->getCols()) {
+        auto product = [matrix](bool transposed, size_t count, const double* x, double* y) {
+            const ConstMatrixView op = transposed ? matrix->view().transposed() : matrix->view();
+            const MatrixBackend& backend = MatrixBackends::active();
+            if (count == 1) {
+                backend.gemv(op, x, y);
+            } else {
+                backend.gemm(1.0, op, ConstMatrixView::columnMajor(x, op.getCols(), count, op.getCols()),
+                             0.0, MatrixView::columnMajor(y, op.getRows(), count, op.getRows()));
+            }
+        };
+        forward = [product](size_t count, const double* x, double* y) { product(false, count, x, y); };
+        adjoint = [product](size_t count, const double* x, double* y) { product(true, count, x, y); };
+    }
+
+    explicit LinearOperator(std::shared_ptr<const SparseMatrix> matrix)
+        : rows(matrix->getRows()), cols(matrix->getCols()) {
+        const size_t r = rows, c = cols;
+        forward = [matrix, r, c](size_t count, const double* x, double* y) {
+            if (count == 1) {
+                matrix->multiplyVector(x, y);
+            } else {
+                matrix->multiply(ConstMatrixView::columnMajor(x, c, count, c),
+                                 MatrixView::columnMajor(y, r, count, r));
+            }
+        };
+        adjoint = [matrix, r, c](size_t count, const double* x, double* y) {
+            if (count == 1) {
+                matrix->multiplyTransposeVector(x, y);
+            } else {
+                matrix->multiplyTranspose(ConstMatrixView::columnMajor(x, r, count, r),
+                                          MatrixView::columnMajor(y, c, count, c));
+            }
+        };
+    }
+
+public:
+    // A (x) B without forming the (pq) x (rs) product: for x = vec(X) with
+    // X of size cols(B) x cols(A), (A (x) B) x = vec(B X A^T). Costs two
+    // small GEMMs per vector instead of one product with the full matrix.
+    static LinearOperator kronecker(AcceleratedMatrix a, AcceleratedMatrix b) {
+        auto left = std::make_shared<const AcceleratedMatrix>(std::move(a));
+        auto right = std::make_shared<const AcceleratedMatrix>(std::move(b));
+        auto product = [left, right](bool transposed, size_t count, const double* x, double* y) {
+            const ConstMatrixView opA = transposed ? left->view().transposed() : left->view();
+            const ConstMatrixView opB = transposed ? right->view().transposed() : right->view();
+            const size_t inSize = opA.getCols() * opB.getCols(), outSize = opA.getRows() * opB.getRows();
+            const MatrixBackend& backend = MatrixBackends::active();
+            std::vector<double> bx(opB.getRows() * opA.getCols());
+            for (size_t k = 0; k < count; ++k) {
+                const ConstMatrixView xk = ConstMatrixView::columnMajor(x + k * inSize, opB.getCols(), opA.getCols(), opB.getCols());
+                const MatrixView bxk = MatrixView::columnMajor(bx.data(), opB.getRows(), opA.getCols(), opB.getRows());
+                backend.gemm(1.0, opB, xk, 0.0, bxk);
+                backend.gemm(1.0, bxk, opA.transposed(), 0.0,
+                             MatrixView::columnMajor(y + k * outSize, opB.getRows(), opA.getRows(), opB.getRows()));
+            }
+        };
+        const size_t r = left->getRows() * right->getRows(), c = left->getCols() * right->getCols();
+        return LinearOperator(r, c,
+            [product](size_t count, const double* x, double* y) { product(false, count, x, y); },
+            [product](size_t count, const double* x, double* y) { product(true, count, x, y); });
+    }
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    bool isSquare() const { return rows == cols; }
+    bool hasTranspose() const { return static_cast<bool>(adjoint); }
+
+    // A^T as an operator of its own (swaps the kernels)
+    LinearOperator transpose() const {
+        if (!adjoint) throw std::runtime_error("Linear operator has no transpose kernel");
+        return LinearOperator(cols, rows, adjoint, forward);
+    }
+
+    // Raw products on packed storage
+    void apply(const double* x, double* y) const { forward(1, x, y); }
+    void applyMany(size_t count, const double* x, double* y) const { forward(count, x, y); }
+
+    void applyTranspose(const double* x, double* y) const { applyTransposeMany(1, x, y); }
+    void applyTransposeMany(size_t count, const double* x, double* y) const {
+        if (!adjoint) throw std::runtime_error("Linear operator has no transpose kernel");
+        adjoint(count, x, y);
+    }
+
+    std::vector<double> multiplyVector(const std::vector<double>& x) const {
+        if (x.size() != cols) throw std::invalid_argument("Vector size does not match operator columns");
+        std::vector<double> y(rows);
+        apply(x.data(), y.data());
+        return y;
+    }
+
+    std::vector<double> multiplyTransposeVector(const std::vector<double>& x) const {
+        if (x.size() != rows) throw std::invalid_argument("Vector size does not match operator rows");
+        std::vector<double> y(cols);
+        applyTranspose(x.data(), y.data());
+        return y;
+    }
+
+    // A X with all columns of X in one batch
+    AcceleratedMatrix multiply(const AcceleratedMatrix& x) const {
+        return applyToColumns(forward, cols, rows, x);
+    }
+
+    AcceleratedMatrix multiplyTranspose(const AcceleratedMatrix& x) const {
+        if (!adjoint) throw std::runtime_error("Linear operator has no transpose kernel");
+        return applyToColumns(adjoint, rows, cols, x);
+    }
+
+    // Materializes A by applying it to the identity, blockSize columns at a
+    // time (for checks on small operators; defeats the point otherwise)
+    AcceleratedMatrix toDense(size_t blockSize = 64) const {
+        AcceleratedMatrix result(rows, cols);
+        blockSize = std::max<size_t>(1, std::min(blockSize, cols));
+        std::vector<double> identity, product;
+        for (size_t j0 = 0; j0 < cols; j0 += blockSize) {
+            const size_t count = std::min(blockSize, cols - j0);
+            identity.assign(cols * count, 0.0);
+            for (size_t k = 0; k < count; ++k) identity[k * cols + j0 + k] = 1.0;
+            product.resize(rows * count);
+            forward(count, identity.data(), product.data());
+            MatrixKernels::copy(ConstMatrixView::columnMajor(product.data(), rows, count, rows),
+                                result.view(0, j0, rows, count));
+        }
+        return result;
+    }
+
+    std::string toString() const {
+        return "LinearOperator(" + std::to_string(rows) + "x" + std::to_string(cols) +
+               (adjoint ? ", with transpose)" : ")");
+    }
+};
+
+#endif // LINEAROPERATOR_HPP
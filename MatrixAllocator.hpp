@@ -0,0 +1,77 @@
+// MatrixAllocator.hpp - Cache-line aligned, huge-page-aware storage for matrices
+#ifndef MATRIXALLOCATOR_HPP
+#define MATRIXALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <limits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Alignment of every matrix buffer: one cache line, and a full AVX-512 register
+constexpr size_t MATRIX_ALIGNMENT = 64;
+
+// Transparent huge pages are 2 MB on x86-64 and most arm64 Linux kernels
+constexpr size_t MATRIX_HUGE_PAGE_SIZE = size_t(2) << 20;
+
+// Buffers at least this large are aligned to a huge page and advised with
+// MADV_HUGEPAGE (Linux only), so a multi-hundred-MB matrix costs a few
+// hundred TLB entries instead of tens of thousands. 0 disables huge pages.
+inline std::atomic<size_t>& matrixHugePageThresholdSlot() {
+    static std::atomic<size_t> threshold{size_t(8) << 20};
+    return threshold;
+}
+
+inline size_t getMatrixHugePageThreshold() {
+    return matrixHugePageThresholdSlot().load(std::memory_order_relaxed);
+}
+
+inline void setMatrixHugePageThreshold(size_t bytes) {
+    matrixHugePageThresholdSlot().store(bytes, std::memory_order_relaxed);
+}
+
+// Standard allocator for std::vector that returns MATRIX_ALIGNMENT-aligned
+// memory, switching to huge-page alignment above the threshold
+template <typename T>
+class MatrixAllocator {
+public:
+    using value_type = T;
+
+    MatrixAllocator() noexcept = default;
+    template <typename U>
+    MatrixAllocator(const MatrixAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_alloc();
+        size_t bytes = count * sizeof(T);
+        size_t alignment = MATRIX_ALIGNMENT;
+
+        const size_t threshold = getMatrixHugePageThreshold();
+        const bool hugePages = threshold != 0 && bytes >= threshold;
+        if (hugePages) alignment = MATRIX_HUGE_PAGE_SIZE;
+        bytes = (bytes + alignment - 1) / alignment * alignment;
+
+        void* memory = nullptr;
+        if (posix_memalign(&memory, alignment, bytes == 0 ? alignment : bytes) != 0) {
+            throw std::bad_alloc();
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // Advisory only: without THP support the call fails and 4 KB pages are used
+        if (hugePages) madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* pointer, size_t) noexcept { std::free(pointer); }
+
+    template <typename U>
+    bool operator==(const MatrixAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const MatrixAllocator<U>&) const noexcept { return false; }
+};
+
+#endif // MATRIXALLOCATOR_HPP
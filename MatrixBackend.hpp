@@ -0,0 +1,711 @@
+// MatrixBackend.hpp - Runtime-selectable providers for the dense linear algebra hot paths
+#ifndef MATRIXBACKEND_HPP
+#define MATRIXBACKEND_HPP
+
+#ifdef __APPLE__
+#include <Accelerate/Accelerate.h>
+#define ACCELERATED_MATRIX_HAS_LAPACK 1
+#elif defined(USE_SYSTEM_LAPACK)
+// System BLAS/LAPACK (OpenBLAS, reference LAPACK, ...) through the Fortran ABI.
+// Linked by CMake via find_package(BLAS) / find_package(LAPACK).
+#include <complex>
+
+extern "C" {
+    // BLAS Level 2/3
+    void dgemv_(const char* trans, const int* m, const int* n, const double* alpha,
+                const double* a, const int* lda, const double* x, const int* incx,
+                const double* beta, double* y, const int* incy);
+    void dgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+                const double* alpha, const double* a, const int* lda, const double* b, const int* ldb,
+                const double* beta, double* c, const int* ldc);
+    void dsyrk_(const char* uplo, const char* trans, const int* n, const int* k, const double* alpha,
+                const double* a, const int* lda, const double* beta, double* c, const int* ldc);
+
+    // LAPACK routines
+    void dgetrf_(const int* m, const int* n, double* a, const int* lda, int* ipiv, int* info);
+    void dgetri_(const int* n, double* a, const int* lda, const int* ipiv,
+                 double* work, const int* lwork, int* info);
+    void dgesv_(const int* n, const int* nrhs, double* a, const int* lda, int* ipiv,
+                double* b, const int* ldb, int* info);
+    void dgetrs_(const char* trans, const int* n, const int* nrhs, const double* a, const int* lda,
+                 const int* ipiv, double* b, const int* ldb, int* info);
+    void dgecon_(const char* norm, const int* n, const double* a, const int* lda, const double* anorm,
+                 double* rcond, double* work, int* iwork, int* info);
+    void dpotrf_(const char* uplo, const int* n, double* a, const int* lda, int* info);
+    void dpotrs_(const char* uplo, const int* n, const int* nrhs, const double* a, const int* lda,
+                 double* b, const int* ldb, int* info);
+    void dpocon_(const char* uplo, const int* n, const double* a, const int* lda, const double* anorm,
+                 double* rcond, double* work, int* iwork, int* info);
+    void dtrtrs_(const char* uplo, const char* trans, const char* diag, const int* n, const int* nrhs,
+                 const double* a, const int* lda, double* b, const int* ldb, int* info);
+    void dtrcon_(const char* norm, const char* uplo, const char* diag, const int* n,
+                 const double* a, const int* lda, double* rcond, double* work, int* iwork, int* info);
+    void dgeev_(const char* jobvl, const char* jobvr, const int* n, double* a, const int* lda,
+                double* wr, double* wi, double* vl, const int* ldvl, double* vr, const int* ldvr,
+                double* work, const int* lwork, int* info);
+    void dgeqrf_(const int* m, const int* n, double* a, const int* lda, double* tau,
+                 double* work, const int* lwork, int* info);
+    void dorgqr_(const int* m, const int* n, const int* k, double* a, const int* lda,
+                 const double* tau, double* work, const int* lwork, int* info);
+    void dormqr_(const char* side, const char* trans, const int* m, const int* n, const int* k,
+                 const double* a, const int* lda, const double* tau, double* c, const int* ldc,
+                 double* work, const int* lwork, int* info);
+    void dgesvd_(const char* jobu, const char* jobvt, const int* m, const int* n,
+                 double* a, const int* lda, double* s, double* u, const int* ldu,
+                 double* vt, const int* ldvt, double* work, const int* lwork, int* info);
+    void dgesdd_(const char* jobz, const int* m, const int* n, double* a, const int* lda, double* s,
+                 double* u, const int* ldu, double* vt, const int* ldvt, double* work, const int* lwork,
+                 int* iwork, int* info);
+    void dsyevd_(const char* jobz, const char* uplo, const int* n, double* a, const int* lda, double* w,
+                 double* work, const int* lwork, int* iwork, const int* liwork, int* info);
+    void dsyevr_(const char* jobz, const char* range, const char* uplo, const int* n, double* a, const int* lda,
+                 const double* vl, const double* vu, const int* il, const int* iu, const double* abstol,
+                 int* m, double* w, double* z, const int* ldz, int* isuppz,
+                 double* work, const int* lwork, int* iwork, const int* liwork, int* info);
+
+    // Single precision
+    void sgemv_(const char* trans, const int* m, const int* n, const float* alpha,
+                const float* a, const int* lda, const float* x, const int* incx,
+                const float* beta, float* y, const int* incy);
+    void sgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+                const float* alpha, const float* a, const int* lda, const float* b, const int* ldb,
+                const float* beta, float* c, const int* ldc);
+    void ssyrk_(const char* uplo, const char* trans, const int* n, const int* k, const float* alpha,
+                const float* a, const int* lda, const float* beta, float* c, const int* ldc);
+    void sgetrf_(const int* m, const int* n, float* a, const int* lda, int* ipiv, int* info);
+    void sgetrs_(const char* trans, const int* n, const int* nrhs, const float* a, const int* lda,
+                 const int* ipiv, float* b, const int* ldb, int* info);
+
+    // Double complex (std::complex<double> is layout-compatible with Fortran COMPLEX*16)
+    void zgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+                const std::complex<double>* alpha, const std::complex<double>* a, const int* lda,
+                const std::complex<double>* b, const int* ldb, const std::complex<double>* beta,
+                std::complex<double>* c, const int* ldc);
+    void zgetrf_(const int* m, const int* n, std::complex<double>* a, const int* lda, int* ipiv, int* info);
+    void zgetrs_(const char* trans, const int* n, const int* nrhs, const std::complex<double>* a,
+                 const int* lda, const int* ipiv, std::complex<double>* b, const int* ldb, int* info);
+    void zgeev_(const char* jobvl, const char* jobvr, const int* n, std::complex<double>* a, const int* lda,
+                std::complex<double>* w, std::complex<double>* vl, const int* ldvl,
+                std::complex<double>* vr, const int* ldvr, std::complex<double>* work, const int* lwork,
+                double* rwork, int* info);
+}
+#define ACCELERATED_MATRIX_HAS_LAPACK 1
+#endif
+
+#ifdef USE_EIGEN
+#include <Eigen/Dense>
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "MatrixView.hpp"
+#include "MatrixKernels.hpp"
+
+// A backend provides the dense hot paths that dominate scripts: GEMM, GEMV
+// and LU factor / solve. Every backend uses the same conventions, so the
+// matrices and factors they produce are interchangeable:
+//  - gemm:     C = alpha * A * B + beta * C on views (dimensions already
+//              checked; beta = 0 ignores the contents of C)
+//  - gemv:     y = A * x
+//  - syrk:     lower triangle of C = A^T A (A is k x n, C n x n); entries
+//              above the diagonal are left unspecified
+//  - luFactor: PA = LU in place on a column-major n x n block, LAPACK-style
+//              1-based row-interchange pivots; returns 0, or the 1-based
+//              index of the first zero pivot (as dgetrf's info)
+//  - luSolve:  A X = B, or A^T X = B when transposed, with those factors
+// The F32 entries are the same operations in single precision (sgemm,
+// sgemv, ssyrk, sgetrf, sgetrs). The active backend is chosen at startup (best
+// available, unless the MATRIX_BACKEND environment variable names another)
+// and can be switched at runtime, e.g. to A/B them from a script in one
+// process.
+struct MatrixBackend {
+    const char* name;
+    const char* description;
+    void (*gemm)(double alpha, ConstMatrixView a, ConstMatrixView b, double beta, MatrixView c);
+    void (*gemv)(ConstMatrixView a, const double* x, double* y);
+    void (*syrk)(ConstMatrixView a, MatrixView c);
+    int (*luFactor)(size_t n, double* a, size_t lda, int* pivots);
+    void (*luSolve)(bool transposed, size_t n, size_t nrhs, const double* lu, size_t lda,
+                    const int* pivots, double* b, size_t ldb);
+    void (*gemmF32)(float alpha, ConstMatrixViewF32 a, ConstMatrixViewF32 b, float beta, MatrixViewF32 c);
+    void (*gemvF32)(ConstMatrixViewF32 a, const float* x, float* y);
+    void (*syrkF32)(ConstMatrixViewF32 a, MatrixViewF32 c);
+    int (*luFactorF32)(size_t n, float* a, size_t lda, int* pivots);
+    void (*luSolveF32)(bool transposed, size_t n, size_t nrhs, const float* lu, size_t lda,
+                       const int* pivots, float* b, size_t ldb);
+};
+
+namespace MatrixBackends {
+
+namespace detail {
+
+// Every implementation below is a template over the scalar type; the
+// registry instantiates each one for double and float.
+
+template <typename Scalar> using View = BasicMatrixView<Scalar>;
+template <typename Scalar> using ConstView = BasicMatrixView<const Scalar>;
+
+// Lower triangle of C = A^T A from GEMMs on the column blocks on and below
+// the diagonal: about half the flops of the full product
+template <typename Scalar, typename Gemm>
+inline void syrkByBlocks(Gemm gemm, ConstView<Scalar> a, View<Scalar> c) {
+    constexpr size_t block = 128;
+    const size_t n = a.getCols();
+    for (size_t j = 0; j < n; j += block) {
+        const size_t jb = std::min(block, n - j);
+        gemm(Scalar(1), a.block(0, j, a.getRows(), n - j).transposed(), a.block(0, j, a.getRows(), jb),
+             Scalar(0), c.block(j, j, n - j, jb));
+    }
+}
+
+// --- naive: textbook loops, the baseline the others are measured against ----
+
+template <typename Scalar>
+inline void gemmNaive(Scalar alpha, ConstView<Scalar> a, ConstView<Scalar> b, Scalar beta, View<Scalar> c) {
+    for (size_t j = 0; j < c.getCols(); ++j) {
+        for (size_t i = 0; i < c.getRows(); ++i) {
+            Scalar sum = Scalar(0);
+            for (size_t p = 0; p < a.getCols(); ++p) sum += a(i, p) * b(p, j);
+            c(i, j) = alpha * sum + (beta == Scalar(0) ? Scalar(0) : beta * c(i, j));
+        }
+    }
+}
+
+template <typename Scalar>
+inline void gemvNaive(ConstView<Scalar> a, const Scalar* x, Scalar* y) {
+    for (size_t i = 0; i < a.getRows(); ++i) {
+        Scalar sum = Scalar(0);
+        for (size_t j = 0; j < a.getCols(); ++j) sum += a(i, j) * x[j];
+        y[i] = sum;
+    }
+}
+
+template <typename Scalar>
+inline void syrkNaive(ConstView<Scalar> a, View<Scalar> c) {
+    syrkByBlocks(gemmNaive<Scalar>, a, c);
+}
+
+template <typename Scalar>
+inline int luFactorNaive(size_t n, Scalar* a, size_t lda, int* pivots) {
+    int info = 0;
+    for (size_t k = 0; k < n; ++k) {
+        size_t p = k;
+        for (size_t i = k + 1; i < n; ++i) {
+            if (std::fabs(a[i + k * lda]) > std::fabs(a[p + k * lda])) p = i;
+        }
+        pivots[k] = static_cast<int>(p + 1);
+        if (a[p + k * lda] == Scalar(0)) {
+            if (info == 0) info = static_cast<int>(k + 1);
+            continue;
+        }
+        if (p != k) {
+            for (size_t j = 0; j < n; ++j) std::swap(a[k + j * lda], a[p + j * lda]);
+        }
+        for (size_t i = k + 1; i < n; ++i) a[i + k * lda] /= a[k + k * lda];
+        for (size_t j = k + 1; j < n; ++j) {
+            for (size_t i = k + 1; i < n; ++i) a[i + j * lda] -= a[i + k * lda] * a[k + j * lda];
+        }
+    }
+    return info;
+}
+
+template <typename Scalar>
+inline void luSolveNaive(bool transposed, size_t n, size_t nrhs, const Scalar* lu, size_t lda,
+                         const int* pivots, Scalar* b, size_t ldb) {
+    for (size_t c = 0; c < nrhs; ++c) {
+        Scalar* x = b + c * ldb;
+        if (!transposed) {
+            for (size_t k = 0; k < n; ++k) std::swap(x[k], x[pivots[k] - 1]);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t k = 0; k < i; ++k) x[i] -= lu[i + k * lda] * x[k];
+            }
+            for (size_t i = n; i-- > 0;) {
+                for (size_t k = i + 1; k < n; ++k) x[i] -= lu[i + k * lda] * x[k];
+                x[i] /= lu[i + i * lda];
+            }
+        } else {
+            // A^T = U^T L^T P
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t k = 0; k < i; ++k) x[i] -= lu[k + i * lda] * x[k];
+                x[i] /= lu[i + i * lda];
+            }
+            for (size_t i = n; i-- > 0;) {
+                for (size_t k = i + 1; k < n; ++k) x[i] -= lu[k + i * lda] * x[k];
+            }
+            for (size_t k = n; k-- > 0;) std::swap(x[k], x[pivots[k] - 1]);
+        }
+    }
+}
+
+// --- builtin: MatrixKernels (packed SIMD GEMM, blocked LU, thread pool) -----
+
+template <typename Scalar>
+inline void gemmBuiltin(Scalar alpha, ConstView<Scalar> a, ConstView<Scalar> b, Scalar beta, View<Scalar> c) {
+    MatrixKernels::gemm(alpha, a, b, beta, c);
+}
+
+template <typename Scalar>
+inline void gemvBuiltin(ConstView<Scalar> a, const Scalar* x, Scalar* y) {
+    MatrixKernels::gemv(a, x, y);
+}
+
+template <typename Scalar>
+inline void syrkBuiltin(ConstView<Scalar> a, View<Scalar> c) {
+    syrkByBlocks(gemmBuiltin<Scalar>, a, c);
+}
+
+template <typename Scalar>
+inline void luSolveBuiltin(bool transposed, size_t n, size_t nrhs, const Scalar* lu, size_t lda,
+                           const int* pivots, Scalar* b, size_t ldb) {
+    if (transposed) {
+        MatrixKernels::luSolveTransposed(n, nrhs, lu, lda, pivots, b, ldb);
+    } else {
+        MatrixKernels::luSolve(n, nrhs, lu, lda, pivots, b, ldb);
+    }
+}
+
+// Run gemm into a general-strided C through a packed column-major copy,
+// or as C^T = B^T A^T when C is row-major. Returns false if C is already
+// column-major and the caller should proceed.
+template <typename Scalar, typename Gemm>
+inline bool gemmIntoStridedOutput(Gemm gemm, Scalar alpha, ConstView<Scalar> a, ConstView<Scalar> b,
+                                  Scalar beta, View<Scalar> c) {
+    if (c.isColumnMajor()) return false;
+    if (c.isRowMajor()) {
+        gemm(alpha, b.transposed(), a.transposed(), beta, c.transposed());
+        return true;
+    }
+    std::vector<Scalar> tmp(c.getRows() * c.getCols());
+    View<Scalar> tmpView = View<Scalar>::columnMajor(tmp.data(), c.getRows(), c.getCols(),
+                                                     std::max<size_t>(c.getRows(), 1));
+    if (beta != Scalar(0)) MatrixKernels::copy(c, tmpView);
+    gemm(alpha, a, b, beta, tmpView);
+    MatrixKernels::copy(tmpView, c);
+    return true;
+}
+
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+
+// --- Accelerate / system BLAS and LAPACK ------------------------------------
+
+// Routine name prefix for error messages: dgetrf / sgetrf
+template <typename Scalar>
+constexpr char lapackPrefix() { return std::is_same<Scalar, float>::value ? 's' : 'd'; }
+
+// One overload per precision for each routine; Accelerate's CLAPACK
+// prototypes take non-const pointers for read-only arguments
+inline void blasGemm(bool transA, bool transB, int m, int n, int k, double alpha, const double* a, int lda,
+                     const double* b, int ldb, double beta, double* c, int ldc) {
+#ifdef __APPLE__
+    cblas_dgemm(CblasColMajor, transA ? CblasTrans : CblasNoTrans, transB ? CblasTrans : CblasNoTrans,
+                m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    const char ta = transA ? 'T' : 'N', tb = transB ? 'T' : 'N';
+    dgemm_(&ta, &tb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+#endif
+}
+
+inline void blasGemm(bool transA, bool transB, int m, int n, int k, float alpha, const float* a, int lda,
+                     const float* b, int ldb, float beta, float* c, int ldc) {
+#ifdef __APPLE__
+    cblas_sgemm(CblasColMajor, transA ? CblasTrans : CblasNoTrans, transB ? CblasTrans : CblasNoTrans,
+                m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    const char ta = transA ? 'T' : 'N', tb = transB ? 'T' : 'N';
+    sgemm_(&ta, &tb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+#endif
+}
+
+inline void blasGemv(bool trans, int m, int n, const double* a, int lda, const double* x, double* y) {
+    const double alpha = 1.0, beta = 0.0;
+    const int inc = 1;
+#ifdef __APPLE__
+    cblas_dgemv(CblasColMajor, trans ? CblasTrans : CblasNoTrans, m, n, alpha, a, lda, x, inc, beta, y, inc);
+#else
+    const char t = trans ? 'T' : 'N';
+    dgemv_(&t, &m, &n, &alpha, a, &lda, x, &inc, &beta, y, &inc);
+#endif
+}
+
+inline void blasGemv(bool trans, int m, int n, const float* a, int lda, const float* x, float* y) {
+    const float alpha = 1.0f, beta = 0.0f;
+    const int inc = 1;
+#ifdef __APPLE__
+    cblas_sgemv(CblasColMajor, trans ? CblasTrans : CblasNoTrans, m, n, alpha, a, lda, x, inc, beta, y, inc);
+#else
+    const char t = trans ? 'T' : 'N';
+    sgemv_(&t, &m, &n, &alpha, a, &lda, x, &inc, &beta, y, &inc);
+#endif
+}
+
+// Lower triangle of C = alpha * A^T A + beta * C (A is k x n)
+inline void blasSyrkLowerTransposed(int n, int k, double alpha, const double* a, int lda,
+                                    double beta, double* c, int ldc) {
+#ifdef __APPLE__
+    cblas_dsyrk(CblasColMajor, CblasLower, CblasTrans, n, k, alpha, a, lda, beta, c, ldc);
+#else
+    const char uplo = 'L', trans = 'T';
+    dsyrk_(&uplo, &trans, &n, &k, &alpha, a, &lda, &beta, c, &ldc);
+#endif
+}
+
+inline void blasSyrkLowerTransposed(int n, int k, float alpha, const float* a, int lda,
+                                    float beta, float* c, int ldc) {
+#ifdef __APPLE__
+    cblas_ssyrk(CblasColMajor, CblasLower, CblasTrans, n, k, alpha, a, lda, beta, c, ldc);
+#else
+    const char uplo = 'L', trans = 'T';
+    ssyrk_(&uplo, &trans, &n, &k, &alpha, a, &lda, &beta, c, &ldc);
+#endif
+}
+
+inline void lapackGetrf(int n, double* a, int lda, int* pivots, int* info) {
+    dgetrf_(&n, &n, a, &lda, pivots, info);
+}
+
+inline void lapackGetrf(int n, float* a, int lda, int* pivots, int* info) {
+    sgetrf_(&n, &n, a, &lda, pivots, info);
+}
+
+inline void lapackGetrs(char trans, int n, int nrhs, const double* lu, int lda, const int* pivots,
+                        double* b, int ldb, int* info) {
+    dgetrs_(&trans, &n, &nrhs, const_cast<double*>(lu), &lda, const_cast<int*>(pivots), b, &ldb, info);
+}
+
+inline void lapackGetrs(char trans, int n, int nrhs, const float* lu, int lda, const int* pivots,
+                        float* b, int ldb, int* info) {
+    sgetrs_(&trans, &n, &nrhs, const_cast<float*>(lu), &lda, const_cast<int*>(pivots), b, &ldb, info);
+}
+
+template <typename Scalar>
+inline void gemmBlas(Scalar alpha, ConstView<Scalar> a, ConstView<Scalar> b, Scalar beta, View<Scalar> c) {
+    if (gemmIntoStridedOutput(gemmBlas<Scalar>, alpha, a, b, beta, c)) return;
+    
+    const int m = static_cast<int>(c.getRows());
+    const int n = static_cast<int>(c.getCols());
+    const int k = static_cast<int>(a.getCols());
+    if (m == 0 || n == 0) return;
+    if (k == 0) {
+        // C = beta * C, except that beta = 0 overwrites NaN / Inf in C
+        if (beta == Scalar(0)) {
+            MatrixKernels::fill(c, Scalar(0));
+        } else {
+            MatrixKernels::scale(c, beta);
+        }
+        return;
+    }
+    
+    const auto opA = MatrixKernels::detail::gemmOperand(a);
+    const auto opB = MatrixKernels::detail::gemmOperand(b);
+    blasGemm(opA.trans, opB.trans, m, n, k, alpha, opA.data, static_cast<int>(opA.ld),
+             opB.data, static_cast<int>(opB.ld), beta, c.getData(), static_cast<int>(c.columnMajorLd()));
+}
+
+template <typename Scalar>
+inline void gemvBlas(ConstView<Scalar> a, const Scalar* x, Scalar* y) {
+    if (a.getRows() == 0) return;
+    if (a.getCols() == 0) {
+        std::fill(y, y + a.getRows(), Scalar(0));
+        return;
+    }
+    // Row-major storage is the column-major transpose: use gemv 'T'
+    const bool columnMajor = a.isColumnMajor();
+    if (!columnMajor && !a.isRowMajor()) {
+        MatrixKernels::gemv(a, x, y);
+        return;
+    }
+    const int m = static_cast<int>(columnMajor ? a.getRows() : a.getCols());
+    const int n = static_cast<int>(columnMajor ? a.getCols() : a.getRows());
+    const int lda = static_cast<int>(columnMajor ? a.columnMajorLd() : a.rowMajorLd());
+    blasGemv(!columnMajor, m, n, a.getData(), lda, x, y);
+}
+
+template <typename Scalar>
+inline void syrkBlas(ConstView<Scalar> a, View<Scalar> c) {
+    if (!a.isColumnMajor() || !c.isColumnMajor()) {
+        syrkByBlocks(gemmBlas<Scalar>, a, c);
+        return;
+    }
+    const int n = static_cast<int>(a.getCols());
+    const int k = static_cast<int>(a.getRows());
+    if (n == 0) return;
+    if (k == 0) {
+        MatrixKernels::fill(c, Scalar(0));
+        return;
+    }
+    blasSyrkLowerTransposed(n, k, Scalar(1), a.getData(), static_cast<int>(a.columnMajorLd()),
+                            Scalar(0), c.getData(), static_cast<int>(c.columnMajorLd()));
+}
+
+template <typename Scalar>
+inline int luFactorLapack(size_t n, Scalar* a, size_t lda, int* pivots) {
+    if (n == 0) return 0;
+    int info;
+    lapackGetrf(static_cast<int>(n), a, static_cast<int>(lda), pivots, &info);
+    if (info < 0) {
+        throw std::runtime_error(std::string("LAPACK ") + lapackPrefix<Scalar>() +
+                                 "getrf: illegal parameter at position " + std::to_string(-info));
+    }
+    return info;
+}
+
+template <typename Scalar>
+inline void luSolveLapack(bool transposed, size_t n, size_t nrhs, const Scalar* lu, size_t lda,
+                          const int* pivots, Scalar* b, size_t ldb) {
+    if (n == 0 || nrhs == 0) return;
+    int info;
+    lapackGetrs(transposed ? 'T' : 'N', static_cast<int>(n), static_cast<int>(nrhs), lu,
+                static_cast<int>(lda), pivots, b, static_cast<int>(ldb), &info);
+    if (info < 0) {
+        throw std::runtime_error(std::string("LAPACK ") + lapackPrefix<Scalar>() +
+                                 "getrs: illegal parameter at position " + std::to_string(-info));
+    }
+}
+
+#endif // ACCELERATED_MATRIX_HAS_LAPACK
+
+#ifdef USE_EIGEN
+
+// --- Eigen (header-only; built when CMake finds Eigen3) ---------------------
+
+template <typename Scalar>
+using EigenMatrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+template <typename Scalar>
+using EigenMap = Eigen::Map<EigenMatrix<Scalar>, 0, Eigen::OuterStride<>>;
+template <typename Scalar>
+using EigenConstMap = Eigen::Map<const EigenMatrix<Scalar>, 0, Eigen::OuterStride<>>;
+
+// Call f with an Eigen expression for v: column-major views map directly,
+// row-major ones as a mapped transpose, anything else through a copy
+template <typename Scalar, typename F>
+inline void withEigenOperand(ConstView<Scalar> v, std::vector<Scalar>& scratch, F&& f) {
+    const Eigen::Index rows = static_cast<Eigen::Index>(v.getRows());
+    const Eigen::Index cols = static_cast<Eigen::Index>(v.getCols());
+    if (v.isColumnMajor()) {
+        f(EigenConstMap<Scalar>(v.getData(), rows, cols, Eigen::OuterStride<>(v.columnMajorLd())));
+    } else if (v.isRowMajor()) {
+        f(EigenConstMap<Scalar>(v.getData(), cols, rows, Eigen::OuterStride<>(v.rowMajorLd())).transpose());
+    } else {
+        scratch.resize(v.getRows() * v.getCols());
+        const size_t ld = std::max<size_t>(v.getRows(), 1);
+        MatrixKernels::copy(v, View<Scalar>::columnMajor(scratch.data(), v.getRows(), v.getCols(), ld));
+        f(EigenConstMap<Scalar>(scratch.data(), rows, cols, Eigen::OuterStride<>(ld)));
+    }
+}
+
+template <typename Scalar>
+inline void gemmEigen(Scalar alpha, ConstView<Scalar> a, ConstView<Scalar> b, Scalar beta, View<Scalar> c) {
+    if (gemmIntoStridedOutput(gemmEigen<Scalar>, alpha, a, b, beta, c)) return;
+    if (c.empty()) return;
+    
+    EigenMap<Scalar> result(c.getData(), static_cast<Eigen::Index>(c.getRows()),
+                            static_cast<Eigen::Index>(c.getCols()), Eigen::OuterStride<>(c.columnMajorLd()));
+    if (beta == Scalar(0)) {
+        result.setZero();
+    } else if (beta != Scalar(1)) {
+        result *= beta;
+    }
+    std::vector<Scalar> scratchA, scratchB;
+    withEigenOperand(a, scratchA, [&](const auto& ea) {
+        withEigenOperand(b, scratchB, [&](const auto& eb) {
+            result.noalias() += alpha * ea * eb;
+        });
+    });
+}
+
+template <typename Scalar>
+inline void gemvEigen(ConstView<Scalar> a, const Scalar* x, Scalar* y) {
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    const Eigen::Index rows = static_cast<Eigen::Index>(a.getRows());
+    const Eigen::Index cols = static_cast<Eigen::Index>(a.getCols());
+    Eigen::Map<const Vector> ex(x, cols);
+    Eigen::Map<Vector> ey(y, rows);
+    std::vector<Scalar> scratch;
+    withEigenOperand(a, scratch, [&](const auto& ea) { ey.noalias() = ea * ex; });
+}
+
+template <typename Scalar>
+inline void syrkEigen(ConstView<Scalar> a, View<Scalar> c) {
+    syrkByBlocks(gemmEigen<Scalar>, a, c);
+}
+
+template <typename Scalar>
+inline int luFactorEigen(size_t n, Scalar* a, size_t lda, int* pivots) {
+    if (n == 0) return 0;
+    const Eigen::Index size = static_cast<Eigen::Index>(n);
+    EigenMap<Scalar> map(a, size, size, Eigen::OuterStride<>(lda));
+    Eigen::Ref<EigenMatrix<Scalar>> ref(map);
+    Eigen::PartialPivLU<Eigen::Ref<EigenMatrix<Scalar>>> lu(ref);  // factors in place
+    
+    // Eigen reports the net permutation (row i of A moves to row indices[i]
+    // of PA); rebuild the equivalent sequence of LAPACK row interchanges
+    const auto& indices = lu.permutationP().indices();
+    std::vector<size_t> source(n), current(n), position(n);
+    for (size_t i = 0; i < n; ++i) {
+        source[static_cast<size_t>(indices[static_cast<Eigen::Index>(i)])] = i;
+        current[i] = position[i] = i;
+    }
+    int info = 0;
+    for (size_t k = 0; k < n; ++k) {
+        const size_t j = position[source[k]];
+        pivots[k] = static_cast<int>(j + 1);
+        std::swap(current[k], current[j]);
+        position[current[k]] = k;
+        position[current[j]] = j;
+        if (info == 0 && a[k + k * lda] == Scalar(0)) info = static_cast<int>(k + 1);
+    }
+    return info;
+}
+
+template <typename Scalar>
+inline void luSolveEigen(bool transposed, size_t n, size_t nrhs, const Scalar* lu, size_t lda,
+                         const int* pivots, Scalar* b, size_t ldb) {
+    if (n == 0 || nrhs == 0) return;
+    const Eigen::Index size = static_cast<Eigen::Index>(n);
+    EigenConstMap<Scalar> factors(lu, size, size, Eigen::OuterStride<>(lda));
+    EigenMap<Scalar> rhs(b, size, static_cast<Eigen::Index>(nrhs), Eigen::OuterStride<>(ldb));
+    if (!transposed) {
+        for (size_t k = 0; k < n; ++k) {
+            if (pivots[k] != static_cast<int>(k + 1)) rhs.row(k).swap(rhs.row(pivots[k] - 1));
+        }
+        factors.template triangularView<Eigen::UnitLower>().solveInPlace(rhs);
+        factors.template triangularView<Eigen::Upper>().solveInPlace(rhs);
+    } else {
+        factors.transpose().template triangularView<Eigen::Lower>().solveInPlace(rhs);
+        factors.transpose().template triangularView<Eigen::UnitUpper>().solveInPlace(rhs);
+        for (size_t k = n; k-- > 0;) {
+            if (pivots[k] != static_cast<int>(k + 1)) rhs.row(k).swap(rhs.row(pivots[k] - 1));
+        }
+    }
+}
+
+#endif // USE_EIGEN
+
+// A registry entry from one family of templates, instantiated for both precisions
+#define MATRIX_BACKEND_ENTRY(name, description, gemm, gemv, syrk, luFactor, luSolve) \
+    {name, description, gemm<double>, gemv<double>, syrk<double>, luFactor<double>, luSolve<double>, \
+     gemm<float>, gemv<float>, syrk<float>, luFactor<float>, luSolve<float>}
+
+// All backends compiled into this binary, preferred first
+inline const std::vector<MatrixBackend>& compiledBackends() {
+    static const std::vector<MatrixBackend> backends = {
+#if defined(__APPLE__)
+        MATRIX_BACKEND_ENTRY("accelerate", "Apple Accelerate BLAS/LAPACK",
+                             gemmBlas, gemvBlas, syrkBlas, luFactorLapack, luSolveLapack),
+#elif defined(ACCELERATED_MATRIX_HAS_LAPACK)
+        MATRIX_BACKEND_ENTRY("openblas", "System BLAS/LAPACK (OpenBLAS when CMake found it)",
+                             gemmBlas, gemvBlas, syrkBlas, luFactorLapack, luSolveLapack),
+#endif
+        MATRIX_BACKEND_ENTRY("builtin", "Built-in multithreaded SIMD kernels",
+                             gemmBuiltin, gemvBuiltin, syrkBuiltin, MatrixKernels::luFactor, luSolveBuiltin),
+#ifdef USE_EIGEN
+        MATRIX_BACKEND_ENTRY("eigen", "Eigen " EIGEN_MAKESTRING(EIGEN_WORLD_VERSION) "."
+                             EIGEN_MAKESTRING(EIGEN_MAJOR_VERSION) "." EIGEN_MAKESTRING(EIGEN_MINOR_VERSION),
+                             gemmEigen, gemvEigen, syrkEigen, luFactorEigen, luSolveEigen),
+#endif
+        MATRIX_BACKEND_ENTRY("naive", "Reference loops (no blocking, SIMD or threads)",
+                             gemmNaive, gemvNaive, syrkNaive, luFactorNaive, luSolveNaive),
+    };
+    return backends;
+}
+
+#undef MATRIX_BACKEND_ENTRY
+
+inline const MatrixBackend* findBackend(const std::string& name) {
+    for (const MatrixBackend& backend : compiledBackends()) {
+        if (name == backend.name) return &backend;
+    }
+    return nullptr;
+}
+
+// First compiled backend, unless MATRIX_BACKEND names another one
+inline const MatrixBackend* defaultBackend() {
+    if (const char* requested = std::getenv("MATRIX_BACKEND")) {
+        if (const MatrixBackend* backend = findBackend(requested)) return backend;
+    }
+    return &compiledBackends().front();
+}
+
+inline std::atomic<const MatrixBackend*>& activeBackendSlot() {
+    static std::atomic<const MatrixBackend*> slot{defaultBackend()};
+    return slot;
+}
+
+} // namespace detail
+
+// Backend used by AcceleratedMatrix, LuaMatrix and the factorization classes
+inline const MatrixBackend& active() {
+    return *detail::activeBackendSlot().load(std::memory_order_acquire);
+}
+
+// Names of the backends compiled into this binary, preferred first
+inline std::vector<std::string> available() {
+    std::vector<std::string> names;
+    for (const MatrixBackend& backend : detail::compiledBackends()) names.push_back(backend.name);
+    return names;
+}
+
+// Switch backends; returns false if the name is not compiled in
+inline bool setActive(const std::string& name) {
+    const MatrixBackend* backend = detail::findBackend(name);
+    if (!backend) return false;
+    detail::activeBackendSlot().store(backend, std::memory_order_release);
+    return true;
+}
+
+// Precision-generic calls for templated code (AcceleratedMatrixT): each
+// overload forwards to the backend's double entry or its F32 counterpart
+inline void gemm(const MatrixBackend& backend, double alpha, ConstMatrixView a, ConstMatrixView b,
+                 double beta, MatrixView c) {
+    backend.gemm(alpha, a, b, beta, c);
+}
+
+inline void gemm(const MatrixBackend& backend, float alpha, ConstMatrixViewF32 a, ConstMatrixViewF32 b,
+                 float beta, MatrixViewF32 c) {
+    backend.gemmF32(alpha, a, b, beta, c);
+}
+
+inline void gemv(const MatrixBackend& backend, ConstMatrixView a, const double* x, double* y) {
+    backend.gemv(a, x, y);
+}
+
+inline void gemv(const MatrixBackend& backend, ConstMatrixViewF32 a, const float* x, float* y) {
+    backend.gemvF32(a, x, y);
+}
+
+inline void syrk(const MatrixBackend& backend, ConstMatrixView a, MatrixView c) {
+    backend.syrk(a, c);
+}
+
+inline void syrk(const MatrixBackend& backend, ConstMatrixViewF32 a, MatrixViewF32 c) {
+    backend.syrkF32(a, c);
+}
+
+inline int luFactor(const MatrixBackend& backend, size_t n, double* a, size_t lda, int* pivots) {
+    return backend.luFactor(n, a, lda, pivots);
+}
+
+inline int luFactor(const MatrixBackend& backend, size_t n, float* a, size_t lda, int* pivots) {
+    return backend.luFactorF32(n, a, lda, pivots);
+}
+
+inline void luSolve(const MatrixBackend& backend, bool transposed, size_t n, size_t nrhs, const double* lu,
+                    size_t lda, const int* pivots, double* b, size_t ldb) {
+    backend.luSolve(transposed, n, nrhs, lu, lda, pivots, b, ldb);
+}
+
+inline void luSolve(const MatrixBackend& backend, bool transposed, size_t n, size_t nrhs, const float* lu,
+                    size_t lda, const int* pivots, float* b, size_t ldb) {
+    backend.luSolveF32(transposed, n, nrhs, lu, lda, pivots, b, ldb);
+}
+
+} // namespace MatrixBackends
+
+#endif // MATRIXBACKEND_HPP
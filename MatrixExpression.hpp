@@ -0,0 +1,182 @@
+// MatrixExpression.hpp - Lazy, fused element-wise AcceleratedMatrix arithmetic
+#ifndef MATRIXEXPRESSION_HPP
+#define MATRIXEXPRESSION_HPP
+
+#include "AcceleratedMatrix.hpp"
+
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+// Records a chain such as (A + B) * 2 - C without computing anything, then
+// evaluates it in a single pass when materialized. The chain is kept as a
+// small stack program; evaluation walks the output in L1-sized blocks and
+// runs the whole program per block with the SIMD element-wise kernels, so
+// each operand is streamed from memory exactly once and no full-size
+// temporaries are created.
+//
+// Expressions hold pointers to their operand matrices, which must outlive
+// them. The same engine backs the C++ operators below and the Lua builder
+// (A:lazy():add(B):scale(2):subtract(C):evaluate()).
+class MatrixExpression {
+public:
+    explicit MatrixExpression(const AcceleratedMatrix& matrix)
+        : rows(matrix.getRows()), cols(matrix.getCols()), operands{&matrix},
+          program{{Op::Load, 0, 0.0}}, maxDepth(1) {}
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+
+    // Element-wise operations; each returns a new expression
+    MatrixExpression add(const MatrixExpression& other) const { return combine(other, Op::Add); }
+    MatrixExpression subtract(const MatrixExpression& other) const { return combine(other, Op::Subtract); }
+    MatrixExpression multiply(const MatrixExpression& other) const { return combine(other, Op::Multiply); }
+
+    MatrixExpression add(const AcceleratedMatrix& other) const { return add(MatrixExpression(other)); }
+    MatrixExpression subtract(const AcceleratedMatrix& other) const { return subtract(MatrixExpression(other)); }
+    MatrixExpression multiply(const AcceleratedMatrix& other) const { return multiply(MatrixExpression(other)); }
+
+    MatrixExpression scale(double factor) const { return unary(Op::Scale, factor); }
+    MatrixExpression addScalar(double value) const { return unary(Op::AddScalar, value); }
+
+    AcceleratedMatrix evaluate() const {
+        AcceleratedMatrix result(rows, cols);
+        evaluateInto(result);
+        return result;
+    }
+
+    // Write the result into an existing matrix of the same shape. The output
+    // may be one of the operands (A = A * 2 + B evaluates correctly).
+    void evaluateInto(AcceleratedMatrix& out) const {
+        if (out.getRows() != rows || out.getCols() != cols) {
+            throw std::invalid_argument("Expression result dimensions do not match output matrix");
+        }
+        // An operand reshaped since the expression was built (transposeInPlace)
+        // no longer lines up with the output
+        for (const AcceleratedMatrix* operand : operands) {
+            if (operand->getRows() != rows || operand->getCols() != cols) {
+                throw std::invalid_argument("Expression operand changed shape after the expression was built");
+            }
+        }
+
+        // Equal shapes share a padded layout, so whole buffers line up
+        const size_t count = out.getStorageSize();
+        double* dest = out.getData();
+        MatrixThreadPool& pool = MatrixThreadPool::instance();
+        const size_t minChunk = std::max(pool.getSerialCutoff() / program.size(), BLOCK);
+        pool.parallelFor(0, count, minChunk, [&](size_t lo, size_t hi) {
+            std::vector<double> scratch(maxDepth * BLOCK);
+            for (size_t begin = lo; begin < hi; begin += BLOCK) {
+                evaluateBlock(begin, std::min(BLOCK, hi - begin), dest + begin, scratch.data());
+            }
+        });
+        // Scalar additions also land in the padding rows
+        out.zeroPadding();
+    }
+
+private:
+    enum class Op { Load, Add, Subtract, Multiply, Scale, AddScalar };
+
+    struct Instruction {
+        Op op;
+        size_t operand;  // Load: index into operands
+        double scalar;   // Scale / AddScalar
+    };
+
+    // Elements per block; one scratch block per stack slot stays in L1
+    static constexpr size_t BLOCK = 512;
+
+    size_t rows, cols;
+    std::vector<const AcceleratedMatrix*> operands;
+    std::vector<Instruction> program;
+    size_t maxDepth;
+
+    MatrixExpression unary(Op op, double scalar) const {
+        MatrixExpression result = *this;
+        result.program.push_back({op, 0, scalar});
+        return result;
+    }
+
+    MatrixExpression combine(const MatrixExpression& other, Op op) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for element-wise operations");
+        }
+        MatrixExpression result = *this;
+        const size_t offset = operands.size();
+        result.operands.insert(result.operands.end(), other.operands.begin(), other.operands.end());
+        for (Instruction instruction : other.program) {
+            if (instruction.op == Op::Load) instruction.operand += offset;
+            result.program.push_back(instruction);
+        }
+        result.program.push_back({op, 0, 0.0});
+        // The left operand's value sits on the stack while the right one is built
+        result.maxDepth = std::max(maxDepth, other.maxDepth + 1);
+        return result;
+    }
+
+    // Run the program over elements [begin, begin + len); the last
+    // instruction writes straight into out
+    void evaluateBlock(size_t begin, size_t len, double* out, double* scratch) const {
+        const MatrixKernels::KernelVariant& kernels = MatrixKernels::activeKernels();
+        const double* stack[64];
+        std::vector<const double*> deepStack;
+        const double** values = stack;
+        if (maxDepth > 64) {
+            deepStack.resize(maxDepth);
+            values = deepStack.data();
+        }
+
+        size_t depth = 0;
+        for (size_t pc = 0; pc < program.size(); ++pc) {
+            const Instruction& instruction = program[pc];
+            if (instruction.op == Op::Load) {
+                values[depth++] = operands[instruction.operand]->getData() + begin;
+                continue;
+            }
+
+            const bool last = pc + 1 == program.size();
+            if (instruction.op == Op::Scale || instruction.op == Op::AddScalar) {
+                const double* x = values[depth - 1];
+                double* target = last ? out : scratch + (depth - 1) * BLOCK;
+                if (instruction.op == Op::Scale) {
+                    kernels.scale(len, x, instruction.scalar, target);
+                } else {
+                    for (size_t i = 0; i < len; ++i) target[i] = x[i] + instruction.scalar;
+                }
+                values[depth - 1] = target;
+                continue;
+            }
+
+            const double* y = values[--depth];
+            const double* x = values[depth - 1];
+            double* target = last ? out : scratch + (depth - 1) * BLOCK;
+            switch (instruction.op) {
+            case Op::Add: kernels.add(len, x, y, target); break;
+            case Op::Subtract: kernels.subtract(len, x, y, target); break;
+            default:
+                for (size_t i = 0; i < len; ++i) target[i] = x[i] * y[i];
+                break;
+            }
+            values[depth - 1] = target;
+        }
+
+        // A bare Load: nothing wrote to out yet
+        if (values[0] != out) std::copy(values[0], values[0] + len, out);
+    }
+};
+
+// C++ operator sugar: (lazy(A) + B) * 2.0 - C, then .evaluate()
+inline MatrixExpression lazy(const AcceleratedMatrix& matrix) { return MatrixExpression(matrix); }
+
+inline MatrixExpression operator+(const MatrixExpression& a, const MatrixExpression& b) { return a.add(b); }
+inline MatrixExpression operator+(const MatrixExpression& a, const AcceleratedMatrix& b) { return a.add(b); }
+inline MatrixExpression operator+(const AcceleratedMatrix& a, const MatrixExpression& b) { return lazy(a).add(b); }
+inline MatrixExpression operator-(const MatrixExpression& a, const MatrixExpression& b) { return a.subtract(b); }
+inline MatrixExpression operator-(const MatrixExpression& a, const AcceleratedMatrix& b) { return a.subtract(b); }
+inline MatrixExpression operator-(const AcceleratedMatrix& a, const MatrixExpression& b) { return lazy(a).subtract(b); }
+inline MatrixExpression operator*(const MatrixExpression& a, double factor) { return a.scale(factor); }
+inline MatrixExpression operator*(double factor, const MatrixExpression& a) { return a.scale(factor); }
+inline MatrixExpression operator+(const MatrixExpression& a, double value) { return a.addScalar(value); }
+inline MatrixExpression operator-(const MatrixExpression& a, double value) { return a.addScalar(-value); }
+
+#endif // MATRIXEXPRESSION_HPP
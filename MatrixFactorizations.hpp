@@ -0,0 +1,547 @@
+// MatrixFactorizations.hpp - Reusable LU, Cholesky and QR factorizations
+#ifndef MATRIXFACTORIZATIONS_HPP
+#define MATRIXFACTORIZATIONS_HPP
+
+#include "AcceleratedMatrix.hpp"
+
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <cfloat>
+#include <limits>
+#include <memory>
+#include <algorithm>
+
+// Each class factors its matrix once in the constructor (O(n^3)); solve()
+// and solveMany() then cost O(n^2) per right-hand side. LU factors and
+// solves with the active MatrixBackend; the rest uses LAPACK when linked,
+// the built-in MatrixKernels otherwise. Accelerate's CLAPACK
+// prototypes take non-const pointers, hence the const_casts on the stored
+// factors, which LAPACK only reads.
+
+// PA = LU with partial pivoting (dgetrf / dgetrs / dgecon)
+class LUFactorization {
+private:
+    AcceleratedMatrix lu;
+    std::vector<int> pivots;  // 1-based, LAPACK convention
+    size_t n;
+    double anorm;             // 1-norm of the original matrix, for rcond()
+    int singularColumn = 0;   // 1-based index of the first zero pivot, or 0
+
+    double* factorData() const { return const_cast<double*>(lu.getData()); }
+    int* pivotData() const { return const_cast<int*>(pivots.data()); }
+
+    void solveInPlace(double* b, size_t nrhs, size_t ldb, bool transposed) const {
+        if (singularColumn != 0) {
+            throw std::runtime_error("Matrix is singular: cannot solve system");
+        }
+        if (n == 0 || nrhs == 0) return;
+        MatrixBackends::active().luSolve(transposed, n, nrhs, lu.getData(), lu.getLeadingDimension(),
+                                         pivots.data(), b, ldb);
+    }
+
+public:
+    explicit LUFactorization(const AcceleratedMatrix& a)
+        : lu(a), pivots(a.getRows()), n(a.getRows()) {
+        if (a.getRows() != a.getCols()) throw std::invalid_argument("LU factorization requires square matrix");
+        anorm = MatrixKernels::norm1(n, n, a.getData(), a.getLeadingDimension());
+        if (n == 0) return;
+        singularColumn = MatrixBackends::active().luFactor(n, lu.getData(), lu.getLeadingDimension(), pivots.data());
+    }
+
+    size_t size() const { return n; }
+    bool isSingular() const { return singularColumn != 0; }
+
+    // Packed factors: unit L below the diagonal, U on and above it
+    const AcceleratedMatrix& getFactors() const { return lu; }
+    const std::vector<int>& getPivots() const { return pivots; }
+
+    std::vector<double> solve(const std::vector<double>& b) const {
+        if (b.size() != n) throw std::invalid_argument("Right-hand side vector size mismatch");
+        std::vector<double> x = b;
+        solveInPlace(x.data(), 1, n, false);
+        return x;
+    }
+
+    AcceleratedMatrix solveMany(const AcceleratedMatrix& b) const {
+        if (b.getRows() != n) throw std::invalid_argument("Right-hand side matrix row count mismatch");
+        AcceleratedMatrix x = b;
+        solveInPlace(x.getData(), b.getCols(), x.getLeadingDimension(), false);
+        return x;
+    }
+
+    double determinant() const {
+        if (singularColumn != 0) return 0.0;
+        double det = 1.0;
+        for (size_t i = 0; i < n; ++i) {
+            det *= lu.get(i, i);
+            if (pivots[i] != static_cast<int>(i + 1)) det = -det;
+        }
+        return det;
+    }
+
+    // Reciprocal condition number in the 1-norm (estimate, as dgecon)
+    double rcond() const {
+        if (n == 0) return 1.0;
+        if (singularColumn != 0 || anorm == 0.0) return 0.0;
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        char norm = '1';
+        int nn = static_cast<int>(n);
+        int lda = static_cast<int>(lu.getLeadingDimension());
+        int info;
+        double anormCopy = anorm;
+        double result = 0.0;
+        std::vector<double> work(4 * n);
+        std::vector<int> iwork(n);
+        dgecon_(&norm, &nn, factorData(), &lda, &anormCopy, &result, work.data(), iwork.data(), &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dgecon: illegal parameter at position " + std::to_string(-info));
+        }
+        return result;
+#else
+        const double inverseNorm = MatrixKernels::inverseNorm1Estimate(n,
+            [this](double* x) { solveInPlace(x, 1, n, false); },
+            [this](double* x) { solveInPlace(x, 1, n, true); });
+        return inverseNorm == 0.0 ? 0.0 : 1.0 / (anorm * inverseNorm);
+#endif
+    }
+};
+
+// Outcome of a MixedPrecisionLUFactorization solve
+struct RefinedSolution {
+    std::vector<double> x;
+    int iterations = 0;          // single-precision correction steps applied
+    double backwardError = 0.0;  // ||b - Ax||_inf / (||A||_inf ||x||_inf + ||b||_inf)
+    bool usedFallback = false;   // x came from a double-precision LU instead
+};
+
+// PA = LU computed in single precision, with each solution refined to double
+// precision (the dsgesv scheme): solve with the float factors, then repeat
+// r = b - Ax in double, LU d = r in float, x += d until r is at double
+// rounding level. The O(n^3) factorization runs at float speed and each
+// refinement step costs O(n^2), so well-conditioned systems reach full
+// accuracy for roughly half the time of a double solve. Each step gains
+// about -log10(cond(A) * FLT_EPSILON) digits; once the residual stops
+// halving per step, or the matrix does not fit in float, solve() falls back
+// to a double-precision LUFactorization, built on first use.
+//
+// The residuals need the original matrix, which is referenced rather than
+// copied: it must outlive the factorization and stay unmodified.
+class MixedPrecisionLUFactorization {
+private:
+    const AcceleratedMatrix& a;
+    AcceleratedMatrixF32 lu;
+    std::vector<int> pivots; // 1-based, LAPACK convention
+    size_t n;
+    double anorm = 0.0;      // infinity-norm of a
+    int maxIterations;
+    bool singlePrecisionUsable = false;
+    mutable std::unique_ptr<LUFactorization> fallback;
+
+    static double maxAbs(const std::vector<double>& v) {
+        double result = 0.0;
+        for (double value : v) result = std::max(result, std::abs(value));
+        return result;
+    }
+
+    // r = b - Ax, returns ||r||_inf
+    double residual(const std::vector<double>& x, const std::vector<double>& b, std::vector<double>& r) const {
+        MatrixBackends::active().gemv(a.view(), x.data(), r.data());
+        for (size_t i = 0; i < n; ++i) r[i] = b[i] - r[i];
+        return maxAbs(r);
+    }
+
+    double backwardError(double rnorm, double xnorm, double bnorm) const {
+        const double denominator = anorm * xnorm + bnorm;
+        return denominator == 0.0 ? 0.0 : rnorm / denominator;
+    }
+
+    // In-place float solve of the double vector v, scaled by 1/||v|| first
+    // so small residuals do not underflow when rounded to float
+    void solveSinglePrecision(std::vector<double>& v, std::vector<float>& work) const {
+        const double scale = maxAbs(v);
+        if (scale == 0.0) return;
+        for (size_t i = 0; i < n; ++i) work[i] = static_cast<float>(v[i] / scale);
+        MatrixBackends::active().luSolveF32(false, n, 1, lu.getData(), lu.getLeadingDimension(),
+                                            pivots.data(), work.data(), n);
+        for (size_t i = 0; i < n; ++i) v[i] = scale * static_cast<double>(work[i]);
+    }
+
+    const LUFactorization& fallbackFactorization() const {
+        if (!fallback) fallback.reset(new LUFactorization(a));
+        return *fallback;
+    }
+
+public:
+    explicit MixedPrecisionLUFactorization(const AcceleratedMatrix& matrix, int maxIterations = 30)
+        : a(matrix), lu(matrix), pivots(matrix.getRows()), n(matrix.getRows()), maxIterations(maxIterations) {
+        if (matrix.getRows() != matrix.getCols()) {
+            throw std::invalid_argument("LU factorization requires square matrix");
+        }
+        if (maxIterations < 0) throw std::invalid_argument("Iteration limit must be non-negative");
+
+        // Infinity-norm and largest entry in one column-major pass
+        std::vector<double> rowSums(n, 0.0);
+        double largest = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            const double* col = a.getData() + j * a.getLeadingDimension();
+            for (size_t i = 0; i < n; ++i) {
+                const double v = std::abs(col[i]);
+                rowSums[i] += v;
+                largest = std::max(largest, v);
+            }
+        }
+        anorm = n > 0 ? *std::max_element(rowSums.begin(), rowSums.end()) : 0.0;
+
+        // Entries beyond float range would round to infinity
+        if (n == 0 || !(largest <= FLT_MAX)) return;
+        singlePrecisionUsable = MatrixBackends::active().luFactorF32(n, lu.getData(), lu.getLeadingDimension(),
+                                                                     pivots.data()) == 0;
+    }
+
+    size_t size() const { return n; }
+
+    // False when the float factorization was singular or A overflowed float;
+    // every solve then goes straight to double precision
+    bool usesSinglePrecision() const { return singlePrecisionUsable; }
+
+    RefinedSolution solve(const std::vector<double>& b) const {
+        if (b.size() != n) throw std::invalid_argument("Right-hand side vector size mismatch");
+        RefinedSolution result;
+        if (n == 0) return result;
+
+        const double bnorm = maxAbs(b);
+        // LAPACK's dsgesv stopping test: ||r|| <= sqrt(n) * eps * ||A|| * ||x||
+        const double tolerance = std::sqrt(static_cast<double>(n)) * std::numeric_limits<double>::epsilon() / 2;
+        std::vector<double> r(n);
+
+        if (singlePrecisionUsable) {
+            std::vector<float> work(n);
+            std::vector<double> x = b;
+            solveSinglePrecision(x, work);
+
+            double previous = std::numeric_limits<double>::infinity();
+            for (;;) {
+                const double rnorm = residual(x, b, r);
+                const double xnorm = maxAbs(x);
+                if (!std::isfinite(rnorm) || !std::isfinite(xnorm)) break;
+                if (rnorm <= tolerance * anorm * xnorm) {
+                    result.backwardError = backwardError(rnorm, xnorm, bnorm);
+                    result.x = std::move(x);
+                    return result;
+                }
+                // Stalled: cond(A) is too large for float factors to converge
+                if (result.iterations >= maxIterations || rnorm > 0.5 * previous) break;
+                previous = rnorm;
+
+                solveSinglePrecision(r, work);
+                for (size_t i = 0; i < n; ++i) x[i] += r[i];
+                ++result.iterations;
+            }
+        }
+
+        result.x = fallbackFactorization().solve(b);
+        result.usedFallback = true;
+        result.backwardError = backwardError(residual(result.x, b, r), maxAbs(result.x), bnorm);
+        return result;
+    }
+};
+
+// One-shot mixed-precision solve of Ax = b
+inline RefinedSolution solveRefined(const AcceleratedMatrix& a, const std::vector<double>& b,
+                                    int maxIterations = 30) {
+    return MixedPrecisionLUFactorization(a, maxIterations).solve(b);
+}
+
+// A = L L^T for symmetric positive definite A (dpotrf / dpotrs / dpocon).
+// Only the lower triangle of the input is referenced.
+class CholeskyFactorization {
+private:
+    AcceleratedMatrix l;
+    size_t n;
+    double anorm;
+    int failedColumn = 0;  // 1-based column where A stopped being positive definite, or 0
+
+    double* factorData() const { return const_cast<double*>(l.getData()); }
+
+    void requirePositiveDefinite() const {
+        if (failedColumn != 0) {
+            throw std::runtime_error("Matrix is not positive definite (leading minor " +
+                                     std::to_string(failedColumn) + ")");
+        }
+    }
+
+    void solveInPlace(double* b, size_t nrhs, size_t ldb) const {
+        requirePositiveDefinite();
+        if (n == 0 || nrhs == 0) return;
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        char uplo = 'L';
+        int nn = static_cast<int>(n);
+        int nr = static_cast<int>(nrhs);
+        int lda = static_cast<int>(l.getLeadingDimension()), ldbi = static_cast<int>(ldb);
+        int info;
+        dpotrs_(&uplo, &nn, &nr, factorData(), &lda, b, &ldbi, &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dpotrs: illegal parameter at position " + std::to_string(-info));
+        }
+#else
+        MatrixKernels::choleskySolve(n, nrhs, l.getData(), l.getLeadingDimension(), b, ldb);
+#endif
+    }
+
+public:
+    explicit CholeskyFactorization(const AcceleratedMatrix& a)
+        : l(a), n(a.getRows()) {
+        if (a.getRows() != a.getCols()) throw std::invalid_argument("Cholesky factorization requires square matrix");
+
+        // Symmetric 1-norm from the lower triangle
+        std::vector<double> columnSums(n, 0.0);
+        for (size_t j = 0; j < n; ++j) {
+            for (size_t i = j; i < n; ++i) {
+                const double v = std::abs(a.get(i, j));
+                columnSums[j] += v;
+                if (i != j) columnSums[i] += v;
+            }
+        }
+        anorm = n > 0 ? *std::max_element(columnSums.begin(), columnSums.end()) : 0.0;
+        if (n == 0) return;
+
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        char uplo = 'L';
+        int nn = static_cast<int>(n);
+        int lda = static_cast<int>(l.getLeadingDimension());
+        int info;
+        dpotrf_(&uplo, &nn, l.getData(), &lda, &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dpotrf: illegal parameter at position " + std::to_string(-info));
+        }
+        failedColumn = info;
+#else
+        failedColumn = MatrixKernels::choleskyFactor(n, l.getData(), l.getLeadingDimension());
+#endif
+
+        // Keep a clean lower-triangular factor
+        for (size_t j = 1; j < n; ++j) {
+            for (size_t i = 0; i < j; ++i) l.set(i, j, 0.0);
+        }
+    }
+
+    size_t size() const { return n; }
+    bool isPositiveDefinite() const { return failedColumn == 0; }
+
+    const AcceleratedMatrix& getL() const {
+        requirePositiveDefinite();
+        return l;
+    }
+
+    std::vector<double> solve(const std::vector<double>& b) const {
+        if (b.size() != n) throw std::invalid_argument("Right-hand side vector size mismatch");
+        std::vector<double> x = b;
+        solveInPlace(x.data(), 1, n);
+        return x;
+    }
+
+    AcceleratedMatrix solveMany(const AcceleratedMatrix& b) const {
+        if (b.getRows() != n) throw std::invalid_argument("Right-hand side matrix row count mismatch");
+        AcceleratedMatrix x = b;
+        solveInPlace(x.getData(), b.getCols(), x.getLeadingDimension());
+        return x;
+    }
+
+    double determinant() const {
+        requirePositiveDefinite();
+        double det = 1.0;
+        for (size_t i = 0; i < n; ++i) det *= l.get(i, i);
+        return det * det;
+    }
+
+    // Reciprocal condition number in the 1-norm (estimate, as dpocon)
+    double rcond() const {
+        if (n == 0) return 1.0;
+        if (failedColumn != 0 || anorm == 0.0) return 0.0;
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        char uplo = 'L';
+        int nn = static_cast<int>(n);
+        int lda = static_cast<int>(l.getLeadingDimension());
+        int info;
+        double anormCopy = anorm;
+        double result = 0.0;
+        std::vector<double> work(3 * n);
+        std::vector<int> iwork(n);
+        dpocon_(&uplo, &nn, factorData(), &lda, &anormCopy, &result, work.data(), iwork.data(), &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dpocon: illegal parameter at position " + std::to_string(-info));
+        }
+        return result;
+#else
+        // A is symmetric, so A^-T = A^-1
+        auto solveOne = [this](double* x) { solveInPlace(x, 1, n); };
+        const double inverseNorm = MatrixKernels::inverseNorm1Estimate(n, solveOne, solveOne);
+        return inverseNorm == 0.0 ? 0.0 : 1.0 / (anorm * inverseNorm);
+#endif
+    }
+};
+
+// A x = b for symmetric positive definite A (e.g. from AcceleratedMatrix::gram)
+// through one Cholesky factorization: half the flops of the LU behind
+// AcceleratedMatrix::solve. Throws std::runtime_error if A is not positive
+// definite.
+inline std::vector<double> solveSPD(const AcceleratedMatrix& a, const std::vector<double>& b) {
+    return CholeskyFactorization(a).solve(b);
+}
+
+inline AcceleratedMatrix solveSPD(const AcceleratedMatrix& a, const AcceleratedMatrix& b) {
+    return CholeskyFactorization(a).solveMany(b);
+}
+
+// A = QR with Householder reflectors for m x n A, m >= n (dgeqrf / dormqr /
+// dtrtrs). solve() returns the least-squares solution when m > n.
+class QRFactorization {
+private:
+    AcceleratedMatrix qr;     // R on and above the diagonal, reflectors below
+    std::vector<double> tau;
+    size_t m, n;
+
+    double* factorData() const { return const_cast<double*>(qr.getData()); }
+
+    bool isRankDeficient() const {
+        for (size_t i = 0; i < n; ++i) {
+            if (qr.get(i, i) == 0.0) return true;
+        }
+        return false;
+    }
+
+    // b (m x nrhs) -> x in its first n rows
+    void solveInPlace(double* b, size_t nrhs, size_t ldb) const {
+        if (isRankDeficient()) {
+            throw std::runtime_error("Matrix is rank deficient: cannot solve system");
+        }
+        if (n == 0 || nrhs == 0) return;
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        char side = 'L', trans = 'T';
+        char uplo = 'U', notrans = 'N', diag = 'N';
+        int mm = static_cast<int>(m), nn = static_cast<int>(n);
+        int nr = static_cast<int>(nrhs);
+        int lda = static_cast<int>(qr.getLeadingDimension()), ldbi = static_cast<int>(ldb);
+        int info;
+
+        double work_query;
+        int lwork = -1;
+        dormqr_(&side, &trans, &mm, &nr, &nn, factorData(), &lda, const_cast<double*>(tau.data()),
+                b, &ldbi, &work_query, &lwork, &info);
+        lwork = static_cast<int>(work_query);
+        std::vector<double> work(lwork);
+        dormqr_(&side, &trans, &mm, &nr, &nn, factorData(), &lda, const_cast<double*>(tau.data()),
+                b, &ldbi, work.data(), &lwork, &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dormqr: illegal parameter at position " + std::to_string(-info));
+        }
+
+        dtrtrs_(&uplo, &notrans, &diag, &nn, &nr, factorData(), &lda, b, &ldbi, &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dtrtrs: illegal parameter at position " + std::to_string(-info));
+        }
+#else
+        MatrixKernels::qrApplyQt(m, n, qr.getData(), qr.getLeadingDimension(), tau.data(), nrhs, b, ldb);
+        MatrixKernels::detail::trsmUpper(n, nrhs, qr.getData(), qr.getLeadingDimension(), b, ldb);
+#endif
+    }
+
+public:
+    explicit QRFactorization(const AcceleratedMatrix& a)
+        : qr(a), tau(a.getCols()), m(a.getRows()), n(a.getCols()) {
+        if (m < n) throw std::invalid_argument("QR factorization requires rows >= cols");
+        if (n == 0) return;
+
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        int mm = static_cast<int>(m), nn = static_cast<int>(n);
+        int lda = static_cast<int>(qr.getLeadingDimension());
+        int info;
+
+        double work_query;
+        int lwork = -1;
+        dgeqrf_(&mm, &nn, qr.getData(), &lda, tau.data(), &work_query, &lwork, &info);
+        lwork = static_cast<int>(work_query);
+        std::vector<double> work(lwork);
+        dgeqrf_(&mm, &nn, qr.getData(), &lda, tau.data(), work.data(), &lwork, &info);
+        if (info != 0) {
+            throw std::runtime_error("QR decomposition failed");
+        }
+#else
+        MatrixKernels::qrFactor(m, n, qr.getData(), qr.getLeadingDimension(), tau.data());
+#endif
+    }
+
+    size_t getRows() const { return m; }
+    size_t getCols() const { return n; }
+
+    AcceleratedMatrix getR() const {
+        AcceleratedMatrix r(qr.view(0, 0, n, n));
+        for (size_t j = 0; j < n; ++j) {
+            double* column = r.getData() + j * r.getLeadingDimension();
+            std::fill(column + j + 1, column + n, 0.0);
+        }
+        return r;
+    }
+
+    // Least-squares solution of min ||A x - b||_2 (exact solve when square)
+    std::vector<double> solve(const std::vector<double>& b) const {
+        if (b.size() != m) throw std::invalid_argument("Right-hand side vector size mismatch");
+        std::vector<double> work = b;
+        solveInPlace(work.data(), 1, m);
+        work.resize(n);
+        return work;
+    }
+
+    AcceleratedMatrix solveMany(const AcceleratedMatrix& b) const {
+        if (b.getRows() != m) throw std::invalid_argument("Right-hand side matrix row count mismatch");
+        AcceleratedMatrix work = b;
+        solveInPlace(work.getData(), b.getCols(), work.getLeadingDimension());
+
+        return AcceleratedMatrix(work.view(0, 0, n, b.getCols()));
+    }
+
+    // det(A) = det(Q) det(R); every non-trivial reflector contributes -1
+    double determinant() const {
+        if (m != n) throw std::invalid_argument("Determinant only defined for square matrices");
+        double det = 1.0;
+        for (size_t i = 0; i < n; ++i) {
+            det *= qr.get(i, i);
+            if (tau[i] != 0.0) det = -det;
+        }
+        return det;
+    }
+
+    // Estimated reciprocal condition number of R in the 1-norm (dtrcon, or
+    // Hager's estimator on the builtin path). Q preserves 2-norms, not
+    // 1-norms, so this only approximates A's conditioning.
+    double rcond() const {
+        if (n == 0) return 1.0;
+        if (isRankDeficient()) return 0.0;
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        char norm = '1', uplo = 'U', diag = 'N';
+        int nn = static_cast<int>(n);
+        int lda = static_cast<int>(qr.getLeadingDimension());
+        int info;
+        double result = 0.0;
+        std::vector<double> work(3 * n);
+        std::vector<int> iwork(n);
+        dtrcon_(&norm, &uplo, &diag, &nn, factorData(), &lda, &result, work.data(), iwork.data(), &info);
+        if (info < 0) {
+            throw std::runtime_error("LAPACK dtrcon: illegal parameter at position " + std::to_string(-info));
+        }
+        return result;
+#else
+        const AcceleratedMatrix r = getR();
+        const size_t ldr = r.getLeadingDimension();
+        const double rnorm = MatrixKernels::norm1(n, n, r.getData(), ldr);
+        const double inverseNorm = MatrixKernels::inverseNorm1Estimate(n,
+            [&](double* x) { MatrixKernels::detail::trsmUpper(n, 1, r.getData(), ldr, x, n); },
+            [&](double* x) { MatrixKernels::detail::trsmUpperTransposed(n, 1, r.getData(), ldr, x, n); });
+        return (rnorm == 0.0 || inverseNorm == 0.0) ? 0.0 : 1.0 / (rnorm * inverseNorm);
+#endif
+    }
+};
+
+#endif // MATRIXFACTORIZATIONS_HPP
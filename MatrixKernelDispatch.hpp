@@ -0,0 +1,738 @@
+// MatrixKernelDispatch.hpp - ISA-specific leaf kernels selected at runtime via CPUID
+#ifndef MATRIXKERNELDISPATCH_HPP
+#define MATRIXKERNELDISPATCH_HPP
+
+// On x86 with GCC/Clang every variant is compiled into the same binary with
+// per-function target attributes; the best one the CPU supports is picked
+// on first use. Other platforms only get the portable variant.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define MATRIX_KERNELS_X86_DISPATCH 1
+#define MATRIX_KERNELS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace MatrixKernels {
+
+// Largest register tile over all variants and precisions (sizes the
+// microkernel output buffer)
+constexpr size_t GEMM_MAX_MR = 32;
+constexpr size_t GEMM_MAX_NR = 12;
+
+// Edge of the square tile handled by transposeTile
+constexpr size_t TRANSPOSE_TILE = 8;
+
+// One complete set of serial leaf kernels for a particular instruction set.
+// The GEMM microkernel computes ab(mr x nr, column-major, ld = mr) =
+// Ap * Bp for panels packed with this variant's mr / nr. transposeTile
+// writes the transpose of the 8x8 column-major block at in (ld ldi) to out
+// (ld ldo); the two blocks must not overlap.
+//
+// The F32 entries are the single-precision counterparts. A register holds
+// twice as many floats as doubles, so the float tile is mrF32 = 2 * mr
+// rows high and every element-wise kernel moves twice the lanes per
+// instruction.
+struct KernelVariant {
+    const char* name;
+    size_t mr;
+    size_t nr;
+    void (*gemmMicroKernel)(size_t kc, const double* ap, const double* bp, double* ab);
+    void (*add)(size_t n, const double* x, const double* y, double* out);
+    void (*subtract)(size_t n, const double* x, const double* y, double* out);
+    void (*scale)(size_t n, const double* x, double factor, double* out);
+    double (*dot)(size_t n, const double* x, const double* y);
+    double (*sumOfSquares)(size_t n, const double* x);
+    double (*sum)(size_t n, const double* x);
+    void (*transposeTile)(const double* in, size_t ldi, double* out, size_t ldo);
+    size_t mrF32;
+    size_t nrF32;
+    void (*gemmMicroKernelF32)(size_t kc, const float* ap, const float* bp, float* ab);
+    void (*addF32)(size_t n, const float* x, const float* y, float* out);
+    void (*subtractF32)(size_t n, const float* x, const float* y, float* out);
+    void (*scaleF32)(size_t n, const float* x, float factor, float* out);
+};
+
+namespace detail {
+
+// --- Portable variant ------------------------------------------------------
+
+template <typename Scalar, size_t MR>
+inline void microKernelGeneric(size_t kc, const Scalar* ap, const Scalar* bp, Scalar* ab) {
+    constexpr size_t NR = 6;
+    Scalar acc[NR][MR] = {};
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t j = 0; j < NR; ++j) {
+            const Scalar bj = bp[j];
+            for (size_t i = 0; i < MR; ++i) {
+                acc[j][i] += ap[i] * bj;
+            }
+        }
+        ap += MR;
+        bp += NR;
+    }
+    for (size_t j = 0; j < NR; ++j) {
+        for (size_t i = 0; i < MR; ++i) ab[i + j * MR] = acc[j][i];
+    }
+}
+
+template <typename Scalar>
+inline void addGeneric(size_t n, const Scalar* x, const Scalar* y, Scalar* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = x[i] + y[i];
+}
+
+template <typename Scalar>
+inline void subtractGeneric(size_t n, const Scalar* x, const Scalar* y, Scalar* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = x[i] - y[i];
+}
+
+template <typename Scalar>
+inline void scaleGeneric(size_t n, const Scalar* x, Scalar factor, Scalar* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = x[i] * factor;
+}
+
+// Reductions keep four independent partial sums to hide add latency
+inline double dotGeneric(size_t n, const double* x, const double* y) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < n; ++i) s0 += x[i] * y[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+inline double sumOfSquaresGeneric(size_t n, const double* x) {
+    return dotGeneric(n, x, x);
+}
+
+inline double sumGeneric(size_t n, const double* x) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i];
+        s1 += x[i + 1];
+        s2 += x[i + 2];
+        s3 += x[i + 3];
+    }
+    for (; i < n; ++i) s0 += x[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+template <typename Scalar>
+inline void transposeTileGeneric(const Scalar* in, size_t ldi, Scalar* out, size_t ldo) {
+    for (size_t j = 0; j < TRANSPOSE_TILE; ++j) {
+        for (size_t i = 0; i < TRANSPOSE_TILE; ++i) out[j + i * ldo] = in[i + j * ldi];
+    }
+}
+
+#ifdef MATRIX_KERNELS_X86_DISPATCH
+
+// --- SSE4.2 variant: 4x4 tile, 8 xmm accumulators ---------------------------
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void microKernelSSE42(size_t kc, const double* ap, const double* bp, double* ab) {
+    __m128d c00 = _mm_setzero_pd(), c10 = _mm_setzero_pd();
+    __m128d c01 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+    __m128d c02 = _mm_setzero_pd(), c12 = _mm_setzero_pd();
+    __m128d c03 = _mm_setzero_pd(), c13 = _mm_setzero_pd();
+
+    for (size_t p = 0; p < kc; ++p) {
+        const __m128d a0 = _mm_loadu_pd(ap);
+        const __m128d a1 = _mm_loadu_pd(ap + 2);
+        __m128d b;
+        b = _mm_set1_pd(bp[0]); c00 = _mm_add_pd(c00, _mm_mul_pd(a0, b)); c10 = _mm_add_pd(c10, _mm_mul_pd(a1, b));
+        b = _mm_set1_pd(bp[1]); c01 = _mm_add_pd(c01, _mm_mul_pd(a0, b)); c11 = _mm_add_pd(c11, _mm_mul_pd(a1, b));
+        b = _mm_set1_pd(bp[2]); c02 = _mm_add_pd(c02, _mm_mul_pd(a0, b)); c12 = _mm_add_pd(c12, _mm_mul_pd(a1, b));
+        b = _mm_set1_pd(bp[3]); c03 = _mm_add_pd(c03, _mm_mul_pd(a0, b)); c13 = _mm_add_pd(c13, _mm_mul_pd(a1, b));
+        ap += 4;
+        bp += 4;
+    }
+
+    _mm_storeu_pd(ab + 0, c00);  _mm_storeu_pd(ab + 2, c10);
+    _mm_storeu_pd(ab + 4, c01);  _mm_storeu_pd(ab + 6, c11);
+    _mm_storeu_pd(ab + 8, c02);  _mm_storeu_pd(ab + 10, c12);
+    _mm_storeu_pd(ab + 12, c03); _mm_storeu_pd(ab + 14, c13);
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void addSSE42(size_t n, const double* x, const double* y, double* out) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; ++i) out[i] = x[i] + y[i];
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void subtractSSE42(size_t n, const double* x, const double* y, double* out) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; ++i) out[i] = x[i] - y[i];
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void scaleSSE42(size_t n, const double* x, double factor, double* out) {
+    const __m128d f = _mm_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(x + i), f));
+    for (; i < n; ++i) out[i] = x[i] * factor;
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline double dotSSE42(size_t n, const double* x, const double* y) {
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+    double result = lanes[0] + lanes[1];
+    for (; i < n; ++i) result += x[i] * y[i];
+    return result;
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline double sumOfSquaresSSE42(size_t n, const double* x) {
+    return dotSSE42(n, x, x);
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline double sumSSE42(size_t n, const double* x) {
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm_add_pd(s0, _mm_loadu_pd(x + i));
+        s1 = _mm_add_pd(s1, _mm_loadu_pd(x + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+    double result = lanes[0] + lanes[1];
+    for (; i < n; ++i) result += x[i];
+    return result;
+}
+
+// 2x2 sub-blocks: one unpacklo / unpackhi pair each
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void transposeTileSSE42(const double* in, size_t ldi, double* out, size_t ldo) {
+    for (size_t j = 0; j < TRANSPOSE_TILE; j += 2) {
+        for (size_t i = 0; i < TRANSPOSE_TILE; i += 2) {
+            const __m128d c0 = _mm_loadu_pd(in + i + j * ldi);
+            const __m128d c1 = _mm_loadu_pd(in + i + (j + 1) * ldi);
+            _mm_storeu_pd(out + j + i * ldo, _mm_unpacklo_pd(c0, c1));
+            _mm_storeu_pd(out + j + (i + 1) * ldo, _mm_unpackhi_pd(c0, c1));
+        }
+    }
+}
+
+// Single precision: 8x4 tile, 8 xmm accumulators
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void microKernelSSE42F32(size_t kc, const float* ap, const float* bp, float* ab) {
+    __m128 c00 = _mm_setzero_ps(), c10 = _mm_setzero_ps();
+    __m128 c01 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+    __m128 c02 = _mm_setzero_ps(), c12 = _mm_setzero_ps();
+    __m128 c03 = _mm_setzero_ps(), c13 = _mm_setzero_ps();
+
+    for (size_t p = 0; p < kc; ++p) {
+        const __m128 a0 = _mm_loadu_ps(ap);
+        const __m128 a1 = _mm_loadu_ps(ap + 4);
+        __m128 b;
+        b = _mm_set1_ps(bp[0]); c00 = _mm_add_ps(c00, _mm_mul_ps(a0, b)); c10 = _mm_add_ps(c10, _mm_mul_ps(a1, b));
+        b = _mm_set1_ps(bp[1]); c01 = _mm_add_ps(c01, _mm_mul_ps(a0, b)); c11 = _mm_add_ps(c11, _mm_mul_ps(a1, b));
+        b = _mm_set1_ps(bp[2]); c02 = _mm_add_ps(c02, _mm_mul_ps(a0, b)); c12 = _mm_add_ps(c12, _mm_mul_ps(a1, b));
+        b = _mm_set1_ps(bp[3]); c03 = _mm_add_ps(c03, _mm_mul_ps(a0, b)); c13 = _mm_add_ps(c13, _mm_mul_ps(a1, b));
+        ap += 8;
+        bp += 4;
+    }
+
+    _mm_storeu_ps(ab + 0, c00);  _mm_storeu_ps(ab + 4, c10);
+    _mm_storeu_ps(ab + 8, c01);  _mm_storeu_ps(ab + 12, c11);
+    _mm_storeu_ps(ab + 16, c02); _mm_storeu_ps(ab + 20, c12);
+    _mm_storeu_ps(ab + 24, c03); _mm_storeu_ps(ab + 28, c13);
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void addSSE42F32(size_t n, const float* x, const float* y, float* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    for (; i < n; ++i) out[i] = x[i] + y[i];
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void subtractSSE42F32(size_t n, const float* x, const float* y, float* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    for (; i < n; ++i) out[i] = x[i] - y[i];
+}
+
+MATRIX_KERNELS_TARGET("sse4.2")
+inline void scaleSSE42F32(size_t n, const float* x, float factor, float* out) {
+    const __m128 f = _mm_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(x + i), f));
+    for (; i < n; ++i) out[i] = x[i] * factor;
+}
+
+// --- AVX2/FMA variant: 8x6 tile, 12 ymm accumulators ------------------------
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void microKernelAVX2(size_t kc, const double* ap, const double* bp, double* ab) {
+    __m256d c00 = _mm256_setzero_pd(), c10 = _mm256_setzero_pd();
+    __m256d c01 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c02 = _mm256_setzero_pd(), c12 = _mm256_setzero_pd();
+    __m256d c03 = _mm256_setzero_pd(), c13 = _mm256_setzero_pd();
+    __m256d c04 = _mm256_setzero_pd(), c14 = _mm256_setzero_pd();
+    __m256d c05 = _mm256_setzero_pd(), c15 = _mm256_setzero_pd();
+
+    for (size_t p = 0; p < kc; ++p) {
+        const __m256d a0 = _mm256_loadu_pd(ap);
+        const __m256d a1 = _mm256_loadu_pd(ap + 4);
+        __m256d b;
+        b = _mm256_broadcast_sd(bp + 0); c00 = _mm256_fmadd_pd(a0, b, c00); c10 = _mm256_fmadd_pd(a1, b, c10);
+        b = _mm256_broadcast_sd(bp + 1); c01 = _mm256_fmadd_pd(a0, b, c01); c11 = _mm256_fmadd_pd(a1, b, c11);
+        b = _mm256_broadcast_sd(bp + 2); c02 = _mm256_fmadd_pd(a0, b, c02); c12 = _mm256_fmadd_pd(a1, b, c12);
+        b = _mm256_broadcast_sd(bp + 3); c03 = _mm256_fmadd_pd(a0, b, c03); c13 = _mm256_fmadd_pd(a1, b, c13);
+        b = _mm256_broadcast_sd(bp + 4); c04 = _mm256_fmadd_pd(a0, b, c04); c14 = _mm256_fmadd_pd(a1, b, c14);
+        b = _mm256_broadcast_sd(bp + 5); c05 = _mm256_fmadd_pd(a0, b, c05); c15 = _mm256_fmadd_pd(a1, b, c15);
+        ap += 8;
+        bp += 6;
+    }
+
+    _mm256_storeu_pd(ab + 0, c00);  _mm256_storeu_pd(ab + 4, c10);
+    _mm256_storeu_pd(ab + 8, c01);  _mm256_storeu_pd(ab + 12, c11);
+    _mm256_storeu_pd(ab + 16, c02); _mm256_storeu_pd(ab + 20, c12);
+    _mm256_storeu_pd(ab + 24, c03); _mm256_storeu_pd(ab + 28, c13);
+    _mm256_storeu_pd(ab + 32, c04); _mm256_storeu_pd(ab + 36, c14);
+    _mm256_storeu_pd(ab + 40, c05); _mm256_storeu_pd(ab + 44, c15);
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void addAVX2(size_t n, const double* x, const double* y, double* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < n; ++i) out[i] = x[i] + y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void subtractAVX2(size_t n, const double* x, const double* y, double* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < n; ++i) out[i] = x[i] - y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void scaleAVX2(size_t n, const double* x, double factor, double* out) {
+    const __m256d f = _mm256_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), f));
+    for (; i < n; ++i) out[i] = x[i] * factor;
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline double horizontalSumAVX2(__m256d v) {
+    const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline double dotAVX2(size_t n, const double* x, const double* y) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), s3);
+    }
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+    }
+    double result = horizontalSumAVX2(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; i < n; ++i) result += x[i] * y[i];
+    return result;
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline double sumOfSquaresAVX2(size_t n, const double* x) {
+    return dotAVX2(n, x, x);
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline double sumAVX2(size_t n, const double* x) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(x + i));
+        s1 = _mm256_add_pd(s1, _mm256_loadu_pd(x + i + 4));
+        s2 = _mm256_add_pd(s2, _mm256_loadu_pd(x + i + 8));
+        s3 = _mm256_add_pd(s3, _mm256_loadu_pd(x + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) s0 = _mm256_add_pd(s0, _mm256_loadu_pd(x + i));
+    double result = horizontalSumAVX2(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; i < n; ++i) result += x[i];
+    return result;
+}
+
+// 4x4 sub-blocks: unpack within 128-bit lanes, then exchange lanes
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void transposeTileAVX2(const double* in, size_t ldi, double* out, size_t ldo) {
+    for (size_t j = 0; j < TRANSPOSE_TILE; j += 4) {
+        for (size_t i = 0; i < TRANSPOSE_TILE; i += 4) {
+            const double* src = in + i + j * ldi;
+            const __m256d c0 = _mm256_loadu_pd(src);
+            const __m256d c1 = _mm256_loadu_pd(src + ldi);
+            const __m256d c2 = _mm256_loadu_pd(src + 2 * ldi);
+            const __m256d c3 = _mm256_loadu_pd(src + 3 * ldi);
+            const __m256d t0 = _mm256_unpacklo_pd(c0, c1);
+            const __m256d t1 = _mm256_unpackhi_pd(c0, c1);
+            const __m256d t2 = _mm256_unpacklo_pd(c2, c3);
+            const __m256d t3 = _mm256_unpackhi_pd(c2, c3);
+            double* dst = out + j + i * ldo;
+            _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+            _mm256_storeu_pd(dst + ldo, _mm256_permute2f128_pd(t1, t3, 0x20));
+            _mm256_storeu_pd(dst + 2 * ldo, _mm256_permute2f128_pd(t0, t2, 0x31));
+            _mm256_storeu_pd(dst + 3 * ldo, _mm256_permute2f128_pd(t1, t3, 0x31));
+        }
+    }
+}
+
+// Single precision: 16x6 tile, 12 ymm accumulators
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void microKernelAVX2F32(size_t kc, const float* ap, const float* bp, float* ab) {
+    __m256 c00 = _mm256_setzero_ps(), c10 = _mm256_setzero_ps();
+    __m256 c01 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c02 = _mm256_setzero_ps(), c12 = _mm256_setzero_ps();
+    __m256 c03 = _mm256_setzero_ps(), c13 = _mm256_setzero_ps();
+    __m256 c04 = _mm256_setzero_ps(), c14 = _mm256_setzero_ps();
+    __m256 c05 = _mm256_setzero_ps(), c15 = _mm256_setzero_ps();
+
+    for (size_t p = 0; p < kc; ++p) {
+        const __m256 a0 = _mm256_loadu_ps(ap);
+        const __m256 a1 = _mm256_loadu_ps(ap + 8);
+        __m256 b;
+        b = _mm256_broadcast_ss(bp + 0); c00 = _mm256_fmadd_ps(a0, b, c00); c10 = _mm256_fmadd_ps(a1, b, c10);
+        b = _mm256_broadcast_ss(bp + 1); c01 = _mm256_fmadd_ps(a0, b, c01); c11 = _mm256_fmadd_ps(a1, b, c11);
+        b = _mm256_broadcast_ss(bp + 2); c02 = _mm256_fmadd_ps(a0, b, c02); c12 = _mm256_fmadd_ps(a1, b, c12);
+        b = _mm256_broadcast_ss(bp + 3); c03 = _mm256_fmadd_ps(a0, b, c03); c13 = _mm256_fmadd_ps(a1, b, c13);
+        b = _mm256_broadcast_ss(bp + 4); c04 = _mm256_fmadd_ps(a0, b, c04); c14 = _mm256_fmadd_ps(a1, b, c14);
+        b = _mm256_broadcast_ss(bp + 5); c05 = _mm256_fmadd_ps(a0, b, c05); c15 = _mm256_fmadd_ps(a1, b, c15);
+        ap += 16;
+        bp += 6;
+    }
+
+    _mm256_storeu_ps(ab + 0, c00);  _mm256_storeu_ps(ab + 8, c10);
+    _mm256_storeu_ps(ab + 16, c01); _mm256_storeu_ps(ab + 24, c11);
+    _mm256_storeu_ps(ab + 32, c02); _mm256_storeu_ps(ab + 40, c12);
+    _mm256_storeu_ps(ab + 48, c03); _mm256_storeu_ps(ab + 56, c13);
+    _mm256_storeu_ps(ab + 64, c04); _mm256_storeu_ps(ab + 72, c14);
+    _mm256_storeu_ps(ab + 80, c05); _mm256_storeu_ps(ab + 88, c15);
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void addAVX2F32(size_t n, const float* x, const float* y, float* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    for (; i < n; ++i) out[i] = x[i] + y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void subtractAVX2F32(size_t n, const float* x, const float* y, float* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    for (; i < n; ++i) out[i] = x[i] - y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx2,fma")
+inline void scaleAVX2F32(size_t n, const float* x, float factor, float* out) {
+    const __m256 f = _mm256_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), f));
+    for (; i < n; ++i) out[i] = x[i] * factor;
+}
+
+// --- AVX-512 variant: 16x12 tile, 24 zmm accumulators -----------------------
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline void microKernelAVX512(size_t kc, const double* ap, const double* bp, double* ab) {
+    constexpr size_t NR = 12;
+    __m512d c0[NR], c1[NR];
+#pragma GCC unroll 12
+    for (size_t j = 0; j < NR; ++j) {
+        c0[j] = _mm512_setzero_pd();
+        c1[j] = _mm512_setzero_pd();
+    }
+
+    for (size_t p = 0; p < kc; ++p) {
+        const __m512d a0 = _mm512_loadu_pd(ap);
+        const __m512d a1 = _mm512_loadu_pd(ap + 8);
+#pragma GCC unroll 12
+        for (size_t j = 0; j < NR; ++j) {
+            const __m512d b = _mm512_set1_pd(bp[j]);
+            c0[j] = _mm512_fmadd_pd(a0, b, c0[j]);
+            c1[j] = _mm512_fmadd_pd(a1, b, c1[j]);
+        }
+        ap += 16;
+        bp += NR;
+    }
+
+#pragma GCC unroll 12
+    for (size_t j = 0; j < NR; ++j) {
+        _mm512_storeu_pd(ab + j * 16, c0[j]);
+        _mm512_storeu_pd(ab + j * 16 + 8, c1[j]);
+    }
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline void addAVX512(size_t n, const double* x, const double* y, double* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    for (; i < n; ++i) out[i] = x[i] + y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline void subtractAVX512(size_t n, const double* x, const double* y, double* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    for (; i < n; ++i) out[i] = x[i] - y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline void scaleAVX512(size_t n, const double* x, double factor, double* out) {
+    const __m512d f = _mm512_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), f));
+    for (; i < n; ++i) out[i] = x[i] * factor;
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline double horizontalSumAVX512(__m512d v) {
+    double lanes[8];
+    _mm512_storeu_pd(lanes, v);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline double dotAVX512(size_t n, const double* x, const double* y) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), s0);
+        s1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), s1);
+        s2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), s3);
+    }
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), s0);
+    }
+    double result = horizontalSumAVX512(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    for (; i < n; ++i) result += x[i] * y[i];
+    return result;
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline double sumOfSquaresAVX512(size_t n, const double* x) {
+    return dotAVX512(n, x, x);
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline double sumAVX512(size_t n, const double* x) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        s0 = _mm512_add_pd(s0, _mm512_loadu_pd(x + i));
+        s1 = _mm512_add_pd(s1, _mm512_loadu_pd(x + i + 8));
+        s2 = _mm512_add_pd(s2, _mm512_loadu_pd(x + i + 16));
+        s3 = _mm512_add_pd(s3, _mm512_loadu_pd(x + i + 24));
+    }
+    for (; i + 8 <= n; i += 8) s0 = _mm512_add_pd(s0, _mm512_loadu_pd(x + i));
+    double result = horizontalSumAVX512(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    for (; i < n; ++i) result += x[i];
+    return result;
+}
+
+// Whole tile in registers: three rounds of two-source permutes that
+// interleave 1, 2 and then 4 elements (vpermt2pd rather than unpack /
+// shuf_f64x2, whose GCC wrappers trip -Wuninitialized)
+MATRIX_KERNELS_TARGET("avx512f")
+inline void transposeTileAVX512(const double* in, size_t ldi, double* out, size_t ldo) {
+    const __m512i pairLo = _mm512_set_epi64(14, 6, 12, 4, 10, 2, 8, 0);
+    const __m512i pairHi = _mm512_set_epi64(15, 7, 13, 5, 11, 3, 9, 1);
+    const __m512i quadLo = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+    const __m512i quadHi = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+    const __m512i halfLo = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+    const __m512i halfHi = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+
+    __m512d c[8], t[8];
+#pragma GCC unroll 8
+    for (size_t j = 0; j < 8; ++j) c[j] = _mm512_loadu_pd(in + j * ldi);
+    // t[2k], t[2k + 1]: even / odd rows of columns 2k and 2k + 1
+#pragma GCC unroll 4
+    for (size_t j = 0; j < 8; j += 2) {
+        t[j] = _mm512_permutex2var_pd(c[j], pairLo, c[j + 1]);
+        t[j + 1] = _mm512_permutex2var_pd(c[j], pairHi, c[j + 1]);
+    }
+    // c[0..3]: rows {0,4}, {2,6}, {1,5}, {3,7} of columns 0-3; c[4..7] likewise for columns 4-7
+#pragma GCC unroll 2
+    for (size_t h = 0; h < 8; h += 4) {
+        c[h] = _mm512_permutex2var_pd(t[h], quadLo, t[h + 2]);
+        c[h + 1] = _mm512_permutex2var_pd(t[h], quadHi, t[h + 2]);
+        c[h + 2] = _mm512_permutex2var_pd(t[h + 1], quadLo, t[h + 3]);
+        c[h + 3] = _mm512_permutex2var_pd(t[h + 1], quadHi, t[h + 3]);
+    }
+    _mm512_storeu_pd(out, _mm512_permutex2var_pd(c[0], halfLo, c[4]));
+    _mm512_storeu_pd(out + ldo, _mm512_permutex2var_pd(c[2], halfLo, c[6]));
+    _mm512_storeu_pd(out + 2 * ldo, _mm512_permutex2var_pd(c[1], halfLo, c[5]));
+    _mm512_storeu_pd(out + 3 * ldo, _mm512_permutex2var_pd(c[3], halfLo, c[7]));
+    _mm512_storeu_pd(out + 4 * ldo, _mm512_permutex2var_pd(c[0], halfHi, c[4]));
+    _mm512_storeu_pd(out + 5 * ldo, _mm512_permutex2var_pd(c[2], halfHi, c[6]));
+    _mm512_storeu_pd(out + 6 * ldo, _mm512_permutex2var_pd(c[1], halfHi, c[5]));
+    _mm512_storeu_pd(out + 7 * ldo, _mm512_permutex2var_pd(c[3], halfHi, c[7]));
+}
+
+// Single precision: 32x12 tile, 24 zmm accumulators
+MATRIX_KERNELS_TARGET("avx512f")
+inline void microKernelAVX512F32(size_t kc, const float* ap, const float* bp, float* ab) {
+    constexpr size_t NR = 12;
+    __m512 c0[NR], c1[NR];
+#pragma GCC unroll 12
+    for (size_t j = 0; j < NR; ++j) {
+        c0[j] = _mm512_setzero_ps();
+        c1[j] = _mm512_setzero_ps();
+    }
+
+    for (size_t p = 0; p < kc; ++p) {
+        const __m512 a0 = _mm512_loadu_ps(ap);
+        const __m512 a1 = _mm512_loadu_ps(ap + 16);
+#pragma GCC unroll 12
+        for (size_t j = 0; j < NR; ++j) {
+            const __m512 b = _mm512_set1_ps(bp[j]);
+            c0[j] = _mm512_fmadd_ps(a0, b, c0[j]);
+            c1[j] = _mm512_fmadd_ps(a1, b, c1[j]);
+        }
+        ap += 32;
+        bp += NR;
+    }
+
+#pragma GCC unroll 12
+    for (size_t j = 0; j < NR; ++j) {
+        _mm512_storeu_ps(ab + j * 32, c0[j]);
+        _mm512_storeu_ps(ab + j * 32 + 16, c1[j]);
+    }
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline void addAVX512F32(size_t n, const float* x, const float* y, float* out) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    for (; i < n; ++i) out[i] = x[i] + y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline void subtractAVX512F32(size_t n, const float* x, const float* y, float* out) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_storeu_ps(out + i, _mm512_sub_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    for (; i < n; ++i) out[i] = x[i] - y[i];
+}
+
+MATRIX_KERNELS_TARGET("avx512f")
+inline void scaleAVX512F32(size_t n, const float* x, float factor, float* out) {
+    const __m512 f = _mm512_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), f));
+    for (; i < n; ++i) out[i] = x[i] * factor;
+}
+
+#endif // MATRIX_KERNELS_X86_DISPATCH
+
+// All variants compiled into this binary, best first
+inline const std::vector<KernelVariant>& compiledVariants() {
+    static const std::vector<KernelVariant> variants = {
+#ifdef MATRIX_KERNELS_X86_DISPATCH
+        {"avx512", 16, 12, microKernelAVX512, addAVX512, subtractAVX512, scaleAVX512,
+         dotAVX512, sumOfSquaresAVX512, sumAVX512, transposeTileAVX512,
+         32, 12, microKernelAVX512F32, addAVX512F32, subtractAVX512F32, scaleAVX512F32},
+        {"avx2", 8, 6, microKernelAVX2, addAVX2, subtractAVX2, scaleAVX2,
+         dotAVX2, sumOfSquaresAVX2, sumAVX2, transposeTileAVX2,
+         16, 6, microKernelAVX2F32, addAVX2F32, subtractAVX2F32, scaleAVX2F32},
+        {"sse4.2", 4, 4, microKernelSSE42, addSSE42, subtractSSE42, scaleSSE42,
+         dotSSE42, sumOfSquaresSSE42, sumSSE42, transposeTileSSE42,
+         8, 4, microKernelSSE42F32, addSSE42F32, subtractSSE42F32, scaleSSE42F32},
+#endif
+        {"generic", 8, 6, microKernelGeneric<double, 8>, addGeneric<double>, subtractGeneric<double>,
+         scaleGeneric<double>, dotGeneric, sumOfSquaresGeneric, sumGeneric, transposeTileGeneric<double>,
+         16, 6, microKernelGeneric<float, 16>, addGeneric<float>, subtractGeneric<float>, scaleGeneric<float>},
+    };
+    return variants;
+}
+
+inline bool cpuSupports(const std::string& name) {
+#ifdef MATRIX_KERNELS_X86_DISPATCH
+    __builtin_cpu_init();
+    if (name == "avx512") return __builtin_cpu_supports("avx512f");
+    if (name == "avx2") return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (name == "sse4.2") return __builtin_cpu_supports("sse4.2");
+#endif
+    return name == "generic";
+}
+
+inline const KernelVariant* findVariant(const std::string& name) {
+    for (const KernelVariant& variant : compiledVariants()) {
+        if (name == variant.name && cpuSupports(name)) return &variant;
+    }
+    return nullptr;
+}
+
+// Best supported variant, unless MATRIX_KERNEL_ISA names another supported one
+inline const KernelVariant* detectVariant() {
+    if (const char* requested = std::getenv("MATRIX_KERNEL_ISA")) {
+        if (const KernelVariant* variant = findVariant(requested)) return variant;
+    }
+    for (const KernelVariant& variant : compiledVariants()) {
+        if (cpuSupports(variant.name)) return &variant;
+    }
+    return &compiledVariants().back();
+}
+
+inline std::atomic<const KernelVariant*>& activeVariantSlot() {
+    static std::atomic<const KernelVariant*> slot{detectVariant()};
+    return slot;
+}
+
+} // namespace detail
+
+// Kernel set used by MatrixKernels, chosen once at startup
+inline const KernelVariant& activeKernels() {
+    return *detail::activeVariantSlot().load(std::memory_order_acquire);
+}
+
+// Names of the variants this CPU can run, best first
+inline std::vector<std::string> supportedKernelVariants() {
+    std::vector<std::string> names;
+    for (const KernelVariant& variant : detail::compiledVariants()) {
+        if (detail::cpuSupports(variant.name)) names.push_back(variant.name);
+    }
+    return names;
+}
+
+// Switch variants (e.g. to A/B them); returns false if unknown or unsupported
+inline bool setKernelVariant(const std::string& name) {
+    const KernelVariant* variant = detail::findVariant(name);
+    if (!variant) return false;
+    detail::activeVariantSlot().store(variant, std::memory_order_release);
+    return true;
+}
+
+} // namespace MatrixKernels
+
+#endif // MATRIXKERNELDISPATCH_HPP
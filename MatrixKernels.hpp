@@ -0,0 +1,1526 @@
+// MatrixKernels.hpp - Built-in dense kernels used when no vendor BLAS is linked
+#ifndef MATRIXKERNELS_HPP
+#define MATRIXKERNELS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "MatrixView.hpp"
+#include "MatrixThreadPool.hpp"
+#include "MatrixKernelDispatch.hpp"
+
+namespace MatrixKernels {
+
+// GEMM blocking parameters (BLIS-style loop nest).
+//  - mr x nr     : register tile computed by the microkernel of the active
+//                  KernelVariant (4x4 SSE4.2, 8x6 AVX2, 16x12 AVX-512;
+//                  twice the rows in single precision)
+//  - KC          : depth of a packed panel; an mr x KC sliver of A plus a
+//                  KC x nr sliver of B stay resident in L1
+//  - MC x KC     : packed block of A sized for L2
+//  - KC x NC     : packed block of B sized for L3
+// MC and NC are multiples of every variant's mr and nr.
+constexpr size_t GEMM_KC = 256;
+constexpr size_t GEMM_MC = 96;
+constexpr size_t GEMM_NC = 4080;
+
+// Active instruction-set variant and its GEMM register tile, e.g. "avx2 (GEMM 8x6)"
+inline std::string kernelVariantName() {
+    const KernelVariant& kernels = activeKernels();
+    return std::string(kernels.name) + " (GEMM " + std::to_string(kernels.mr) + "x" +
+           std::to_string(kernels.nr) + ")";
+}
+
+namespace detail {
+
+// Element (i, j) of op(X) for a column-major X with leading dimension ld
+template <typename Scalar>
+inline Scalar opElement(const Scalar* x, size_t ld, bool trans, size_t i, size_t j) {
+    return trans ? x[j + i * ld] : x[i + j * ld];
+}
+
+// Pack an mc x kc block of op(A) into mr-row panels: panel-major, then k, then row.
+// Rows past mc are zero-filled so the microkernel never needs edge handling.
+template <typename Scalar>
+inline void packA(size_t mc, size_t kc, const Scalar* a, size_t lda, bool transA,
+                  size_t i0, size_t p0, size_t mr, Scalar* packed) {
+    for (size_t ir = 0; ir < mc; ir += mr) {
+        const size_t rows = std::min(mr, mc - ir);
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t i = 0; i < rows; ++i) {
+                packed[i] = opElement(a, lda, transA, i0 + ir + i, p0 + p);
+            }
+            for (size_t i = rows; i < mr; ++i) packed[i] = Scalar(0);
+            packed += mr;
+        }
+    }
+}
+
+// Pack a kc x nc block of op(B) into nr-column panels: panel-major, then k, then column.
+template <typename Scalar>
+inline void packB(size_t kc, size_t nc, const Scalar* b, size_t ldb, bool transB,
+                  size_t p0, size_t j0, size_t nr, Scalar* packed) {
+    for (size_t jr = 0; jr < nc; jr += nr) {
+        const size_t cols = std::min(nr, nc - jr);
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t j = 0; j < cols; ++j) {
+                packed[j] = opElement(b, ldb, transB, p0 + p, j0 + jr + j);
+            }
+            for (size_t j = cols; j < nr; ++j) packed[j] = Scalar(0);
+            packed += nr;
+        }
+    }
+}
+
+// C(rows x cols) = alpha * ab + beta * C, where ab has leading dimension mr.
+// A beta of zero never reads C.
+template <typename Scalar>
+inline void storeTile(const Scalar* ab, size_t mr, size_t rows, size_t cols,
+                      Scalar alpha, Scalar beta, Scalar* c, size_t ldc) {
+    for (size_t j = 0; j < cols; ++j) {
+        Scalar* cj = c + j * ldc;
+        const Scalar* abj = ab + j * mr;
+        if (beta == Scalar(0)) {
+            for (size_t i = 0; i < rows; ++i) cj[i] = alpha * abj[i];
+        } else {
+            for (size_t i = 0; i < rows; ++i) cj[i] = alpha * abj[i] + beta * cj[i];
+        }
+    }
+}
+
+// Per-thread packing buffers (one pair per precision), reused across calls
+// to avoid reallocating
+template <typename Scalar>
+inline std::vector<Scalar>& packBufferA() {
+    thread_local std::vector<Scalar> buffer;
+    return buffer;
+}
+
+template <typename Scalar>
+inline std::vector<Scalar>& packBufferB() {
+    thread_local std::vector<Scalar> buffer;
+    return buffer;
+}
+
+// The active variant's GEMM register tile for one precision
+template <typename Scalar>
+struct MicroKernel {
+    size_t mr;
+    size_t nr;
+    void (*run)(size_t kc, const Scalar* ap, const Scalar* bp, Scalar* ab);
+};
+
+template <typename Scalar>
+MicroKernel<Scalar> microKernel(const KernelVariant& kernels);
+
+template <>
+inline MicroKernel<double> microKernel<double>(const KernelVariant& kernels) {
+    return {kernels.mr, kernels.nr, kernels.gemmMicroKernel};
+}
+
+template <>
+inline MicroKernel<float> microKernel<float>(const KernelVariant& kernels) {
+    return {kernels.mrF32, kernels.nrF32, kernels.gemmMicroKernelF32};
+}
+
+// Single-threaded blocked GEMM over the whole of C
+template <typename Scalar>
+inline void gemmSerial(const MicroKernel<Scalar>& tile,
+                       bool transA, bool transB, size_t m, size_t n, size_t k,
+                       Scalar alpha, const Scalar* a, size_t lda,
+                       const Scalar* b, size_t ldb,
+                       Scalar beta, Scalar* c, size_t ldc) {
+    if (m == 0 || n == 0) return;
+
+    if (k == 0 || alpha == Scalar(0)) {
+        for (size_t j = 0; j < n; ++j) {
+            Scalar* cj = c + j * ldc;
+            for (size_t i = 0; i < m; ++i) cj[i] = (beta == Scalar(0)) ? Scalar(0) : beta * cj[i];
+        }
+        return;
+    }
+
+    std::vector<Scalar>& bufA = packBufferA<Scalar>();
+    std::vector<Scalar>& bufB = packBufferB<Scalar>();
+    const size_t mr = tile.mr, nr = tile.nr;
+    const size_t kcMax = std::min(GEMM_KC, k);
+    const size_t mcMax = std::min(GEMM_MC, m + mr - 1) / mr * mr;
+    const size_t ncMax = std::min(GEMM_NC, n + nr - 1) / nr * nr;
+    if (bufA.size() < mcMax * kcMax) bufA.resize(mcMax * kcMax);
+    if (bufB.size() < kcMax * ncMax) bufB.resize(kcMax * ncMax);
+
+    Scalar ab[GEMM_MAX_MR * GEMM_MAX_NR];
+
+    for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+        const size_t nc = std::min(GEMM_NC, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+            const size_t kc = std::min(GEMM_KC, k - pc);
+            // Only the first rank-kc update applies beta; later ones accumulate
+            const Scalar betaBlock = (pc == 0) ? beta : Scalar(1);
+
+            packB(kc, nc, b, ldb, transB, pc, jc, nr, bufB.data());
+
+            for (size_t ic = 0; ic < m; ic += GEMM_MC) {
+                const size_t mc = std::min(GEMM_MC, m - ic);
+                packA(mc, kc, a, lda, transA, ic, pc, mr, bufA.data());
+
+                for (size_t jr = 0; jr < nc; jr += nr) {
+                    const size_t cols = std::min(nr, nc - jr);
+                    const Scalar* bp = bufB.data() + (jr / nr) * nr * kc;
+
+                    for (size_t ir = 0; ir < mc; ir += mr) {
+                        const size_t rows = std::min(mr, mc - ir);
+                        const Scalar* ap = bufA.data() + (ir / mr) * mr * kc;
+
+                        tile.run(kc, ap, bp, ab);
+                        storeTile(ab, mr, rows, cols, alpha, betaBlock,
+                                  c + (ic + ir) + (jc + jr) * ldc, ldc);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Large products are split into a grid of C tiles run on the thread pool;
+// each tile packs its own panels, so tiles are kept close to square to
+// limit repacking.
+template <typename Scalar>
+inline void gemmParallel(bool transA, bool transB, size_t m, size_t n, size_t k,
+                         Scalar alpha, const Scalar* a, size_t lda,
+                         const Scalar* b, size_t ldb,
+                         Scalar beta, Scalar* c, size_t ldc) {
+    const MicroKernel<Scalar> tile = microKernel<Scalar>(activeKernels());
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    if (m == 0 || n == 0 || k == 0 || alpha == Scalar(0) || !pool.shouldParallelize(m * n * k)) {
+        gemmSerial(tile, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+
+    const size_t mr = tile.mr, nr = tile.nr;
+    const double target = 2.0 * pool.getThreadCount();
+    const size_t maxTilesM = (m + mr - 1) / mr;
+    const size_t maxTilesN = (n + nr - 1) / nr;
+    size_t tilesM = static_cast<size_t>(std::lround(std::sqrt(target * m / n)));
+    tilesM = std::min(maxTilesM, std::max<size_t>(tilesM, 1));
+    size_t tilesN = static_cast<size_t>(std::ceil(target / tilesM));
+    tilesN = std::min(maxTilesN, std::max<size_t>(tilesN, 1));
+
+    const size_t tileM = ((m + tilesM - 1) / tilesM + mr - 1) / mr * mr;
+    const size_t tileN = ((n + tilesN - 1) / tilesN + nr - 1) / nr * nr;
+    tilesM = (m + tileM - 1) / tileM;
+    tilesN = (n + tileN - 1) / tileN;
+
+    pool.parallelFor(0, tilesM * tilesN, 1, [&](size_t lo, size_t hi) {
+        for (size_t t = lo; t < hi; ++t) {
+            const size_t i0 = (t % tilesM) * tileM;
+            const size_t j0 = (t / tilesM) * tileN;
+            const Scalar* aTile = transA ? a + i0 * lda : a + i0;
+            const Scalar* bTile = transB ? b + j0 : b + j0 * ldb;
+            gemmSerial(tile, transA, transB,
+                       std::min(tileM, m - i0), std::min(tileN, n - j0), k,
+                       alpha, aTile, lda, bTile, ldb,
+                       beta, c + i0 + j0 * ldc, ldc);
+        }
+    });
+}
+
+} // namespace detail
+
+// C = alpha * op(A) * op(B) + beta * C for column-major operands, where
+// op(A) is m x k, op(B) is k x n and C is m x n (BLAS dgemm semantics)
+inline void gemm(bool transA, bool transB, size_t m, size_t n, size_t k,
+                 double alpha, const double* a, size_t lda,
+                 const double* b, size_t ldb,
+                 double beta, double* c, size_t ldc) {
+    detail::gemmParallel(transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+// Single-precision GEMM (sgemm semantics), same blocking with the float tile
+inline void gemm(bool transA, bool transB, size_t m, size_t n, size_t k,
+                 float alpha, const float* a, size_t lda,
+                 const float* b, size_t ldb,
+                 float beta, float* c, size_t ldc) {
+    detail::gemmParallel(transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+// Element-wise kernels over contiguous arrays, split across the pool once
+// they exceed the serial cutoff
+
+inline void add(size_t count, const double* x, const double* y, double* out) {
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        kernels.add(hi - lo, x + lo, y + lo, out + lo);
+    });
+}
+
+inline void subtract(size_t count, const double* x, const double* y, double* out) {
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        kernels.subtract(hi - lo, x + lo, y + lo, out + lo);
+    });
+}
+
+inline void scale(size_t count, const double* x, double factor, double* out) {
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        kernels.scale(hi - lo, x + lo, factor, out + lo);
+    });
+}
+
+inline void add(size_t count, const float* x, const float* y, float* out) {
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        kernels.addF32(hi - lo, x + lo, y + lo, out + lo);
+    });
+}
+
+inline void subtract(size_t count, const float* x, const float* y, float* out) {
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        kernels.subtractF32(hi - lo, x + lo, y + lo, out + lo);
+    });
+}
+
+inline void scale(size_t count, const float* x, float factor, float* out) {
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        kernels.scaleF32(hi - lo, x + lo, factor, out + lo);
+    });
+}
+
+// Precision conversion: out[i] = x[i] widened to double or rounded to float
+template <typename From, typename To>
+inline void convert(size_t count, const From* x, To* out) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    pool.parallelFor(0, count, pool.getSerialCutoff(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) out[i] = static_cast<To>(x[i]);
+    });
+}
+
+namespace detail {
+
+// Reduce blockReduce(lo, hi) over fixed-size blocks, so the result does not
+// depend on how the pool happened to schedule the work
+template <typename BlockReduce>
+double blockedReduce(size_t count, BlockReduce blockReduce) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t parts = 4 * pool.getThreadCount();
+    const size_t blockSize = std::max(pool.getSerialCutoff(), (count + parts - 1) / parts);
+    const size_t blocks = (count + blockSize - 1) / blockSize;
+    if (blocks <= 1) return blockReduce(0, count);
+
+    std::vector<double> partial(blocks, 0.0);
+    pool.parallelFor(0, blocks, 1, [&](size_t lo, size_t hi) {
+        for (size_t blk = lo; blk < hi; ++blk) {
+            partial[blk] = blockReduce(blk * blockSize, std::min(count, (blk + 1) * blockSize));
+        }
+    });
+
+    double total = 0.0;
+    for (double value : partial) total += value;
+    return total;
+}
+
+} // namespace detail
+
+inline double dot(size_t count, const double* x, const double* y) {
+    const KernelVariant& kernels = activeKernels();
+    return detail::blockedReduce(count, [&](size_t lo, size_t hi) {
+        return kernels.dot(hi - lo, x + lo, y + lo);
+    });
+}
+
+inline double sumOfSquares(size_t count, const double* x) {
+    const KernelVariant& kernels = activeKernels();
+    return detail::blockedReduce(count, [&](size_t lo, size_t hi) {
+        return kernels.sumOfSquares(hi - lo, x + lo);
+    });
+}
+
+inline double sum(size_t count, const double* x) {
+    const KernelVariant& kernels = activeKernels();
+    return detail::blockedReduce(count, [&](size_t lo, size_t hi) {
+        return kernels.sum(hi - lo, x + lo);
+    });
+}
+
+// Single-precision data, accumulated in double so large norms keep their digits
+inline double dot(size_t count, const float* x, const float* y) {
+    return detail::blockedReduce(count, [&](size_t lo, size_t hi) {
+        double s0 = 0.0, s1 = 0.0;
+        size_t i = lo;
+        for (; i + 2 <= hi; i += 2) {
+            s0 += static_cast<double>(x[i]) * y[i];
+            s1 += static_cast<double>(x[i + 1]) * y[i + 1];
+        }
+        if (i < hi) s0 += static_cast<double>(x[i]) * y[i];
+        return s0 + s1;
+    });
+}
+
+inline double sumOfSquares(size_t count, const float* x) {
+    return dot(count, x, x);
+}
+
+// --- Transpose --------------------------------------------------------------
+// Out-of-place transposes split the matrix recursively until a block fits in
+// L1 (so every level of the cache hierarchy is used without tuning) and then
+// move 8x8 tiles through registers with the active variant's transposeTile.
+// In-place transposes swap tile pairs for square matrices and follow the
+// permutation cycles for rectangular ones.
+
+namespace detail {
+
+// Blocks at most this many rows and columns are transposed tile by tile
+constexpr size_t TRANSPOSE_LEAF = 64;
+
+// One 8x8 tile through registers: the active variant's kernel for double,
+// the portable loop for float
+inline void transposeTile(const KernelVariant& kernels, const double* in, size_t ldi, double* out, size_t ldo) {
+    kernels.transposeTile(in, ldi, out, ldo);
+}
+
+inline void transposeTile(const KernelVariant&, const float* in, size_t ldi, float* out, size_t ldo) {
+    transposeTileGeneric(in, ldi, out, ldo);
+}
+
+template <typename Scalar>
+inline void transposeLeaf(const KernelVariant& kernels, size_t rows, size_t cols,
+                          const Scalar* in, size_t ldi, Scalar* out, size_t ldo) {
+    constexpr size_t T = TRANSPOSE_TILE;
+    size_t j = 0;
+    for (; j + T <= cols; j += T) {
+        size_t i = 0;
+        for (; i + T <= rows; i += T) transposeTile(kernels, in + i + j * ldi, ldi, out + j + i * ldo, ldo);
+        for (; i < rows; ++i) {
+            for (size_t jj = j; jj < j + T; ++jj) out[jj + i * ldo] = in[i + jj * ldi];
+        }
+    }
+    for (; j < cols; ++j) {
+        for (size_t i = 0; i < rows; ++i) out[j + i * ldo] = in[i + j * ldi];
+    }
+}
+
+// Halve the longer side (at a tile boundary) until the block is a leaf
+template <typename Scalar>
+inline void transposeRecursive(const KernelVariant& kernels, size_t rows, size_t cols,
+                               const Scalar* in, size_t ldi, Scalar* out, size_t ldo) {
+    if (rows <= TRANSPOSE_LEAF && cols <= TRANSPOSE_LEAF) {
+        transposeLeaf(kernels, rows, cols, in, ldi, out, ldo);
+    } else if (rows >= cols) {
+        const size_t half = (rows / 2 + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE * TRANSPOSE_TILE;
+        transposeRecursive(kernels, half, cols, in, ldi, out, ldo);
+        transposeRecursive(kernels, rows - half, cols, in + half, ldi, out + half * ldo, ldo);
+    } else {
+        const size_t half = (cols / 2 + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE * TRANSPOSE_TILE;
+        transposeRecursive(kernels, rows, half, in, ldi, out, ldo);
+        transposeRecursive(kernels, rows, cols - half, in + half * ldi, ldi, out + half, ldo);
+    }
+}
+
+} // namespace detail
+
+// out (cols x rows, leading dimension ldo) = transpose of in (rows x cols, ldi).
+// The two buffers must not overlap.
+template <typename Scalar>
+inline void transpose(size_t rows, size_t cols, const Scalar* in, size_t ldi,
+                      Scalar* out, size_t ldo) {
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    // Parallelize over column strips of whole tiles; each strip recurses serially
+    const size_t strips = (cols + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    const size_t strip = TRANSPOSE_TILE * std::max<size_t>(rows, 1);
+    const size_t minStrips = std::max<size_t>(1, pool.getSerialCutoff() / strip);
+    pool.parallelFor(0, strips, minStrips, [&](size_t lo, size_t hi) {
+        const size_t c0 = lo * TRANSPOSE_TILE;
+        const size_t c1 = std::min(cols, hi * TRANSPOSE_TILE);
+        detail::transposeRecursive(kernels, rows, c1 - c0, in + c0 * ldi, ldi, out + c0, ldo);
+    });
+}
+
+// Transpose the n x n matrix a (leading dimension lda) in place. Tile (I, J)
+// and tile (J, I) are exchanged through one 8x8 register-tile buffer, so each
+// element is read and written once.
+template <typename Scalar>
+inline void transposeSquareInPlace(size_t n, Scalar* a, size_t lda) {
+    constexpr size_t T = TRANSPOSE_TILE;
+    const KernelVariant& kernels = activeKernels();
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t tiles = (n + T - 1) / T;
+    const size_t minTiles = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(T * n, 1));
+    // Tile column J owns tiles (I, J) and (J, I) for I <= J, so strips never overlap
+    pool.parallelFor(0, tiles, minTiles, [&](size_t lo, size_t hi) {
+        Scalar buffer[T * T];
+        for (size_t tj = lo; tj < hi; ++tj) {
+            const size_t j0 = tj * T, nc = std::min(T, n - j0);
+            for (size_t ti = 0; ti <= tj; ++ti) {
+                const size_t i0 = ti * T, nr = std::min(T, n - i0);
+                Scalar* upper = a + i0 + j0 * lda;
+                Scalar* lower = a + j0 + i0 * lda;
+                if (nr == T && nc == T) {
+                    detail::transposeTile(kernels, upper, lda, buffer, T);
+                    if (ti != tj) detail::transposeTile(kernels, lower, lda, upper, lda);
+                    Scalar* target = ti == tj ? upper : lower;
+                    for (size_t c = 0; c < T; ++c) {
+                        std::copy(buffer + c * T, buffer + (c + 1) * T, target + c * lda);
+                    }
+                    continue;
+                }
+                // Ragged edge tiles; a diagonal tile only swaps across its diagonal
+                for (size_t c = 0; c < nc; ++c) {
+                    const size_t rowEnd = ti == tj ? c : nr;
+                    for (size_t r = 0; r < rowEnd; ++r) std::swap(upper[r + c * lda], lower[c + r * lda]);
+                }
+            }
+        }
+    });
+}
+
+// Transpose the contiguous rows x cols matrix a (leading dimension rows) in
+// place, leaving a cols x rows matrix with leading dimension cols. Square
+// matrices use the tiled swap above; rectangular ones follow each cycle of
+// the permutation (i, j) -> (j, i) once, marking visited positions in a bit
+// set of rows * cols bits.
+template <typename Scalar>
+inline void transposeInPlace(size_t rows, size_t cols, Scalar* a) {
+    if (rows == cols) {
+        transposeSquareInPlace(rows, a, rows);
+        return;
+    }
+    // A vector has the same layout either way
+    if (rows <= 1 || cols <= 1) return;
+
+    const size_t count = rows * cols;
+    std::vector<bool> visited(count, false);
+    // The first and last elements never move
+    for (size_t start = 1; start + 1 < count; ++start) {
+        if (visited[start]) continue;
+        // Walk backwards along the cycle: position p receives the element
+        // that sits at (i, j) = (p / cols, p % cols) in the source layout
+        const Scalar first = a[start];
+        size_t p = start;
+        while (true) {
+            visited[p] = true;
+            const size_t source = (p % cols) * rows + p / cols;
+            if (source == start) break;
+            a[p] = a[source];
+            p = source;
+        }
+        a[p] = first;
+    }
+}
+
+// y = A * x for a column-major m x n matrix A (dgemv semantics, no transpose).
+// Rows are split across the pool; each block walks A column by column.
+template <typename Scalar>
+inline void gemv(size_t m, size_t n, const Scalar* a, size_t lda, const Scalar* x, Scalar* y) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minRows = std::max<size_t>(64, pool.getSerialCutoff() / std::max<size_t>(n, 1));
+    pool.parallelFor(0, m, minRows, [=](size_t lo, size_t hi) {
+        std::fill(y + lo, y + hi, Scalar(0));
+        for (size_t j = 0; j < n; ++j) {
+            const Scalar xj = x[j];
+            const Scalar* aj = a + j * lda;
+            for (size_t i = lo; i < hi; ++i) y[i] += aj[i] * xj;
+        }
+    });
+}
+
+// --- Strided views ----------------------------------------------------------
+// MatrixView entry points. Views with unit-stride rows or columns go straight
+// to the raw kernels above (as a transposed operand where needed); anything
+// else is gathered into a packed column-major copy first. Each entry point
+// has a double and a float overload over one shared template.
+
+namespace detail {
+
+// Run body(lo, hi) over the columns of a rows x cols region in parallel
+template <typename Body>
+void forEachColumnBlock(size_t rows, size_t cols, Body body) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(rows, 1));
+    pool.parallelFor(0, cols, minCols, body);
+}
+
+// A GEMM operand: column-major data with leading dimension and transpose
+// flag, backed by a packed copy when the view has no unit stride
+template <typename Scalar>
+struct GemmOperand {
+    const Scalar* data = nullptr;
+    size_t ld = 1;
+    bool trans = false;
+    std::vector<Scalar> packed;
+};
+
+// The active variant's serial scale kernel for each precision
+inline void scaleSerial(const KernelVariant& kernels, size_t n, const double* x, double factor, double* out) {
+    kernels.scale(n, x, factor, out);
+}
+
+inline void scaleSerial(const KernelVariant& kernels, size_t n, const float* x, float factor, float* out) {
+    kernels.scaleF32(n, x, factor, out);
+}
+
+template <typename From, typename To>
+inline void copyView(BasicMatrixView<const From> src, BasicMatrixView<To> dst) {
+    if (src.getRows() != dst.getRows() || src.getCols() != dst.getCols()) {
+        throw std::invalid_argument("Matrix view dimensions must match for copy");
+    }
+    const size_t rows = src.getRows(), cols = src.getCols();
+    if (rows == 0 || cols == 0) return;
+
+    if (src.isColumnMajor() && dst.isColumnMajor()) {
+        const size_t lds = src.columnMajorLd(), ldd = dst.columnMajorLd();
+        forEachColumnBlock(rows, cols, [=](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                std::copy(src.getData() + j * lds, src.getData() + j * lds + rows, dst.getData() + j * ldd);
+            }
+        });
+        return;
+    }
+    if constexpr (std::is_same<From, To>::value) {
+        if (src.isRowMajor() && dst.isColumnMajor()) {
+            // src is the transpose of a cols x rows column-major block
+            transpose(cols, rows, src.getData(), src.rowMajorLd(), dst.getData(), dst.columnMajorLd());
+            return;
+        }
+        if (src.isColumnMajor() && dst.isRowMajor()) {
+            transpose(rows, cols, src.getData(), src.columnMajorLd(), dst.getData(), dst.rowMajorLd());
+            return;
+        }
+    }
+    forEachColumnBlock(rows, cols, [=](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) {
+            for (size_t i = 0; i < rows; ++i) dst(i, j) = static_cast<To>(src(i, j));
+        }
+    });
+}
+
+template <typename Scalar>
+inline void fillView(BasicMatrixView<Scalar> dst, Scalar value) {
+    const size_t rows = dst.getRows();
+    forEachColumnBlock(rows, dst.getCols(), [=](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) {
+            for (size_t i = 0; i < rows; ++i) dst(i, j) = value;
+        }
+    });
+}
+
+template <typename Scalar>
+inline void scaleView(BasicMatrixView<Scalar> x, Scalar factor) {
+    const KernelVariant& kernels = activeKernels();
+    const size_t rows = x.getRows();
+    const bool unitRows = x.getRowStride() == 1;
+    forEachColumnBlock(rows, x.getCols(), [=, &kernels](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) {
+            if (unitRows) {
+                Scalar* col = &x(0, j);
+                scaleSerial(kernels, rows, col, factor, col);
+            } else {
+                for (size_t i = 0; i < rows; ++i) x(i, j) *= factor;
+            }
+        }
+    });
+}
+
+template <typename Scalar>
+inline void axpyView(Scalar alpha, BasicMatrixView<const Scalar> x, BasicMatrixView<Scalar> y) {
+    if (x.getRows() != y.getRows() || x.getCols() != y.getCols()) {
+        throw std::invalid_argument("Matrix view dimensions must match for accumulate");
+    }
+    const size_t rows = x.getRows();
+    forEachColumnBlock(rows, x.getCols(), [=](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) {
+            for (size_t i = 0; i < rows; ++i) y(i, j) += alpha * x(i, j);
+        }
+    });
+}
+
+template <typename Scalar>
+inline GemmOperand<Scalar> gemmOperand(BasicMatrixView<const Scalar> v) {
+    GemmOperand<Scalar> op;
+    if (v.isColumnMajor()) {
+        op.data = v.getData();
+        op.ld = v.columnMajorLd();
+    } else if (v.isRowMajor()) {
+        op.data = v.getData();
+        op.ld = v.rowMajorLd();
+        op.trans = true;
+    } else {
+        op.packed.resize(v.getRows() * v.getCols());
+        copyView(v, BasicMatrixView<Scalar>::columnMajor(op.packed.data(), v.getRows(), v.getCols(), v.getRows()));
+        op.data = op.packed.data();
+        op.ld = std::max<size_t>(v.getRows(), 1);
+    }
+    return op;
+}
+
+template <typename Scalar>
+inline void gemmView(Scalar alpha, BasicMatrixView<const Scalar> a, BasicMatrixView<const Scalar> b,
+                     Scalar beta, BasicMatrixView<Scalar> c) {
+    if (a.getCols() != b.getRows() || a.getRows() != c.getRows() || b.getCols() != c.getCols()) {
+        throw std::invalid_argument("Matrix view dimensions incompatible for multiplication");
+    }
+    if (!c.isColumnMajor()) {
+        if (c.isRowMajor()) {
+            // C^T = alpha * B^T A^T + beta * C^T, with C^T column-major
+            gemmView(alpha, b.transposed(), a.transposed(), beta, c.transposed());
+            return;
+        }
+        std::vector<Scalar> packed(c.getRows() * c.getCols());
+        BasicMatrixView<Scalar> tmp = BasicMatrixView<Scalar>::columnMajor(
+            packed.data(), c.getRows(), c.getCols(), std::max<size_t>(c.getRows(), 1));
+        if (beta != Scalar(0)) copyView<Scalar, Scalar>(c, tmp);
+        gemmView<Scalar>(alpha, a, b, beta, tmp);
+        copyView<Scalar, Scalar>(tmp, c);
+        return;
+    }
+
+    const GemmOperand<Scalar> opA = gemmOperand(a);
+    const GemmOperand<Scalar> opB = gemmOperand(b);
+    gemm(opA.trans, opB.trans, c.getRows(), c.getCols(), a.getCols(),
+         alpha, opA.data, opA.ld, opB.data, opB.ld,
+         beta, c.getData(), c.columnMajorLd());
+}
+
+template <typename Scalar>
+inline void gemvView(BasicMatrixView<const Scalar> a, const Scalar* x, Scalar* y) {
+    const size_t m = a.getRows(), n = a.getCols();
+    if (a.isColumnMajor()) {
+        gemv(m, n, a.getData(), a.columnMajorLd(), x, y);
+        return;
+    }
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minRows = std::max<size_t>(64, pool.getSerialCutoff() / std::max<size_t>(n, 1));
+    pool.parallelFor(0, m, minRows, [=](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            Scalar sum = Scalar(0);
+            for (size_t j = 0; j < n; ++j) sum += a(i, j) * x[j];
+            y[i] = sum;
+        }
+    });
+}
+
+} // namespace detail
+
+// dst = src (same shape; any strides)
+inline void copy(ConstMatrixView src, MatrixView dst) { detail::copyView(src, dst); }
+inline void copy(ConstMatrixViewF32 src, MatrixViewF32 dst) { detail::copyView(src, dst); }
+
+// dst = src converted to the other precision (same shape; any strides)
+inline void convert(ConstMatrixView src, MatrixViewF32 dst) { detail::copyView(src, dst); }
+inline void convert(ConstMatrixViewF32 src, MatrixView dst) { detail::copyView(src, dst); }
+
+inline void fill(MatrixView dst, double value) { detail::fillView(dst, value); }
+inline void fill(MatrixViewF32 dst, float value) { detail::fillView(dst, value); }
+
+// x = factor * x
+inline void scale(MatrixView x, double factor) { detail::scaleView(x, factor); }
+inline void scale(MatrixViewF32 x, float factor) { detail::scaleView(x, factor); }
+
+// y = y + alpha * x (same shape)
+inline void axpy(double alpha, ConstMatrixView x, MatrixView y) { detail::axpyView(alpha, x, y); }
+inline void axpy(float alpha, ConstMatrixViewF32 x, MatrixViewF32 y) { detail::axpyView(alpha, x, y); }
+
+// C = alpha * A * B + beta * C on views (dgemm / sgemm semantics). Transposed
+// views cost nothing; C may be any view, including a row-major one.
+inline void gemm(double alpha, ConstMatrixView a, ConstMatrixView b, double beta, MatrixView c) {
+    detail::gemmView(alpha, a, b, beta, c);
+}
+
+inline void gemm(float alpha, ConstMatrixViewF32 a, ConstMatrixViewF32 b, float beta, MatrixViewF32 c) {
+    detail::gemmView(alpha, a, b, beta, c);
+}
+
+// y = A * x for a view A
+inline void gemv(ConstMatrixView a, const double* x, double* y) { detail::gemvView(a, x, y); }
+inline void gemv(ConstMatrixViewF32 a, const float* x, float* y) { detail::gemvView(a, x, y); }
+
+// --- LU factorization with partial pivoting --------------------------------
+// Built-in replacement for dgetrf / dgetrs (sgetrf / sgetrs for float) used
+// when LAPACK is not linked.
+// Pivots follow LAPACK's convention: 1-based, row i was swapped with row
+// pivots[i] - 1.
+
+constexpr size_t LU_BLOCK = 64;
+
+namespace detail {
+
+// Unblocked LU of an m x nb panel (m >= nb), pivots relative to the panel's
+// first row. Returns the 1-based column of the first exactly-zero pivot, or 0.
+template <typename Scalar>
+inline int luPanelUnblocked(size_t m, size_t nb, Scalar* a, size_t lda, int* pivots) {
+    int info = 0;
+    for (size_t j = 0; j < nb; ++j) {
+        Scalar* colj = a + j * lda;
+
+        size_t p = j;
+        Scalar maxAbs = std::abs(colj[j]);
+        for (size_t i = j + 1; i < m; ++i) {
+            if (std::abs(colj[i]) > maxAbs) {
+                maxAbs = std::abs(colj[i]);
+                p = i;
+            }
+        }
+        pivots[j] = static_cast<int>(p + 1);
+
+        if (colj[p] == 0.0) {
+            if (info == 0) info = static_cast<int>(j + 1);
+            continue;
+        }
+        if (p != j) {
+            for (size_t c = 0; c < nb; ++c) std::swap(a[j + c * lda], a[p + c * lda]);
+        }
+
+        const Scalar inv = Scalar(1) / colj[j];
+        for (size_t i = j + 1; i < m; ++i) colj[i] *= inv;
+
+        for (size_t c = j + 1; c < nb; ++c) {
+            Scalar* colc = a + c * lda;
+            const Scalar u = colc[j];
+            if (u == 0.0) continue;
+            for (size_t i = j + 1; i < m; ++i) colc[i] -= colj[i] * u;
+        }
+    }
+    return info;
+}
+
+// Apply the row interchanges pivots[k0..k1) to columns [c0, c1)
+template <typename Scalar>
+inline void applyRowSwaps(Scalar* a, size_t lda, size_t c0, size_t c1,
+                          const int* pivots, size_t k0, size_t k1) {
+    if (c0 >= c1) return;
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(k1 - k0, 1));
+    pool.parallelFor(c0, c1, minCols, [=](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            Scalar* col = a + c * lda;
+            for (size_t j = k0; j < k1; ++j) {
+                const size_t p = static_cast<size_t>(pivots[j] - 1);
+                if (p != j) std::swap(col[j], col[p]);
+            }
+        }
+    });
+}
+
+// Panels narrower than this are factored by the unblocked column loop
+constexpr size_t LU_PANEL_LEAF = 16;
+
+template <typename Scalar>
+inline void trsmLower(size_t n, size_t nrhs, const Scalar* l, size_t ldl, bool unit, Scalar* b, size_t ldb);
+
+// LU of an m x nb panel by recursive halving (as LAPACK's dgetrf2): factor
+// the left half, update the right half with a triangular solve and a GEMM,
+// then factor what remains of it. The column-at-a-time loop only ever sees
+// LU_PANEL_LEAF columns, so the tall panel is streamed from memory a few
+// times instead of once per column.
+template <typename Scalar>
+inline int luPanel(size_t m, size_t nb, Scalar* a, size_t lda, int* pivots) {
+    if (nb <= LU_PANEL_LEAF) return luPanelUnblocked(m, nb, a, lda, pivots);
+
+    const size_t n1 = nb / 2, n2 = nb - n1;
+    int info = luPanel(m, n1, a, lda, pivots);
+    applyRowSwaps(a, lda, n1, nb, pivots, 0, n1);
+
+    Scalar* a12 = a + n1 * lda;
+    trsmLower(n1, n2, a, lda, true, a12, lda);
+    gemm(false, false, m - n1, n2, n1, -1.0, a + n1, lda, a12, lda, 1.0, a12 + n1, lda);
+
+    const int rightInfo = luPanel(m - n1, n2, a12 + n1, lda, pivots + n1);
+    if (rightInfo != 0 && info == 0) info = rightInfo + static_cast<int>(n1);
+    for (size_t j = n1; j < nb; ++j) pivots[j] += static_cast<int>(n1);
+    applyRowSwaps(a, lda, 0, n1, pivots, n1, nb);
+    return info;
+}
+
+// Triangular solves on B (n x nrhs), in place, parallel over the columns of B.
+// 'unit' treats the diagonal of L as ones (the L factor of luFactor).
+// With several right-hand sides and n above LU_BLOCK they run dtrsm-style:
+// each LU_BLOCK-row diagonal block is solved by the column loop and folded
+// into the remaining rows with one GEMM, so the bulk of the work is level 3.
+
+constexpr size_t TRSM_BLOCKED_MIN_RHS = 4;
+
+inline bool useBlockedTrsm(size_t n, size_t nrhs) {
+    return n > LU_BLOCK && nrhs >= TRSM_BLOCKED_MIN_RHS;
+}
+
+// B = L^-1 B for a lower triangular n x n L
+template <typename Scalar>
+inline void trsmLower(size_t n, size_t nrhs, const Scalar* l, size_t ldl, bool unit,
+                      Scalar* b, size_t ldb) {
+    if (useBlockedTrsm(n, nrhs)) {
+        for (size_t k = 0; k < n; k += LU_BLOCK) {
+            const size_t nb = std::min(LU_BLOCK, n - k);
+            trsmLower(nb, nrhs, l + k + k * ldl, ldl, unit, b + k, ldb);
+            if (k + nb < n) {
+                gemm(false, false, n - k - nb, nrhs, nb,
+                     -1.0, l + (k + nb) + k * ldl, ldl, b + k, ldb,
+                     1.0, b + k + nb, ldb);
+            }
+        }
+        return;
+    }
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(n * n / 2, 1));
+    pool.parallelFor(0, nrhs, minCols, [=](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            Scalar* x = b + c * ldb;
+            for (size_t j = 0; j < n; ++j) {
+                const Scalar* lj = l + j * ldl;
+                if (!unit) x[j] /= lj[j];
+                const Scalar xj = x[j];
+                if (xj == 0.0) continue;
+                for (size_t i = j + 1; i < n; ++i) x[i] -= lj[i] * xj;
+            }
+        }
+    });
+}
+
+// B = L^-T B for a lower triangular n x n L
+template <typename Scalar>
+inline void trsmLowerTransposed(size_t n, size_t nrhs, const Scalar* l, size_t ldl, bool unit,
+                                Scalar* b, size_t ldb) {
+    if (useBlockedTrsm(n, nrhs)) {
+        for (size_t end = n; end > 0;) {
+            const size_t k = end > LU_BLOCK ? end - LU_BLOCK : 0;
+            if (end < n) {
+                gemm(true, false, end - k, nrhs, n - end,
+                     -1.0, l + end + k * ldl, ldl, b + end, ldb,
+                     1.0, b + k, ldb);
+            }
+            trsmLowerTransposed(end - k, nrhs, l + k + k * ldl, ldl, unit, b + k, ldb);
+            end = k;
+        }
+        return;
+    }
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(n * n / 2, 1));
+    pool.parallelFor(0, nrhs, minCols, [=](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            Scalar* x = b + c * ldb;
+            for (size_t j = n; j-- > 0;) {
+                const Scalar* lj = l + j * ldl;
+                Scalar sum = x[j];
+                for (size_t i = j + 1; i < n; ++i) sum -= lj[i] * x[i];
+                x[j] = unit ? sum : sum / lj[j];
+            }
+        }
+    });
+}
+
+// B = U^-1 B for a non-unit upper triangular n x n U
+template <typename Scalar>
+inline void trsmUpper(size_t n, size_t nrhs, const Scalar* u, size_t ldu, Scalar* b, size_t ldb) {
+    if (useBlockedTrsm(n, nrhs)) {
+        for (size_t end = n; end > 0;) {
+            const size_t k = end > LU_BLOCK ? end - LU_BLOCK : 0;
+            trsmUpper(end - k, nrhs, u + k + k * ldu, ldu, b + k, ldb);
+            if (k > 0) {
+                gemm(false, false, k, nrhs, end - k,
+                     -1.0, u + k * ldu, ldu, b + k, ldb,
+                     1.0, b, ldb);
+            }
+            end = k;
+        }
+        return;
+    }
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(n * n / 2, 1));
+    pool.parallelFor(0, nrhs, minCols, [=](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            Scalar* x = b + c * ldb;
+            for (size_t j = n; j-- > 0;) {
+                x[j] /= u[j + j * ldu];
+                const Scalar xj = x[j];
+                if (xj == 0.0) continue;
+                const Scalar* uj = u + j * ldu;
+                for (size_t i = 0; i < j; ++i) x[i] -= uj[i] * xj;
+            }
+        }
+    });
+}
+
+// B = U^-T B for a non-unit upper triangular n x n U
+template <typename Scalar>
+inline void trsmUpperTransposed(size_t n, size_t nrhs, const Scalar* u, size_t ldu,
+                                Scalar* b, size_t ldb) {
+    if (useBlockedTrsm(n, nrhs)) {
+        for (size_t k = 0; k < n; k += LU_BLOCK) {
+            const size_t nb = std::min(LU_BLOCK, n - k);
+            if (k > 0) {
+                gemm(true, false, nb, nrhs, k,
+                     -1.0, u + k * ldu, ldu, b, ldb,
+                     1.0, b + k, ldb);
+            }
+            trsmUpperTransposed(nb, nrhs, u + k + k * ldu, ldu, b + k, ldb);
+        }
+        return;
+    }
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(n * n / 2, 1));
+    pool.parallelFor(0, nrhs, minCols, [=](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            Scalar* x = b + c * ldb;
+            for (size_t j = 0; j < n; ++j) {
+                const Scalar* uj = u + j * ldu;
+                Scalar sum = x[j];
+                for (size_t i = 0; i < j; ++i) sum -= uj[i] * x[i];
+                x[j] = sum / uj[j];
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+// In-place LU factorization of an n x n column-major matrix (dgetrf
+// semantics). Right-looking and blocked: each LU_BLOCK-wide panel is
+// factored unblocked, then the trailing matrix is updated with a
+// triangular solve and a GEMM, so almost all flops run in the GEMM kernel.
+// Returns 0, or the 1-based index of the first exactly-zero pivot.
+template <typename Scalar>
+inline int luFactor(size_t n, Scalar* a, size_t lda, int* pivots) {
+    int info = 0;
+    for (size_t k = 0; k < n; k += LU_BLOCK) {
+        const size_t nb = std::min(LU_BLOCK, n - k);
+        Scalar* panel = a + k + k * lda;
+
+        const int panelInfo = detail::luPanel(n - k, nb, panel, lda, pivots + k);
+        if (panelInfo != 0 && info == 0) info = panelInfo + static_cast<int>(k);
+        for (size_t j = k; j < k + nb; ++j) pivots[j] += static_cast<int>(k);
+
+        detail::applyRowSwaps(a, lda, 0, k, pivots, k, k + nb);
+        detail::applyRowSwaps(a, lda, k + nb, n, pivots, k, k + nb);
+
+        const size_t rest = n - k - nb;
+        if (rest > 0) {
+            Scalar* u12 = a + k + (k + nb) * lda;
+            detail::trsmLower(nb, rest, panel, lda, true, u12, lda);
+            gemm(false, false, rest, rest, nb,
+                 -1.0, panel + nb, lda, u12, lda,
+                 1.0, u12 + nb, lda);
+        }
+    }
+    return info;
+}
+
+// Solve A X = B in place (B is n x nrhs) from the factors of luFactor (dgetrs semantics)
+template <typename Scalar>
+inline void luSolve(size_t n, size_t nrhs, const Scalar* lu, size_t lda, const int* pivots,
+                    Scalar* b, size_t ldb) {
+    detail::applyRowSwaps(b, ldb, 0, nrhs, pivots, 0, n);
+    detail::trsmLower(n, nrhs, lu, lda, true, b, ldb);
+    detail::trsmUpper(n, nrhs, lu, lda, b, ldb);
+}
+
+// Solve A^T X = B in place from the factors of luFactor (dgetrs with trans = 'T')
+template <typename Scalar>
+inline void luSolveTransposed(size_t n, size_t nrhs, const Scalar* lu, size_t lda, const int* pivots,
+                              Scalar* b, size_t ldb) {
+    detail::trsmUpperTransposed(n, nrhs, lu, lda, b, ldb);
+    detail::trsmLowerTransposed(n, nrhs, lu, lda, true, b, ldb);
+    for (size_t c = 0; c < nrhs; ++c) {
+        Scalar* x = b + c * ldb;
+        for (size_t j = n; j-- > 0;) {
+            const size_t p = static_cast<size_t>(pivots[j] - 1);
+            if (p != j) std::swap(x[j], x[p]);
+        }
+    }
+}
+
+// --- Cholesky factorization -------------------------------------------------
+// Built-in replacement for dpotrf / dpotrs (lower triangle, A = L L^T). Only
+// the lower triangle of A is referenced; the strict upper triangle of each
+// diagonal block is used as scratch.
+
+namespace detail {
+
+// Unblocked Cholesky of an nb x nb diagonal block. Returns the 1-based
+// column where the matrix stopped being positive definite, or 0.
+inline int choleskyBlock(size_t nb, double* a, size_t lda) {
+    for (size_t j = 0; j < nb; ++j) {
+        double* colj = a + j * lda;
+        double d = colj[j];
+        for (size_t k = 0; k < j; ++k) d -= a[j + k * lda] * a[j + k * lda];
+        if (!(d > 0.0)) return static_cast<int>(j + 1);
+        d = std::sqrt(d);
+        colj[j] = d;
+        for (size_t i = j + 1; i < nb; ++i) {
+            double sum = colj[i];
+            for (size_t k = 0; k < j; ++k) sum -= a[i + k * lda] * a[j + k * lda];
+            colj[i] = sum / d;
+        }
+    }
+    return 0;
+}
+
+} // namespace detail
+
+// In-place lower Cholesky factorization of an n x n column-major SPD matrix.
+// Right-looking and blocked like luFactor: diagonal block, panel solve
+// against L11^T, then a GEMM update of the trailing lower triangle one
+// LU_BLOCK-wide column block at a time.
+// Returns 0, or the 1-based column of the first non-positive pivot.
+inline int choleskyFactor(size_t n, double* a, size_t lda) {
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    for (size_t k = 0; k < n; k += LU_BLOCK) {
+        const size_t nb = std::min(LU_BLOCK, n - k);
+        double* a11 = a + k + k * lda;
+
+        const int info = detail::choleskyBlock(nb, a11, lda);
+        if (info != 0) return info + static_cast<int>(k);
+
+        const size_t rest = n - k - nb;
+        if (rest == 0) break;
+
+        // L21 = A21 * L11^-T, row blocks in parallel
+        double* a21 = a11 + nb;
+        const size_t minRows = std::max<size_t>(64, pool.getSerialCutoff() / (nb * nb));
+        pool.parallelFor(0, rest, minRows, [=](size_t lo, size_t hi) {
+            for (size_t j = 0; j < nb; ++j) {
+                double* colj = a21 + j * lda;
+                for (size_t p = 0; p < j; ++p) {
+                    const double l = a11[j + p * lda];
+                    const double* colp = a21 + p * lda;
+                    for (size_t i = lo; i < hi; ++i) colj[i] -= colp[i] * l;
+                }
+                const double inv = 1.0 / a11[j + j * lda];
+                for (size_t i = lo; i < hi; ++i) colj[i] *= inv;
+            }
+        });
+
+        // A22 -= L21 * L21^T, restricted to column blocks on or below the diagonal
+        for (size_t j = 0; j < rest; j += LU_BLOCK) {
+            const size_t jb = std::min(LU_BLOCK, rest - j);
+            gemm(false, true, rest - j, jb, nb,
+                 -1.0, a21 + j, lda, a21 + j, lda,
+                 1.0, a21 + j + (nb + j) * lda, lda);
+        }
+    }
+    return 0;
+}
+
+// Solve A X = B in place from the factor of choleskyFactor (dpotrs semantics)
+inline void choleskySolve(size_t n, size_t nrhs, const double* l, size_t lda, double* b, size_t ldb) {
+    detail::trsmLower(n, nrhs, l, lda, false, b, ldb);
+    detail::trsmLowerTransposed(n, nrhs, l, lda, false, b, ldb);
+}
+
+// --- Householder QR ---------------------------------------------------------
+// Built-in replacement for dgeqrf / dormqr. Same storage as LAPACK: R on and
+// above the diagonal, the essential part of each reflector v (v[0] = 1
+// implied) below it, and Q = H(0) H(1) ... H(k-1) with H(j) = I - tau[j] v v^T.
+
+namespace detail {
+
+// Apply H = I - tau v v^T (v[0] = 1 implied, v[1..m) at 'v') to columns
+// [c0, c1) of the m-row block at 'a', in parallel over columns
+inline void applyReflector(size_t m, const double* v, double tau,
+                           double* a, size_t lda, size_t c0, size_t c1) {
+    if (tau == 0.0 || c0 >= c1) return;
+    MatrixThreadPool& pool = MatrixThreadPool::instance();
+    const size_t minCols = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(m, 1));
+    pool.parallelFor(c0, c1, minCols, [=](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            double* col = a + c * lda;
+            double w = col[0];
+            for (size_t i = 1; i < m; ++i) w += v[i] * col[i];
+            w *= tau;
+            col[0] -= w;
+            for (size_t i = 1; i < m; ++i) col[i] -= v[i] * w;
+        }
+    });
+}
+
+} // namespace detail
+
+// In-place QR factorization of an m x n column-major matrix (dgeqrf
+// semantics, tau has min(m, n) entries). Reflectors follow dlarfg, so
+// tau is 0 exactly when a column is already reduced.
+inline void qrFactor(size_t m, size_t n, double* a, size_t lda, double* tau) {
+    const size_t k = std::min(m, n);
+    for (size_t j = 0; j < k; ++j) {
+        double* col = a + j + j * lda;
+        const size_t len = m - j;
+
+        double tailNorm = 0.0;
+        for (size_t i = 1; i < len; ++i) tailNorm = std::hypot(tailNorm, col[i]);
+
+        if (tailNorm == 0.0) {
+            tau[j] = 0.0;
+            continue;
+        }
+        const double alpha = col[0];
+        const double beta = -std::copysign(std::hypot(alpha, tailNorm), alpha);
+        tau[j] = (beta - alpha) / beta;
+        const double scale = 1.0 / (alpha - beta);
+        for (size_t i = 1; i < len; ++i) col[i] *= scale;
+        col[0] = beta;
+
+        detail::applyReflector(len, col, tau[j], col, lda, 1, n - j);
+    }
+}
+
+// B (m x nrhs) = Q^T B in place, using the first k reflectors from qrFactor
+// (dormqr with side = 'L', trans = 'T')
+inline void qrApplyQt(size_t m, size_t k, const double* a, size_t lda, const double* tau,
+                      size_t nrhs, double* b, size_t ldb) {
+    for (size_t j = 0; j < k; ++j) {
+        detail::applyReflector(m - j, a + j + j * lda, tau[j], b + j, ldb, 0, nrhs);
+    }
+}
+
+// B (m x nrhs) = Q B in place (dormqr with side = 'L', trans = 'N'); on
+// the first k columns of the identity this forms the thin Q (dorgqr)
+inline void qrApplyQ(size_t m, size_t k, const double* a, size_t lda, const double* tau,
+                     size_t nrhs, double* b, size_t ldb) {
+    for (size_t j = k; j-- > 0;) {
+        detail::applyReflector(m - j, a + j + j * lda, tau[j], b + j, ldb, 0, nrhs);
+    }
+}
+
+// --- Symmetric eigensolver ----------------------------------------------------
+// Built-in replacement for dsyev: Householder reduction to tridiagonal form
+// and the implicit QL algorithm with Wilkinson-style shifts (EISPACK tred2 /
+// tql2). Unblocked O(n^3); LAPACK's dsyevd is much faster when linked.
+
+namespace detail {
+
+// Reduce the symmetric matrix in 'v' (lower triangle referenced) to
+// tridiagonal form T = Q^T A Q. On return d holds the diagonal of T, e[i]
+// the entry coupling i - 1 and i (e[0] = 0), and v holds Q if accumulate is
+// set (otherwise it is left as scratch, saving about a third of the work).
+inline void tridiagonalize(size_t n, double* v, size_t ldv, double* d, double* e, bool accumulate) {
+    auto V = [=](size_t r, size_t c) -> double& { return v[r + c * ldv]; };
+    for (size_t j = 0; j < n; ++j) d[j] = V(n - 1, j);
+
+    for (size_t i = n - 1; i > 0; --i) {
+        double scale = 0.0, h = 0.0;
+        for (size_t k = 0; k < i; ++k) scale += std::abs(d[k]);
+        if (scale == 0.0) {
+            e[i] = d[i - 1];
+            for (size_t j = 0; j < i; ++j) {
+                d[j] = V(i - 1, j);
+                V(i, j) = 0.0;
+                V(j, i) = 0.0;
+            }
+        } else {
+            // Householder vector for row i, scaled to avoid under/overflow
+            for (size_t k = 0; k < i; ++k) {
+                d[k] /= scale;
+                h += d[k] * d[k];
+            }
+            double f = d[i - 1];
+            double g = f > 0 ? -std::sqrt(h) : std::sqrt(h);
+            e[i] = scale * g;
+            h -= f * g;
+            d[i - 1] = f - g;
+            for (size_t j = 0; j < i; ++j) e[j] = 0.0;
+
+            // Apply the similarity transformation to the remaining columns
+            for (size_t j = 0; j < i; ++j) {
+                f = d[j];
+                V(j, i) = f;
+                g = e[j] + V(j, j) * f;
+                for (size_t k = j + 1; k < i; ++k) {
+                    g += V(k, j) * d[k];
+                    e[k] += V(k, j) * f;
+                }
+                e[j] = g;
+            }
+            f = 0.0;
+            for (size_t j = 0; j < i; ++j) {
+                e[j] /= h;
+                f += e[j] * d[j];
+            }
+            const double hh = f / (h + h);
+            for (size_t j = 0; j < i; ++j) e[j] -= hh * d[j];
+            for (size_t j = 0; j < i; ++j) {
+                f = d[j];
+                g = e[j];
+                for (size_t k = j; k < i; ++k) V(k, j) -= f * e[k] + g * d[k];
+                d[j] = V(i - 1, j);
+                V(i, j) = 0.0;
+            }
+        }
+        d[i] = h;
+    }
+
+    if (!accumulate) {
+        for (size_t j = 0; j < n; ++j) d[j] = V(j, j);
+        e[0] = 0.0;
+        return;
+    }
+
+    // Accumulate the transformations into Q
+    for (size_t i = 0; i + 1 < n; ++i) {
+        V(n - 1, i) = V(i, i);
+        V(i, i) = 1.0;
+        const double h = d[i + 1];
+        if (h != 0.0) {
+            for (size_t k = 0; k <= i; ++k) d[k] = V(k, i + 1) / h;
+            for (size_t j = 0; j <= i; ++j) {
+                double g = 0.0;
+                for (size_t k = 0; k <= i; ++k) g += V(k, i + 1) * V(k, j);
+                for (size_t k = 0; k <= i; ++k) V(k, j) -= g * d[k];
+            }
+        }
+        for (size_t k = 0; k <= i; ++k) V(k, i + 1) = 0.0;
+    }
+    for (size_t j = 0; j < n; ++j) {
+        d[j] = V(n - 1, j);
+        V(n - 1, j) = 0.0;
+    }
+    if (n > 0) V(n - 1, n - 1) = 1.0;
+    e[0] = 0.0;
+}
+
+} // namespace detail
+
+// Eigen-decomposition of the symmetric tridiagonal matrix with diagonal d
+// and off-diagonal e (e[i] couples i and i + 1; e[n - 1] is scratch).
+// Eigenvalues overwrite d in ascending order. If z is given, its n columns
+// (z has zRows rows) are rotated along: pass the identity for the
+// eigenvectors of T, or Q from a tridiagonal reduction for those of A.
+// Returns 0, or the 1-based index of an eigenvalue that failed to converge.
+inline int tridiagonalEigen(size_t n, double* d, double* e, double* z, size_t zRows, size_t ldz) {
+    if (n == 0) return 0;
+    e[n - 1] = 0.0;
+    const double eps = std::numeric_limits<double>::epsilon();
+    const size_t maxSweeps = 30 * n;
+    double shift = 0.0, tst1 = 0.0;
+
+    for (size_t l = 0; l < n; ++l) {
+        // Find a negligible off-diagonal entry: T splits there
+        tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+        size_t m = l;
+        while (m < n - 1 && std::abs(e[m]) > eps * tst1) ++m;
+
+        size_t sweeps = 0;
+        while (m > l) {
+            if (++sweeps > maxSweeps) return static_cast<int>(l + 1);
+
+            // Implicit shift from the leading 2 x 2 block
+            double g = d[l];
+            double p = (d[l + 1] - g) / (2.0 * e[l]);
+            double r = std::hypot(p, 1.0);
+            if (p < 0) r = -r;
+            d[l] = e[l] / (p + r);
+            d[l + 1] = e[l] * (p + r);
+            const double dl1 = d[l + 1];
+            double h = g - d[l];
+            for (size_t i = l + 2; i < n; ++i) d[i] -= h;
+            shift += h;
+
+            // QL sweep of Givens rotations from m up to l
+            p = d[m];
+            double c = 1.0, c2 = 1.0, c3 = 1.0, s = 0.0, s2 = 0.0;
+            const double el1 = e[l + 1];
+            for (size_t i = m; i-- > l;) {
+                c3 = c2;
+                c2 = c;
+                s2 = s;
+                g = c * e[i];
+                h = c * p;
+                r = std::hypot(p, e[i]);
+                e[i + 1] = s * r;
+                s = e[i] / r;
+                c = p / r;
+                p = c * d[i] - s * g;
+                d[i + 1] = h + s * (c * g + s * d[i]);
+                if (z) {
+                    double* zi = z + i * ldz;
+                    double* zi1 = z + (i + 1) * ldz;
+                    for (size_t k = 0; k < zRows; ++k) {
+                        h = zi1[k];
+                        zi1[k] = s * zi[k] + c * h;
+                        zi[k] = c * zi[k] - s * h;
+                    }
+                }
+            }
+            p = -s * s2 * c3 * el1 * e[l] / dl1;
+            e[l] = s * p;
+            d[l] = c * p;
+
+            // Re-check where the deflated block ends
+            m = l;
+            while (m < n - 1 && std::abs(e[m]) > eps * tst1) ++m;
+        }
+        d[l] += shift;
+        e[l] = 0.0;
+    }
+
+    // Selection sort keeps the column swaps at O(n) vector moves
+    for (size_t i = 0; i + 1 < n; ++i) {
+        size_t k = i;
+        for (size_t j = i + 1; j < n; ++j) {
+            if (d[j] < d[k]) k = j;
+        }
+        if (k != i) {
+            std::swap(d[i], d[k]);
+            if (z) std::swap_ranges(z + i * ldz, z + i * ldz + zRows, z + k * ldz);
+        }
+    }
+    return 0;
+}
+
+// Eigenvalues (ascending, into w) of the n x n symmetric matrix in a; only
+// its lower triangle is read. With computeVectors the orthonormal
+// eigenvectors overwrite a as columns, otherwise a is destroyed and the QL
+// phase drops to O(n^2). Returns 0, or a positive value if the QL
+// iteration failed.
+inline int symmetricEigen(size_t n, double* a, size_t lda, double* w, bool computeVectors = true) {
+    if (n == 0) return 0;
+    std::vector<double> offDiagonal(n);
+    detail::tridiagonalize(n, a, lda, w, offDiagonal.data(), computeVectors);
+    // tridiagonalize couples (i - 1, i) through e[i]; tridiagonalEigen wants (i, i + 1)
+    std::rotate(offDiagonal.begin(), offDiagonal.begin() + 1, offDiagonal.end());
+    return tridiagonalEigen(n, w, offDiagonal.data(), computeVectors ? a : nullptr, n, lda);
+}
+
+// --- One-sided Jacobi SVD ----------------------------------------------------
+// Hestenes' method: plane rotations orthogonalize the columns of A, so
+// A V = U diag(s). Accurate to high relative precision and simple, but
+// O(m n^2) per sweep, so it is meant for the small dense problems left
+// over by the randomized and Krylov methods.
+
+// SVD of the m x n column-major matrix a (m >= n). On return a holds the
+// left singular vectors (columns for zero singular values stay zero), s
+// the singular values in descending order and v (n x n, may be nullptr)
+// the right singular vectors. Returns 0, or 1 if the sweeps did not
+// converge.
+inline int jacobiSvd(size_t m, size_t n, double* a, size_t lda, double* s, double* v, size_t ldv) {
+    if (m < n) throw std::invalid_argument("jacobiSvd needs rows >= cols");
+    if (v) {
+        for (size_t j = 0; j < n; ++j) {
+            std::fill(v + j * ldv, v + j * ldv + n, 0.0);
+            v[j + j * ldv] = 1.0;
+        }
+    }
+    const double eps = std::numeric_limits<double>::epsilon();
+    auto rotate = [](size_t len, double* x, double* y, double c, double sn) {
+        for (size_t i = 0; i < len; ++i) {
+            const double xi = x[i], yi = y[i];
+            x[i] = c * xi - sn * yi;
+            y[i] = sn * xi + c * yi;
+        }
+    };
+
+    int status = 1;
+    for (int sweep = 0; sweep < 60 && status != 0; ++sweep) {
+        status = 0;
+        for (size_t p = 0; p + 1 < n; ++p) {
+            for (size_t q = p + 1; q < n; ++q) {
+                double* ap = a + p * lda;
+                double* aq = a + q * lda;
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (size_t i = 0; i < m; ++i) {
+                    alpha += ap[i] * ap[i];
+                    beta += aq[i] * aq[i];
+                    gamma += ap[i] * aq[i];
+                }
+                if (gamma == 0.0 || std::abs(gamma) <= eps * std::sqrt(alpha * beta)) continue;
+                status = 1;
+                const double zeta = (beta - alpha) / (2.0 * gamma);
+                const double t = std::copysign(1.0, zeta) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                const double c = 1.0 / std::sqrt(1.0 + t * t);
+                rotate(m, ap, aq, c, c * t);
+                if (v) rotate(n, v + p * ldv, v + q * ldv, c, c * t);
+            }
+        }
+    }
+
+    for (size_t j = 0; j < n; ++j) s[j] = std::sqrt(sumOfSquares(m, a + j * lda));
+    for (size_t i = 0; i + 1 < n; ++i) {
+        size_t k = i;
+        for (size_t j = i + 1; j < n; ++j) {
+            if (s[j] > s[k]) k = j;
+        }
+        if (k != i) {
+            std::swap(s[i], s[k]);
+            std::swap_ranges(a + i * lda, a + i * lda + m, a + k * lda);
+            if (v) std::swap_ranges(v + i * ldv, v + i * ldv + n, v + k * ldv);
+        }
+    }
+    for (size_t j = 0; j < n; ++j) {
+        if (s[j] > 0.0) scale(m, a + j * lda, 1.0 / s[j], a + j * lda);
+    }
+    return status;
+}
+
+// --- Condition estimation ---------------------------------------------------
+
+// 1-norm (maximum absolute column sum) of an m x n column-major matrix
+inline double norm1(size_t m, size_t n, const double* a, size_t lda) {
+    double result = 0.0;
+    for (size_t j = 0; j < n; ++j) {
+        const double* col = a + j * lda;
+        double sum = 0.0;
+        for (size_t i = 0; i < m; ++i) sum += std::abs(col[i]);
+        result = std::max(result, sum);
+    }
+    return result;
+}
+
+// Estimate ||A^-1||_1 from a few solves with A and A^T (Hager's method as in
+// LAPACK's dlacon, plus Higham's alternating-sign vector to guard against
+// underestimates). Both callbacks overwrite their length-n argument in place.
+// Used for dgecon-style reciprocal condition numbers when LAPACK is absent.
+inline double inverseNorm1Estimate(size_t n,
+                                   const std::function<void(double*)>& solve,
+                                   const std::function<void(double*)>& solveTransposed) {
+    if (n == 0) return 0.0;
+
+    std::vector<double> x(n, 1.0 / static_cast<double>(n)), previous, z(n);
+    double estimate = 0.0;
+    for (int iteration = 0; iteration < 5; ++iteration) {
+        previous = x;
+        solve(x.data());
+        double sum = 0.0;
+        for (double v : x) sum += std::abs(v);
+        estimate = std::max(estimate, sum);
+
+        for (size_t i = 0; i < n; ++i) z[i] = x[i] >= 0.0 ? 1.0 : -1.0;
+        solveTransposed(z.data());
+
+        size_t j = 0;
+        double zx = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            if (std::abs(z[i]) > std::abs(z[j])) j = i;
+            zx += z[i] * previous[i];
+        }
+        if (iteration > 0 && std::abs(z[j]) <= zx) break;
+
+        std::fill(x.begin(), x.end(), 0.0);
+        x[j] = 1.0;
+    }
+
+    const double denominator = n > 1 ? static_cast<double>(n - 1) : 1.0;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = (i % 2 == 0 ? 1.0 : -1.0) * (1.0 + static_cast<double>(i) / denominator);
+    }
+    solve(x.data());
+    double sum = 0.0;
+    for (double v : x) sum += std::abs(v);
+    return std::max(estimate, 2.0 * sum / (3.0 * static_cast<double>(n)));
+}
+
+} // namespace MatrixKernels
+
+#endif // MATRIXKERNELS_HPP
@@ -0,0 +1,238 @@
+// MatrixThreadPool.hpp - Persistent work-stealing thread pool for matrix kernels
+#ifndef MATRIXTHREADPOOL_HPP
+#define MATRIXTHREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+// Each worker owns a deque of range tasks. Owners pop from the back, idle
+// workers steal from the front of other deques, and the submitting thread
+// helps drain the queues until its own batch completes. Nested parallelFor
+// calls from inside a task run inline, so kernels can be composed freely.
+class MatrixThreadPool {
+public:
+    using RangeFunction = std::function<void(size_t, size_t)>;
+
+    static MatrixThreadPool& instance() {
+        static MatrixThreadPool pool;
+        return pool;
+    }
+
+    ~MatrixThreadPool() { stopWorkers(); }
+
+    MatrixThreadPool(const MatrixThreadPool&) = delete;
+    MatrixThreadPool& operator=(const MatrixThreadPool&) = delete;
+
+    // Number of threads taking part in a parallel loop (workers + caller)
+    size_t getThreadCount() const { return workers.size() + 1; }
+
+    // Resize the pool; 0 selects std::thread::hardware_concurrency()
+    void setThreadCount(size_t count) {
+        if (count == 0) count = defaultThreadCount();
+        std::lock_guard<std::mutex> submitLock(submitMutex);
+        if (count == getThreadCount()) return;
+        stopWorkers();
+        startWorkers(count - 1);
+    }
+
+    // Work (element updates or multiply-adds) below which kernels stay serial
+    size_t getSerialCutoff() const { return serialCutoff.load(std::memory_order_relaxed); }
+    void setSerialCutoff(size_t work) { serialCutoff.store(std::max<size_t>(work, 1), std::memory_order_relaxed); }
+
+    // True when the estimated work is large enough to be worth distributing
+    bool shouldParallelize(size_t work) const {
+        return !workers.empty() && !insideWorker() && work >= getSerialCutoff();
+    }
+
+    // Run body(lo, hi) over [begin, end) split into chunks of at least minChunk
+    void parallelFor(size_t begin, size_t end, size_t minChunk, const RangeFunction& body) {
+        if (begin >= end) return;
+        const size_t total = end - begin;
+        minChunk = std::max<size_t>(minChunk, 1);
+
+        if (workers.empty() || insideWorker() || total <= minChunk) {
+            body(begin, end);
+            return;
+        }
+
+        std::lock_guard<std::mutex> submitLock(submitMutex);
+        const size_t threadCount = getThreadCount();
+
+        // Over-decompose so stealing can even out uneven chunks
+        const size_t maxChunks = threadCount * 4;
+        const size_t wanted = std::min(maxChunks, (total + minChunk - 1) / minChunk);
+        const size_t chunkSize = (total + wanted - 1) / wanted;
+        const size_t chunks = (total + chunkSize - 1) / chunkSize;
+
+        Batch batch;
+        batch.body = &body;
+        batch.remaining = chunks;
+        pending.fetch_add(chunks, std::memory_order_release);
+
+        size_t queueIndex = 0;
+        for (size_t lo = begin; lo < end; lo += chunkSize) {
+            Task task{&batch, lo, std::min(end, lo + chunkSize)};
+            WorkerQueue& queue = *queues[queueIndex];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(task);
+            }
+            queueIndex = (queueIndex + 1) % queues.size();
+        }
+        {
+            // A worker that saw pending == 0 is either asleep or still holds
+            // sleepMutex; taking it here makes sure the wakeup is not lost
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleepCondition.notify_all();
+
+        // The calling thread steals work until the queues drain, then waits
+        // for chunks still running on workers
+        Task task;
+        while (steal(queues.size(), task)) runTask(task);
+        {
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            batch.done.wait(lock, [&] { return batch.remaining == 0; });
+        }
+
+        if (batch.error) std::rethrow_exception(batch.error);
+    }
+
+private:
+    struct Batch {
+        const RangeFunction* body = nullptr;
+        size_t remaining = 0;  // guarded by mutex
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    struct Task {
+        Batch* batch = nullptr;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> serialCutoff{size_t(1) << 16};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::mutex submitMutex;
+
+    MatrixThreadPool() { startWorkers(defaultThreadCount() - 1); }
+
+    static size_t defaultThreadCount() {
+        const unsigned hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1;
+    }
+
+    static bool& insideWorkerFlag() {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    static bool insideWorker() { return insideWorkerFlag(); }
+
+    void startWorkers(size_t count) {
+        stopping.store(false);
+        queues.clear();
+        for (size_t i = 0; i < std::max<size_t>(count, 1); ++i) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < count; ++i) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping.store(true);
+        }
+        sleepCondition.notify_all();
+        for (std::thread& worker : workers) worker.join();
+        workers.clear();
+    }
+
+    bool popLocal(size_t index, Task& task) {
+        WorkerQueue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Take from the front of any queue other than 'self'
+    bool steal(size_t self, Task& task) {
+        const size_t count = queues.size();
+        for (size_t offset = 1; offset <= count; ++offset) {
+            const size_t victim = (self + offset) % count;
+            if (victim == self) continue;
+            WorkerQueue& queue = *queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void runTask(const Task& task) {
+        Batch& batch = *task.batch;
+        bool& inside = insideWorkerFlag();
+        const bool wasInside = inside;
+        inside = true;
+        std::exception_ptr error;
+        try {
+            (*batch.body)(task.begin, task.end);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        inside = wasInside;
+
+        // The batch lives on the submitter's stack: it may be destroyed as
+        // soon as this lock is released with remaining == 0
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (error && !batch.error) batch.error = error;
+        if (--batch.remaining == 0) batch.done.notify_all();
+    }
+
+    void workerLoop(size_t index) {
+        insideWorkerFlag() = true;
+        Task task;
+        while (true) {
+            if (popLocal(index, task) || steal(index, task)) {
+                runTask(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [&] {
+                return stopping.load() || pending.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping.load() && pending.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+};
+
+#endif // MATRIXTHREADPOOL_HPP
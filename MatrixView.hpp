@@ -0,0 +1,97 @@
+// MatrixView.hpp - Non-owning strided views into matrix storage
+#ifndef MATRIXVIEW_HPP
+#define MATRIXVIEW_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+// A rows x cols window onto someone else's buffer. Element (i, j) lives at
+// data[i * rowStride + j * colStride], so the same type describes a
+// column-major block (rowStride 1, colStride = leading dimension), its
+// transpose (strides swapped), a single row or a single column. Views never
+// allocate and never own: the underlying matrix must outlive them and must
+// not be reassigned to a different size while they exist.
+//
+// T is the (possibly const) scalar: double or float for a writable view,
+// const double or const float for a read-only one. A writable view converts
+// implicitly to the read-only view of the same precision.
+template <typename T>
+class BasicMatrixView {
+private:
+    T* data = nullptr;
+    size_t rows = 0, cols = 0;
+    size_t rowStride = 1, colStride = 0;
+
+public:
+    using value_type = std::remove_const_t<T>;
+
+    BasicMatrixView() = default;
+
+    BasicMatrixView(T* data, size_t rows, size_t cols, size_t rowStride, size_t colStride)
+        : data(data), rows(rows), cols(cols), rowStride(rowStride), colStride(colStride) {}
+
+    // Column-major block with leading dimension ld
+    static BasicMatrixView columnMajor(T* data, size_t rows, size_t cols, size_t ld) {
+        return BasicMatrixView(data, rows, cols, 1, ld);
+    }
+
+    // Writable view to read-only view
+    template <typename U, typename = std::enable_if_t<std::is_same<T, const U>::value>>
+    BasicMatrixView(const BasicMatrixView<U>& other)
+        : data(other.getData()), rows(other.getRows()), cols(other.getCols()),
+          rowStride(other.getRowStride()), colStride(other.getColStride()) {}
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t getRowStride() const { return rowStride; }
+    size_t getColStride() const { return colStride; }
+    T* getData() const { return data; }
+    bool empty() const { return rows == 0 || cols == 0; }
+
+    T& operator()(size_t r, size_t c) const { return data[r * rowStride + c * colStride]; }
+
+    value_type get(size_t r, size_t c) const {
+        if (r >= rows || c >= cols) throw std::out_of_range("Matrix view index out of range");
+        return (*this)(r, c);
+    }
+
+    template <typename U = T, typename = std::enable_if_t<!std::is_const<U>::value>>
+    void set(size_t r, size_t c, value_type value) const {
+        if (r >= rows || c >= cols) throw std::out_of_range("Matrix view index out of range");
+        (*this)(r, c) = value;
+    }
+
+    // Layout queries used by the kernels: element (i, j) sits at
+    // data[i + j * columnMajorLd()] when isColumnMajor(), and at
+    // data[i * rowMajorLd() + j] when isRowMajor(), i.e. the view can be
+    // passed to a column-major routine as-is or as a transposed operand.
+    bool isColumnMajor() const { return rowStride == 1 || rows <= 1; }
+    bool isRowMajor() const { return colStride == 1 || cols <= 1; }
+    bool isContiguous() const { return isColumnMajor() && (cols <= 1 || colStride == rows); }
+
+    size_t columnMajorLd() const { return cols > 1 ? colStride : (rows > 0 ? rows : 1); }
+    size_t rowMajorLd() const { return rows > 1 ? rowStride : (cols > 0 ? cols : 1); }
+
+    // Sub-views, all O(1)
+    BasicMatrixView block(size_t r0, size_t c0, size_t nr, size_t nc) const {
+        if (r0 + nr > rows || c0 + nc > cols) {
+            throw std::out_of_range("Matrix view block out of range");
+        }
+        return BasicMatrixView(data + r0 * rowStride + c0 * colStride, nr, nc, rowStride, colStride);
+    }
+
+    BasicMatrixView row(size_t r) const { return block(r, 0, 1, cols); }
+    BasicMatrixView column(size_t c) const { return block(0, c, rows, 1); }
+
+    BasicMatrixView transposed() const {
+        return BasicMatrixView(data, cols, rows, colStride, rowStride);
+    }
+};
+
+using MatrixView = BasicMatrixView<double>;
+using ConstMatrixView = BasicMatrixView<const double>;
+using MatrixViewF32 = BasicMatrixView<float>;
+using ConstMatrixViewF32 = BasicMatrixView<const float>;
+
+#endif // MATRIXVIEW_HPP
@@ -0,0 +1,465 @@
+// SparseMatrix.hpp - Compressed sparse row / column matrices with parallel SpMV
+#ifndef SPARSEMATRIX_HPP
+#define SPARSEMATRIX_HPP
+
+#include "AcceleratedMatrix.hpp"
+
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "MatrixThreadPool.hpp"
+
+// Sparse double matrix in compressed form. CSR keeps, for each row, the
+// column indices and values of its nonzeros (sorted by column); CSC is
+// the same by column. Storage is O(rows + nnz) and products cost O(nnz),
+// so discretizations with millions of unknowns fit where the dense
+// AcceleratedMatrix would need n^2 doubles.
+//
+// Built with SparseBuilder (coordinate triplets, duplicates summed) or
+// from a dense matrix. Indices are 32-bit to halve the index traffic of
+// SpMV; offsets are size_t, so nnz itself is unbounded. Products with a
+// vector or dense matrix run on MatrixThreadPool: gathers (CSR A x, CSC
+// A^T x) split the output rows; vector scatters (CSC A x, CSR A^T x) give
+// each thread a private accumulator and sum them afterwards, block
+// scatters give each thread its own columns.
+class SparseMatrix {
+public:
+    enum class Format { CSR, CSC };
+    using Index = std::uint32_t;
+
+private:
+    size_t rows = 0, cols = 0;
+    Format format = Format::CSR;
+    std::vector<size_t> offsets;  // outer dimension + 1 (rows for CSR, columns for CSC)
+    std::vector<Index> indices;   // inner index (column for CSR, row for CSC) per nonzero
+    std::vector<double> values;
+
+    size_t outerSize() const { return format == Format::CSR ? rows : cols; }
+    size_t innerSize() const { return format == Format::CSR ? cols : rows; }
+
+    friend class SparseBuilder;
+
+    SparseMatrix(size_t r, size_t c, Format f) : rows(r), cols(c), format(f), offsets(outerSize() + 1, 0) {
+        if (std::max(r, c) > std::numeric_limits<Index>::max()) {
+            throw std::invalid_argument("Sparse matrix dimension exceeds 32-bit index range");
+        }
+    }
+
+    // y = M x where M is the stored outer x inner matrix (a gather per outer index)
+    void gather(const double* x, double* y) const {
+        const size_t outer = outerSize();
+        if (outer == 0) return;
+        MatrixThreadPool& pool = MatrixThreadPool::instance();
+        const size_t averageRow = std::max<size_t>(1, values.size() / outer);
+        pool.parallelFor(0, outer, std::max<size_t>(1, pool.getSerialCutoff() / averageRow),
+                         [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                double sum = 0.0;
+                for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) sum += values[k] * x[indices[k]];
+                y[i] = sum;
+            }
+        });
+    }
+
+    // y = M^T x (a scatter per outer index); y has innerSize() entries
+    void scatter(const double* x, double* y) const {
+        const size_t outer = outerSize(), inner = innerSize();
+        std::fill(y, y + inner, 0.0);
+        if (outer == 0 || inner == 0) return;
+
+        auto scatterRange = [&](size_t lo, size_t hi, double* out) {
+            for (size_t i = lo; i < hi; ++i) {
+                const double xi = x[i];
+                if (xi == 0.0) continue;
+                for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) out[indices[k]] += values[k] * xi;
+            }
+        };
+
+        MatrixThreadPool& pool = MatrixThreadPool::instance();
+        const size_t parts = std::min(pool.getThreadCount(), outer);
+        // Private accumulators only pay off when each holds much less than the work
+        if (!pool.shouldParallelize(values.size()) || parts < 2 || values.size() < parts * inner) {
+            scatterRange(0, outer, y);
+            return;
+        }
+
+        std::vector<double> partial(parts * inner, 0.0);
+        const size_t chunk = (outer + parts - 1) / parts;
+        pool.parallelFor(0, parts, 1, [&](size_t lo, size_t hi) {
+            for (size_t p = lo; p < hi; ++p) {
+                scatterRange(p * chunk, std::min(outer, (p + 1) * chunk), partial.data() + p * inner);
+            }
+        });
+        pool.parallelFor(0, inner, pool.getSerialCutoff() / parts, [&](size_t lo, size_t hi) {
+            for (size_t p = 0; p < parts; ++p) {
+                const double* part = partial.data() + p * inner;
+                for (size_t i = lo; i < hi; ++i) y[i] += part[i];
+            }
+        });
+    }
+
+    // Row-major view of a packed rows x cols buffer: row i of a block of
+    // vectors is contiguous, so each nonzero reads or updates one short run
+    static MatrixView rowMajor(double* data, size_t r, size_t c) { return MatrixView(data, r, c, c, 1); }
+
+    // C = M B, a gather per outer index. B is packed row-major once, so
+    // each nonzero combines one contiguous row of B instead of striding
+    // through every column; rows of C are independent.
+    void gatherBlock(ConstMatrixView b, MatrixView c) const {
+        const size_t outer = outerSize(), inner = innerSize(), n = b.getCols();
+        if (outer == 0 || n == 0) return;
+        std::vector<double> packed(inner * n);
+        MatrixKernels::copy(b, rowMajor(packed.data(), inner, n));
+
+        MatrixThreadPool& pool = MatrixThreadPool::instance();
+        const size_t workPerRow = std::max<size_t>(1, values.size() / outer * n);
+        pool.parallelFor(0, outer, std::max<size_t>(1, pool.getSerialCutoff() / workPerRow),
+                         [&](size_t lo, size_t hi) {
+            std::vector<double> sum(n);
+            for (size_t i = lo; i < hi; ++i) {
+                std::fill(sum.begin(), sum.end(), 0.0);
+                for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                    const double v = values[k];
+                    const double* bk = packed.data() + static_cast<size_t>(indices[k]) * n;
+                    for (size_t j = 0; j < n; ++j) sum[j] += v * bk[j];
+                }
+                for (size_t j = 0; j < n; ++j) c(i, j) = sum[j];
+            }
+        });
+    }
+
+    // C = M^T B, a scatter per outer index. Threads own ranges of columns
+    // and accumulate them row-major, so each nonzero updates one contiguous
+    // run, no accumulator is shared, and the nonzeros are walked once per
+    // range.
+    void scatterBlock(ConstMatrixView b, MatrixView c) const {
+        const size_t outer = outerSize(), inner = innerSize(), n = b.getCols();
+        if (n == 0) return;
+        MatrixThreadPool& pool = MatrixThreadPool::instance();
+        const size_t minColumns = std::max<size_t>(1, pool.getSerialCutoff() / std::max<size_t>(values.size(), 1));
+        pool.parallelFor(0, n, minColumns, [&](size_t lo, size_t hi) {
+            const size_t w = hi - lo;
+            std::vector<double> accumulated(inner * w, 0.0), bi(w);
+            for (size_t i = 0; i < outer; ++i) {
+                if (offsets[i] == offsets[i + 1]) continue;
+                for (size_t j = 0; j < w; ++j) bi[j] = b(i, lo + j);
+                for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                    const double v = values[k];
+                    double* ck = accumulated.data() + static_cast<size_t>(indices[k]) * w;
+                    for (size_t j = 0; j < w; ++j) ck[j] += v * bi[j];
+                }
+            }
+            MatrixKernels::copy(rowMajor(accumulated.data(), inner, w), c.block(0, lo, inner, w));
+        });
+    }
+
+    // The same matrix with the other compression (counting sort, O(nnz + n));
+    // visiting outer indices in order leaves each new segment sorted
+    SparseMatrix recompressed() const {
+        SparseMatrix result(rows, cols, format == Format::CSR ? Format::CSC : Format::CSR);
+        const size_t outer = outerSize(), inner = innerSize();
+        for (Index index : indices) ++result.offsets[index + 1];
+        for (size_t i = 0; i < inner; ++i) result.offsets[i + 1] += result.offsets[i];
+
+        result.indices.resize(indices.size());
+        result.values.resize(values.size());
+        std::vector<size_t> cursor(result.offsets.begin(), result.offsets.end() - 1);
+        for (size_t i = 0; i < outer; ++i) {
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                const size_t slot = cursor[indices[k]]++;
+                result.indices[slot] = static_cast<Index>(i);
+                result.values[slot] = values[k];
+            }
+        }
+        return result;
+    }
+
+public:
+    SparseMatrix() : offsets(1, 0) {}
+
+    // Zero matrix with no stored entries
+    SparseMatrix(size_t r, size_t c) : SparseMatrix(r, c, Format::CSR) {}
+
+    // Entries with |value| <= dropTolerance are not stored
+    static SparseMatrix fromDense(const AcceleratedMatrix& dense, double dropTolerance = 0.0,
+                                  Format format = Format::CSR) {
+        // Column-major storage yields CSC directly
+        SparseMatrix csc(dense.getRows(), dense.getCols(), Format::CSC);
+        const double* data = dense.getData();
+        const size_t ld = dense.getLeadingDimension();
+        for (size_t j = 0; j < csc.cols; ++j) {
+            for (size_t i = 0; i < csc.rows; ++i) {
+                const double v = data[i + j * ld];
+                if (std::abs(v) > dropTolerance) {
+                    csc.indices.push_back(static_cast<Index>(i));
+                    csc.values.push_back(v);
+                }
+            }
+            csc.offsets[j + 1] = csc.values.size();
+        }
+        return format == Format::CSC ? csc : csc.recompressed();
+    }
+
+    // 5-point Laplacian on a grid x grid mesh (grid^2 unknowns, row-major
+    // numbering), the standard sparse test problem. A nonzero convection
+    // term c gives the x-neighbours -1 - c and -1 + c, which makes it
+    // nonsymmetric.
+    static SparseMatrix laplacian2d(size_t grid, double convection = 0.0) {
+        const size_t n = grid * grid;
+        SparseMatrix csr(n, n, Format::CSR);
+        csr.indices.reserve(5 * n);
+        csr.values.reserve(5 * n);
+        auto add = [&csr](size_t c, double v) {
+            csr.indices.push_back(static_cast<Index>(c));
+            csr.values.push_back(v);
+        };
+        for (size_t i = 0; i < grid; ++i) {
+            for (size_t j = 0; j < grid; ++j) {
+                const size_t k = i * grid + j;
+                if (i > 0) add(k - grid, -1.0);
+                if (j > 0) add(k - 1, -1.0 - convection);
+                add(k, 4.0);
+                if (j + 1 < grid) add(k + 1, -1.0 + convection);
+                if (i + 1 < grid) add(k + grid, -1.0);
+                csr.offsets[k + 1] = csr.values.size();
+            }
+        }
+        return csr;
+    }
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t nonZeros() const { return values.size(); }
+    Format getFormat() const { return format; }
+
+    // Raw compressed arrays, for kernels and solvers
+    const std::vector<size_t>& getOffsets() const { return offsets; }
+    const std::vector<Index>& getIndices() const { return indices; }
+    const std::vector<double>& getValues() const { return values; }
+
+    // Fraction of entries stored
+    double density() const {
+        return rows == 0 || cols == 0 ? 0.0
+            : static_cast<double>(values.size()) / (static_cast<double>(rows) * static_cast<double>(cols));
+    }
+
+    // Element access by binary search within the segment; absent entries are zero
+    double get(size_t r, size_t c) const {
+        if (r >= rows || c >= cols) throw std::out_of_range("Matrix index out of range");
+        const size_t outer = format == Format::CSR ? r : c;
+        const Index inner = static_cast<Index>(format == Format::CSR ? c : r);
+        const auto begin = indices.begin() + offsets[outer], end = indices.begin() + offsets[outer + 1];
+        const auto it = std::lower_bound(begin, end, inner);
+        return it != end && *it == inner ? values[it - indices.begin()] : 0.0;
+    }
+
+    // Exact symmetry: CSR and CSC of a symmetric matrix are the same arrays
+    bool isSymmetric() const {
+        if (rows != cols) return false;
+        const SparseMatrix other = recompressed();
+        return other.offsets == offsets && other.indices == indices && other.values == values;
+    }
+
+    SparseMatrix toCSR() const { return format == Format::CSR ? *this : recompressed(); }
+    SparseMatrix toCSC() const { return format == Format::CSC ? *this : recompressed(); }
+
+    AcceleratedMatrix toDense() const {
+        AcceleratedMatrix result(rows, cols);
+        double* data = result.getData();
+        const size_t ld = result.getLeadingDimension();
+        const bool csr = format == Format::CSR;
+        for (size_t i = 0; i < outerSize(); ++i) {
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                const size_t r = csr ? i : indices[k], c = csr ? indices[k] : i;
+                data[r + c * ld] = values[k];
+            }
+        }
+        return result;
+    }
+
+    // A^T in O(1) extra work: CSR of A holds the same arrays as CSC of A^T
+    SparseMatrix transpose() const {
+        SparseMatrix result = *this;
+        std::swap(result.rows, result.cols);
+        result.format = format == Format::CSR ? Format::CSC : Format::CSR;
+        return result;
+    }
+
+    SparseMatrix scale(double factor) const {
+        SparseMatrix result = *this;
+        for (double& v : result.values) v *= factor;
+        return result;
+    }
+
+    // y = A x (SpMV)
+    std::vector<double> multiplyVector(const std::vector<double>& x) const {
+        if (x.size() != cols) throw std::invalid_argument("Vector size incompatible with matrix columns");
+        std::vector<double> y(rows);
+        multiplyVector(x.data(), y.data());
+        return y;
+    }
+
+    void multiplyVector(const double* x, double* y) const {
+        if (format == Format::CSR) gather(x, y);
+        else scatter(x, y);
+    }
+
+    // y = A^T x, without forming the transpose
+    std::vector<double> multiplyTransposeVector(const std::vector<double>& x) const {
+        if (x.size() != rows) throw std::invalid_argument("Vector size incompatible with matrix rows");
+        std::vector<double> y(cols);
+        multiplyTransposeVector(x.data(), y.data());
+        return y;
+    }
+
+    void multiplyTransposeVector(const double* x, double* y) const {
+        if (format == Format::CSR) scatter(x, y);
+        else gather(x, y);
+    }
+
+    // C = A B for dense B (SpMM). Each stored row or column's nonzeros are
+    // read once for all columns of B: CSR splits the rows of C across
+    // threads, CSC the columns.
+    AcceleratedMatrix multiply(const AcceleratedMatrix& b) const {
+        AcceleratedMatrix result(rows, b.getCols());
+        multiply(b.view(), result.view());
+        return result;
+    }
+
+    void multiply(ConstMatrixView b, MatrixView c) const {
+        if (cols != b.getRows() || c.getRows() != rows || c.getCols() != b.getCols()) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+        if (format == Format::CSR) gatherBlock(b, c);
+        else scatterBlock(b, c);
+    }
+
+    // C = A^T B, without forming the transpose
+    AcceleratedMatrix multiplyTranspose(const AcceleratedMatrix& b) const {
+        AcceleratedMatrix result(cols, b.getCols());
+        multiplyTranspose(b.view(), result.view());
+        return result;
+    }
+
+    void multiplyTranspose(ConstMatrixView b, MatrixView c) const {
+        if (rows != b.getRows() || c.getRows() != cols || c.getCols() != b.getCols()) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+        if (format == Format::CSR) scatterBlock(b, c);
+        else gatherBlock(b, c);
+    }
+
+    std::string toString() const {
+        std::stringstream ss;
+        ss << "SparseMatrix " << rows << "x" << cols << " ("
+           << (format == Format::CSR ? "CSR" : "CSC") << ", " << values.size() << " nonzeros)";
+        if (rows > 12 || cols > 12) return ss.str() + "\n";
+
+        // Small matrices print like their dense form, minus its header line
+        const std::string dense = toDense().toString();
+        ss << ":\n" << dense.substr(dense.find('\n') + 1);
+        return ss.str();
+    }
+};
+
+// Coordinate-format builder: collect (row, col, value) triplets in any
+// order, then compress. Duplicate coordinates are summed, as when
+// assembling finite-element stiffness matrices.
+class SparseBuilder {
+private:
+    size_t rows, cols;
+    std::vector<SparseMatrix::Index> rowIndex, colIndex;
+    std::vector<double> entries;
+
+public:
+    SparseBuilder(size_t r, size_t c) : rows(r), cols(c) {
+        if (std::max(r, c) > std::numeric_limits<SparseMatrix::Index>::max()) {
+            throw std::invalid_argument("Sparse matrix dimension exceeds 32-bit index range");
+        }
+    }
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t size() const { return entries.size(); }
+
+    void reserve(size_t count) {
+        rowIndex.reserve(count);
+        colIndex.reserve(count);
+        entries.reserve(count);
+    }
+
+    void add(size_t r, size_t c, double value) {
+        if (r >= rows || c >= cols) throw std::out_of_range("Matrix index out of range");
+        rowIndex.push_back(static_cast<SparseMatrix::Index>(r));
+        colIndex.push_back(static_cast<SparseMatrix::Index>(c));
+        entries.push_back(value);
+    }
+
+    void clear() {
+        rowIndex.clear();
+        colIndex.clear();
+        entries.clear();
+    }
+
+    // Two stable counting sorts (by inner index, then by outer index) leave
+    // every segment sorted; duplicates are then adjacent and merged.
+    // O(nnz + rows + cols).
+    SparseMatrix build(SparseMatrix::Format format = SparseMatrix::Format::CSR) const {
+        const bool csr = format == SparseMatrix::Format::CSR;
+        const std::vector<SparseMatrix::Index>& outerIndex = csr ? rowIndex : colIndex;
+        const std::vector<SparseMatrix::Index>& innerIndex = csr ? colIndex : rowIndex;
+        const size_t outer = csr ? rows : cols, inner = csr ? cols : rows;
+        const size_t count = entries.size();
+
+        // Pass 1: order triplets by inner index
+        std::vector<size_t> innerStart(inner + 1, 0);
+        for (SparseMatrix::Index index : innerIndex) ++innerStart[index + 1];
+        for (size_t i = 0; i < inner; ++i) innerStart[i + 1] += innerStart[i];
+        std::vector<size_t> byInner(count);
+        for (size_t t = 0; t < count; ++t) byInner[innerStart[innerIndex[t]]++] = t;
+
+        // Pass 2: stable by outer index
+        SparseMatrix result(rows, cols, format);
+        for (SparseMatrix::Index index : outerIndex) ++result.offsets[index + 1];
+        for (size_t i = 0; i < outer; ++i) result.offsets[i + 1] += result.offsets[i];
+        std::vector<size_t> cursor(result.offsets.begin(), result.offsets.end() - 1);
+        result.indices.resize(count);
+        result.values.resize(count);
+        for (size_t t : byInner) {
+            const size_t slot = cursor[outerIndex[t]]++;
+            result.indices[slot] = innerIndex[t];
+            result.values[slot] = entries[t];
+        }
+
+        // Merge duplicates in place, compacting the segments
+        size_t write = 0;
+        for (size_t i = 0; i < outer; ++i) {
+            const size_t begin = result.offsets[i], end = result.offsets[i + 1];
+            result.offsets[i] = write;
+            for (size_t k = begin; k < end; ++k) {
+                if (write > result.offsets[i] && result.indices[write - 1] == result.indices[k]) {
+                    result.values[write - 1] += result.values[k];
+                } else {
+                    result.indices[write] = result.indices[k];
+                    result.values[write] = result.values[k];
+                    ++write;
+                }
+            }
+        }
+        result.offsets[outer] = write;
+        result.indices.resize(write);
+        result.values.resize(write);
+        result.indices.shrink_to_fit();
+        result.values.shrink_to_fit();
+        return result;
+    }
+};
+
+#endif // SPARSEMATRIX_HPP
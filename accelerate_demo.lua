@@ -224,7 +224,7 @@ function lapack_operations()
     end
     
     -- SVD
-    perf_update("5. Singular Value Decomposition (LAPACK dgesvd):")
+    perf_update("5. Singular Value Decomposition (LAPACK dgesdd):")
     start_time = get_time_ms()
     
     local svd_success, svd_result = pcall(function() return A:svd() end)
@@ -554,7 +554,7 @@ edu_window:show()
 print("=== macOS Accelerate Framework Integration Ready ===")
 print("Capabilities:")
 print("✓ Optimized BLAS operations (dgemm, dgemv)")
-print("✓ LAPACK linear algebra (dgetrf, dgeev, dgesvd)")
+print("✓ LAPACK linear algebra (dgetrf, dgeev, dgesdd)")
 print("✓ High-performance matrix operations")
 print("✓ Production-quality numerical algorithms")
 print("")
@@ -0,0 +1,57 @@
+-- complex_matrix_test.lua - ComplexMatrix arithmetic, solves and eigenvalues
+
+print("=== ComplexMatrix Test ===")
+
+-- Test 1: Build from real and imaginary parts
+print("\n1. Construction:")
+local re = create_accelerated_matrix(3, 3)
+local im = create_accelerated_matrix(3, 3)
+re:fillRandom(-1, 1)
+im:fillRandom(-1, 1)
+local Z = ComplexMatrix.new(re, im)
+print(Z:toString())
+
+local r, i = Z:get(0, 0)
+print(string.format("Z[0,0] = %.6f %+.6fi", r, i))
+
+-- Test 2: Arithmetic
+print("\n2. Arithmetic:")
+local H = Z:multiply(Z:adjoint())  -- Z Z^H is Hermitian
+print("Z * Z^H:")
+print(H:toString())
+print("Z scaled by i:")
+print(Z:scale(0, 1):toString())
+print(string.format("||Z||_F = %.6f", Z:norm()))
+
+-- Test 3: Linear solve
+print("\n3. Linear Solve:")
+local b = create_complex_matrix(3, 1)
+b:set(0, 0, 1, 0)
+b:set(1, 0, 0, 1)
+b:set(2, 0, 1, -1)
+local x = Z:solve(b)
+local residual = Z:multiply(x):subtract(b):norm()
+print(string.format("||Zx - b|| = %.3e", residual))
+local det_re, det_im = Z:determinant()
+print(string.format("det(Z) = %.6f %+.6fi", det_re, det_im))
+
+-- Test 4: Eigenvalues (needs LAPACK)
+print("\n4. Eigenvalues:")
+if complex_eigenvalues then
+    -- A rotation has eigenvalues +i and -i
+    local rotation = create_accelerated_matrix(2, 2)
+    rotation:set(0, 1, -1)
+    rotation:set(1, 0, 1)
+    print("Rotation eigenvalues:")
+    print(complex_eigenvalues(rotation):toString())
+
+    local eigen = Z:eigenvectors()
+    for k = 0, 2 do
+        local lambda_re, lambda_im = eigen.values:get(k, 0)
+        print(string.format("lambda_%d = %.6f %+.6fi", k, lambda_re, lambda_im))
+    end
+else
+    print("LAPACK not linked: eigenvalues unavailable")
+end
+
+return "ComplexMatrix test completed"
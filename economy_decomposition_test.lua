@@ -0,0 +1,95 @@
+-- economy_decomposition_test.lua - Thin QR, economy and values-only SVD (LAPACK builds)
+
+print("=== Economy Decomposition Test ===")
+
+local function shape(M)
+    return string.format("%dx%d", M:getRows(), M:getCols())
+end
+
+-- Test 1: Full vs economy QR on a tall matrix
+print("\n1. QR (4000 x 50):")
+local A = create_accelerated_matrix(4000, 50)
+A:fillRandom(-1, 1)
+print("Mode    | Q         | R        | Time (ms) | ||QR - A||")
+print("--------|-----------|----------|-----------|-----------")
+for _, economy in ipairs({false, true}) do
+    local start = get_time_ms()
+    local qr = A:qrDecomposition({economy = economy})
+    local time = get_time_ms() - start
+    print(string.format("%-7s | %-9s | %-8s | %9d | %.3e", economy and "economy" or "full",
+          shape(qr.Q), shape(qr.R), time, qr.Q:multiply(qr.R):subtract(A):norm()))
+end
+
+-- Test 2: SVD modes (divide and conquer)
+print("\n2. SVD (2000 x 300):")
+local B = create_accelerated_matrix(2000, 300)
+B:fillRandom(-1, 1)
+print("Mode        | U          | VT       | Time (ms) | sigma_1")
+print("------------|------------|----------|-----------|----------")
+for _, case in ipairs({{"full", {}}, {"economy", {economy = true}}, {"values_only", {values_only = true}}}) do
+    local start = get_time_ms()
+    local svd = B:svd(case[2])
+    local time = get_time_ms() - start
+    print(string.format("%-11s | %-10s | %-8s | %9d | %.6f", case[1],
+          svd.U and shape(svd.U) or "-", svd.VT and shape(svd.VT) or "-", time, svd.S[1]))
+end
+
+-- Test 3: Economy reconstruction U diag(S) VT
+print("\n3. Economy Reconstruction:")
+local svd = B:svd({economy = true})
+local D = create_accelerated_matrix(#svd.S, #svd.S)
+for j = 1, #svd.S do D:set(j - 1, j - 1, svd.S[j]) end
+local product = svd.U:multiply(D):multiply(svd.VT)
+print(string.format("||U diag(S) VT - B|| / ||B|| = %.3e", product:subtract(B):norm() / B:norm()))
+
+-- Test 4: Tall least squares now uses the thin Q
+print("\n4. Least Squares (20000 x 40):")
+local C = create_accelerated_matrix(20000, 40)
+C:fillRandom(-1, 1)
+local b = {}
+for i = 1, 20000 do b[i] = math.sin(i) end
+local start = get_time_ms()
+local x = solve_least_squares(C, b)
+print(string.format("Solved %d unknowns in %d ms", #x, get_time_ms() - start))
+
+-- Test 5: Wide and rank-deficient systems get the minimum-norm solution
+print("\n5. Minimum-Norm Least Squares:")
+local function norm2(v)
+    local sum = 0
+    for i = 1, #v do sum = sum + v[i] * v[i] end
+    return math.sqrt(sum)
+end
+-- 6 x 3 with column 3 = column 1 + column 2: x stays bounded and orthogonal
+-- to the null space (1, 1, -1)
+local R = create_accelerated_matrix(6, 3)
+local r = {}
+for i = 0, 5 do
+    R:set(i, 0, i + 1)
+    R:set(i, 1, (i * i) % 5 + 0.5)
+    R:set(i, 2, R:get(i, 0) + R:get(i, 1))
+    r[i + 1] = math.sin(i + 1)
+end
+local xr = solve_least_squares(R, r)
+local normal = R:transpose():multiplyVector(R:multiplyVector(xr))
+local rhs = R:transpose():multiplyVector(r)
+for i = 1, 3 do normal[i] = normal[i] - rhs[i] end
+print(string.format("Rank deficient 6x3: ||x|| = %.3e, ||A^T (A x - b)|| = %.3e, x . null = %.3e",
+      norm2(xr), norm2(normal), xr[1] + xr[2] - xr[3]))
+-- 3 x 6: A x = b exactly, and x = A^T y lies in the row space
+local Wd = create_accelerated_matrix(3, 6)
+for i = 0, 2 do
+    for j = 0, 5 do Wd:set(i, j, math.cos((i + 1) * (j + 0.5) * 0.9) + 0.1 * i * j) end
+end
+local c = {1, 2, 3}
+local xw = solve_least_squares(Wd, c)
+local residual = Wd:multiplyVector(xw)
+for i = 1, 3 do residual[i] = residual[i] - c[i] end
+local y = Wd:multiply(Wd:transpose()):solve(c)
+local minimum = Wd:transpose():multiplyVector(y)
+for i = 1, 6 do minimum[i] = minimum[i] - xw[i] end
+print(string.format("Wide 3x6: ||A x - b|| = %.3e, ||x - A^T (A A^T)^-1 b|| = %.3e",
+      norm2(residual), norm2(minimum)))
+local ok, message = pcall(solve_least_squares, Wd, {1, 2})
+print("Right-hand side size mismatch rejected: " .. tostring(not ok) .. (ok and "" or " (" .. tostring(message) .. ")"))
+
+print("\n=== Economy Decomposition Test Complete ===")
@@ -0,0 +1,111 @@
+-- eigs_test.lua - A few eigen- and singular values by restarted Lanczos / Arnoldi
+
+print("=== Krylov Eigensolver Test ===")
+
+-- Test 1: Dense symmetric matrix against the full decomposition
+print("\n1. Dense Symmetric (n = 600, k = 5):")
+local R = create_accelerated_matrix(600, 600)
+R:fillRandom(-1, 1)
+local S = R:add(R:transpose())
+
+local start = get_time_ms()
+local full = S:eigenSymmetric(false)
+local full_time = get_time_ms() - start
+
+print("Which     | Restarts | Time (ms) | Max error vs eigenSymmetric")
+print("----------|----------|-----------|----------------------------")
+for _, which in ipairs({"largest", "smallest"}) do
+    start = get_time_ms()
+    local result = eigs(S, 5, {which = which})
+    local time = get_time_ms() - start
+    local worst = 0
+    for i = 1, 5 do
+        local reference = which == "largest" and full.values[601 - i] or full.values[i]
+        worst = math.max(worst, math.abs(result.values[i] - reference))
+    end
+    print(string.format("%-9s | %8d | %9d | %.3e", which, result.restarts, time, worst))
+end
+print(string.format("Full decomposition: %d ms", full_time))
+
+-- Test 2: Sparse Laplacian, largest eigenvalues and Ritz residuals
+print("\n2. Sparse Laplacian (n = 2500, k = 4):")
+local g = 50
+-- Eigenvalues of the 5-point Laplacian: 4 - 2cos(pi i/(g+1)) - 2cos(pi j/(g+1))
+local L = create_laplacian_2d(g)
+print("Symmetric detected: " .. tostring(L:isSymmetric()))
+start = get_time_ms()
+local lap = eigs(L, 4)
+print(string.format("Converged: %s, restarts: %d, applications: %d, %d ms",
+      tostring(lap.converged), lap.restarts, lap.applications, get_time_ms() - start))
+-- The top of the spectrum has double eigenvalues (i, j and j, i), so every
+-- value is checked against the sorted analytic list, not just the first
+local spectrum = {}
+for i = 1, g do
+    for j = 1, g do
+        spectrum[#spectrum + 1] = 4 - 2 * math.cos(math.pi * i / (g + 1)) - 2 * math.cos(math.pi * j / (g + 1))
+    end
+end
+table.sort(spectrum, function(a, b) return a > b end)
+local worst_value = 0
+for i = 1, 4 do
+    local v = {}
+    for r = 1, L:getRows() do v[r] = lap.vectors:get(r - 1, i - 1) end
+    local Av = L:multiplyVector(v)
+    local residual = 0
+    for r = 1, #v do residual = residual + (Av[r] - lap.values[i] * v[r])^2 end
+    worst_value = math.max(worst_value, math.abs(lap.values[i] - spectrum[i]))
+    print(string.format("  lambda_%d = %.10f (exact %.10f), ||Av - lambda v|| = %.2e",
+          i, lap.values[i], spectrum[i], math.sqrt(residual)))
+end
+print(string.format("Largest error against the analytic spectrum: %.3e", worst_value))
+
+-- Test 3: Matrix-free operator (symmetric must be stated)
+print("\n3. Kronecker Operator (n = 3600, k = 3):")
+local A = create_accelerated_matrix(60, 60)
+A:fillRandom(-1, 1)
+A = A:add(A:transpose())
+local K = kronecker_operator(A, A)
+local kron = eigs(K, 3, {symmetric = true, which = "magnitude"})
+local single = A:eigenSymmetric(false).values
+local top = math.max(math.abs(single[1]), math.abs(single[60]))
+print(string.format("|lambda_1| = %.10f, expected %.10f (restarts %d)",
+      math.abs(kron.values[1]), top * top, kron.restarts))
+
+-- Test 4: Truncated singular values against the full SVD (LAPACK builds)
+print("\n4. svds (1000 x 300, k = 5):")
+local B = create_accelerated_matrix(1000, 300)
+B:fillRandom(-1, 1)
+start = get_time_ms()
+local sv = svds(B, 5)
+local svds_time = get_time_ms() - start
+local worst = 0
+local ok, reference = pcall(function() return B:svd().S end)
+if ok then
+    for i = 1, 5 do worst = math.max(worst, math.abs(sv.values[i] - reference[i])) end
+    print(string.format("Max error vs svd: %.3e", worst))
+end
+print(string.format("sigma_1 = %.10f, U %dx%d, V %dx%d, %d ms", sv.values[1],
+      sv.U:getRows(), sv.U:getCols(), sv.V:getRows(), sv.V:getCols(), svds_time))
+
+-- Test 5: Nonsymmetric matrix (LAPACK builds)
+print("\n5. Nonsymmetric (n = 400, k = 4, largest magnitude):")
+local N = create_accelerated_matrix(400, 400)
+N:fillRandom(-1, 1)
+local ok5, general = pcall(eigs, N, 4, {which = "magnitude"})
+if ok5 then
+    -- Reference: moduli of all eigenvalues from the dense solver, largest first
+    local dense = eig(N, {vectors = false})
+    local moduli = {}
+    for i = 1, #dense.real do moduli[i] = math.sqrt(dense.real[i]^2 + dense.imag[i]^2) end
+    table.sort(moduli, function(a, b) return a > b end)
+    print(string.format("Converged: %s, restarts: %d", tostring(general.converged), general.restarts))
+    for i = 1, #general.real do
+        local modulus = math.sqrt(general.real[i]^2 + general.imag[i]^2)
+        print(string.format("  %.8f %+.8fi  |lambda| %.8f (dense %.8f)", general.real[i], general.imag[i],
+              modulus, moduli[i]))
+    end
+else
+    print("Skipped: " .. tostring(general))
+end
+
+print("\n=== Krylov Eigensolver Test Complete ===")
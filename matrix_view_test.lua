@@ -0,0 +1,187 @@
+-- matrix_view_test.lua - Views, lazy expressions and in-place transposes against eager results
+
+print("=== Matrix View Test ===")
+
+local mismatches = 0
+local function report(label, difference)
+    local ok = difference <= 1e-12
+    if not ok then mismatches = mismatches + 1 end
+    print(string.format("  %-44s %.3e  %s", label, difference, ok and "ok" or "MISMATCH"))
+end
+
+local function random_matrix(rows, cols)
+    local M = create_accelerated_matrix(rows, cols)
+    M:fillRandom(-1, 1)
+    return M
+end
+
+-- Largest |V(i, j) - M(r0 + i, c0 + j)| over the view
+local function view_difference(V, M, r0, c0)
+    local worst = 0
+    for i = 0, V:getRows() - 1 do
+        for j = 0, V:getCols() - 1 do
+            worst = math.max(worst, math.abs(V:get(i, j) - M:get(r0 + i, c0 + j)))
+        end
+    end
+    return worst
+end
+
+-- Test 1: Blocks, rows and columns read the parent's elements (37 rows: padded columns)
+print("\n1. Views vs Elements (37 x 53):")
+local A = random_matrix(37, 53)
+report("A:view()", view_difference(A:view(), A, 0, 0))
+report("A:view(5, 7, 20, 30)", view_difference(A:view(5, 7, 20, 30), A, 5, 7))
+report("A:row(11)", view_difference(A:row(11), A, 11, 0))
+report("A:col(42)", view_difference(A:col(42), A, 0, 42))
+report("A:view(5, 7, 20, 30):view(2, 3, 4, 5)", view_difference(A:view(5, 7, 20, 30):view(2, 3, 4, 5), A, 7, 10))
+report("A:view():transpose() vs A:transpose()", view_difference(A:view():transpose(), A:transpose(), 0, 0))
+report("A:view(0, 0, 10, 20):toMatrix()", view_difference(A:view(0, 0, 10, 20):toMatrix():view(), A, 0, 0))
+report("block product vs copied operands",
+       A:view(0, 0, 20, 30):multiply(A:view(3, 10, 30, 15))
+        :subtract(A:view(0, 0, 20, 30):toMatrix():multiply(A:view(3, 10, 30, 15):toMatrix())):norm())
+
+-- Test 2: Writes through a view land in the parent and nowhere else
+print("\n2. Writes Through Views:")
+local B = random_matrix(37, 53)
+local expected = B:view():toMatrix()
+B:view(4, 6, 10, 12):scale(-2)
+B:row(30):fill(7)
+B:col(50):set(3, 0, 0.5)
+for i = 4, 13 do
+    for j = 6, 17 do expected:set(i, j, -2 * expected:get(i, j)) end
+end
+for j = 0, 52 do expected:set(30, j, 7) end
+expected:set(3, 50, 0.5)
+report("scale / fill / set vs element updates", B:subtract(expected):norm())
+local source = random_matrix(10, 12)
+B:view(20, 40, 10, 12):copyFrom(source)
+report("copyFrom into a block", view_difference(B:view(20, 40, 10, 12), source, 0, 0))
+
+-- Test 3: Views keep their matrix alive after the last reference is dropped
+print("\n3. View Lifetime:")
+local function orphaned_views()
+    local M = random_matrix(40, 30)
+    local copy = M:view():toMatrix()
+    return M:view(2, 3, 10, 10), M:row(7), M:col(29):view(5, 0, 10, 1), M:view():transpose(), copy
+end
+local block, row, nested, transposed, copy = orphaned_views()
+collectgarbage()
+collectgarbage()
+local churn = {}
+for i = 1, 50 do churn[i] = random_matrix(40, 30) end
+churn = nil
+collectgarbage()
+report("block of a collected temporary", view_difference(block, copy, 2, 3))
+report("row of a collected temporary", view_difference(row, copy, 7, 0))
+report("view of a column of a collected temporary", view_difference(nested, copy, 5, 29))
+report("transpose of a collected temporary", view_difference(transposed, copy:transpose(), 0, 0))
+local chained = random_matrix(50, 50):view(10, 10, 20, 20):row(4)
+collectgarbage()
+chained:fill(3)
+report("write through a chained temporary view", math.abs(chained:get(0, 19) - 3))
+
+-- Test 4: Fused lazy chains vs eager operations (2001 x 53: padded, several blocks)
+print("\n4. Lazy Expressions vs Eager (2001 x 53):")
+local function copy_of(M)
+    return M:view():toMatrix()
+end
+
+-- Eager element-wise f(x, y), one element at a time
+local function elementwise(X, Y, f)
+    local R = create_accelerated_matrix(X:getRows(), X:getCols())
+    for i = 0, X:getRows() - 1 do
+        for j = 0, X:getCols() - 1 do R:set(i, j, f(X:get(i, j), Y:get(i, j))) end
+    end
+    return R
+end
+local function map(X, f)
+    return elementwise(X, X, f)
+end
+local function times(x, y) return x * y end
+
+local P, Q, W = random_matrix(2001, 53), random_matrix(2001, 53), random_matrix(2001, 53)
+local PQ = elementwise(P, Q, times)
+report("(P + Q) * 2 - W", lazy(P):add(Q):scale(2):subtract(W):evaluate()
+       :subtract(P:add(Q):scale(2):subtract(W)):norm())
+report("P .* Q + 0.5", lazy(P):multiply(Q):addScalar(0.5):evaluate()
+       :subtract(map(PQ, function(x) return x + 0.5 end)):norm())
+report("P - (Q .* W), nested right operand", lazy(P):subtract(lazy(Q):multiply(W)):evaluate()
+       :subtract(P:subtract(elementwise(Q, W, times))):norm())
+report("P .* P + P, repeated operand", P:lazy():multiply(P):add(P):evaluate()
+       :subtract(elementwise(P, P, function(x) return x * x + x end)):norm())
+
+-- The output may be any operand of the chain
+local X = copy_of(P)
+lazy(X):scale(2):add(Q):evaluateInto(X)
+report("X = X * 2 + Q (output is the first operand)", X:subtract(P:scale(2):add(Q)):norm())
+local Y = copy_of(Q)
+lazy(P):multiply(Y):subtract(Y):evaluateInto(Y)
+report("Y = P .* Y - Y (output is a later operand)", Y:subtract(PQ:subtract(Q)):norm())
+local Z = copy_of(W)
+lazy(P):add(lazy(Z):scale(3)):evaluateInto(Z)
+report("Z = P + 3 Z (output inside a nested operand)", Z:subtract(P:add(W:scale(3))):norm())
+
+-- Expressions keep their operands alive
+local function orphaned_expression()
+    local M, N = random_matrix(2001, 53), random_matrix(2001, 53)
+    return lazy(M):add(lazy(N):scale(-1)):addScalar(1), M:subtract(N)
+end
+local expression, difference = orphaned_expression()
+collectgarbage()
+collectgarbage()
+report("chain over collected temporaries", expression:evaluate()
+       :subtract(map(difference, function(x) return x + 1 end)):norm())
+
+local mismatched = pcall(function() return lazy(P):add(random_matrix(53, 2001)) end)
+local wrong_output = pcall(function() lazy(P):evaluateInto(random_matrix(2000, 53)) end)
+print(string.format("  Shape mismatch rejected: operand %s, output %s",
+      tostring(not mismatched), tostring(not wrong_output)))
+if mismatched or wrong_output then mismatches = mismatches + 1 end
+
+-- Test 5: In-place transposes. Square matrices transpose in place (subtract
+-- and norm cover the padding rows too); rectangular ones would have to move
+-- their storage under any live view, so they are refused
+print("\n5. transposeInPlace:")
+for _, n in ipairs({45, 64, 100}) do
+    local M = random_matrix(n, n)
+    local original, expected = copy_of(M), M:transpose()
+    M:transposeInPlace()
+    report(string.format("%dx%d vs transpose()", n, n), M:subtract(expected):norm())
+    M:transposeInPlace()
+    report(string.format("%dx%d twice vs original", n, n), M:subtract(original):norm())
+end
+local F = random_matrix(37, 37):toFloat32()
+local expected32 = F:transpose()
+F:transposeInPlace()
+report("37x37 float32 vs transpose()", F:subtract(expected32):norm())
+
+-- A view held across the transpose sees the transposed elements and still
+-- writes into the matrix
+local S = random_matrix(40, 40)
+local held = S:view(0, 0, 10, 40)
+local before = copy_of(S)
+S:transposeInPlace()
+report("view held across a square transpose", view_difference(held, before:transpose(), 0, 0))
+held:set(2, 30, 9)
+report("write through the held view", math.abs(S:get(2, 30) - 9))
+
+-- Rectangular: refused, leaving the matrix, its views and lazy() chains intact
+for _, shape in ipairs({{100, 33}, {33, 100}, {1, 70}}) do
+    local M = random_matrix(shape[1], shape[2])
+    local view, pending, original = M:view(), lazy(M):scale(2), copy_of(M)
+    local refused = not pcall(function() M:transposeInPlace() end)
+    local label = string.format("%dx%d", shape[1], shape[2])
+    if not refused or M:getRows() ~= shape[1] or M:getCols() ~= shape[2] then
+        report(label .. " refused", math.huge)
+    else
+        view:set(0, shape[2] - 1, 5)
+        original:set(0, shape[2] - 1, 5)
+        report(label .. " refused; view and matrix intact", M:subtract(original):norm())
+        report(label .. " refused; lazy() chain intact", pending:evaluate():subtract(original:scale(2)):norm())
+    end
+end
+local F32 = random_matrix(100, 33):toFloat32()
+if pcall(function() F32:transposeInPlace() end) then report("100x33 float32 refused", math.huge) end
+
+print(string.format("\n%d mismatch(es)", mismatches))
+print("\n=== Matrix View Test Complete ===")
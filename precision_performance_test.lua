@@ -256,6 +256,69 @@ for _, test in ipairs(condition_tests) do
     end
 end
 
+-- Test 6: Same operations on every compiled-in backend
+print("\n\n6. Backend Comparison:")
+
+local original_backend = get_matrix_backend()
+local backend_sizes = {100, 300}
+
+print("Backend    | Size | Multiply (μs) | GFLOPS | Solve (μs)")
+print("-----------|------|---------------|--------|-----------")
+
+for _, size in ipairs(backend_sizes) do
+    local A = create_accelerated_matrix(size, size)
+    local B = create_accelerated_matrix(size, size)
+    A:fillRandom(-1, 1)
+    B:fillRandom(-1, 1)
+    for i = 0, size-1 do
+        A:set(i, i, A:get(i, i) + size)  -- Diagonally dominant, safe to solve
+    end
+
+    local rhs = {}
+    for i = 1, size do rhs[i] = math.random() end
+
+    for _, backend in ipairs(list_matrix_backends()) do
+        set_matrix_backend(backend)
+
+        local multiply_stats = time_operation(function() return A:multiply(B) end, 5)
+        local solve_stats = time_operation(function() return A:solve(rhs) end, 5)
+        local gflops = calculate_gflops_precise(2 * size * size * size, multiply_stats.mean_us)
+
+        print(string.format("%-10s | %4d | %13.1f | %6.1f | %9.1f",
+            backend, size, multiply_stats.mean_us, gflops, solve_stats.mean_us))
+    end
+end
+
+set_matrix_backend(original_backend)
+
+-- Test 7: Single vs double precision
+print("\n\n7. Float32 vs Float64:")
+print("Size | f64 Multiply (μs) | f32 Multiply (μs) | Speedup | Max |f32 - f64|")
+print("-----|-------------------|-------------------|---------|---------------")
+
+for _, size in ipairs(backend_sizes) do
+    local A = create_accelerated_matrix(size, size)
+    local B = create_accelerated_matrix(size, size)
+    A:fillRandom(-1, 1)
+    B:fillRandom(-1, 1)
+    local A32, B32 = A:toFloat32(), B:toFloat32()
+
+    local f64_stats = time_operation(function() return A:multiply(B) end, 5)
+    local f32_stats = time_operation(function() return A32:multiply(B32) end, 5)
+
+    local C = A:multiply(B)
+    local C32 = A32:multiply(B32):toFloat64()
+    local max_diff = 0
+    for i = 0, size-1 do
+        for j = 0, size-1 do
+            max_diff = math.max(max_diff, math.abs(C:get(i, j) - C32:get(i, j)))
+        end
+    end
+
+    print(string.format("%4d | %17.1f | %17.1f | %6.2fx | %13.2e",
+        size, f64_stats.mean_us, f32_stats.mean_us, f64_stats.mean_us / f32_stats.mean_us, max_diff))
+end
+
 print("\n=== HIGH-RESOLUTION PERFORMANCE SUMMARY ===")
 print("🎯 Microsecond-precision timing reveals:")
 print("• True computational performance with random data")
@@ -170,6 +170,33 @@ for _, size in ipairs(lapack_sizes) do
     end
 end
 
+-- Mixed-precision solve against the plain double solve
+print("\n=== Mixed-Precision Solve (float32 LU + float64 refinement) ===")
+print("Size | solve (ms) | solve_refined (ms) | Iter | Backward error | Fallback")
+print("-----|------------|--------------------|------|----------------|---------")
+
+for _, size in ipairs({200, 500, 1000}) do
+    local A = create_accelerated_matrix(size, size)
+    A:fillRandom(-1, 1)
+    for i = 0, size-1 do
+        A:set(i, i, A:get(i, i) + math.sqrt(size))  -- Well conditioned
+    end
+    local b = {}
+    for i = 1, size do b[i] = math.random() end
+
+    local start = get_time_ms()
+    A:solve(b)
+    local solve_time = get_time_ms() - start
+
+    start = get_time_ms()
+    local refined = solve_refined(A, b)
+    local refined_time = get_time_ms() - start
+
+    print(string.format("%4d | %10d | %18d | %4d | %14.2e | %s",
+          size, solve_time, refined_time, refined.iterations, refined.backward_error,
+          tostring(refined.fallback)))
+end
+
 print("\n=== Final Performance Assessment ===")
 print("✅ Matrix multiplication: HIGHLY optimized (Accelerate BLAS)")
 print("✅ Matrix inversion: Working (Accelerate LAPACK)")  
@@ -1022,6 +1022,13 @@ void Sol2QtMainWindow::initializeSol2()
         "transpose", &LuaMatrix::transpose,
         "scale", &LuaMatrix::scale,
         "determinant", &LuaMatrix::determinant,
+        "inverse", &LuaMatrix::inverse,
+        "solve", &LuaMatrix::solve,
+        "multiplyVector", &LuaMatrix::multiplyVector,
+        
+        // Zero-copy interop with the AcceleratedMatrix kernels
+        "view", sol::policies([](LuaMatrix& m) { return m.view(); }, sol::self_dependency()),
+        "toAccelerated", &LuaMatrix::toAccelerated,
         
         // Utility functions
         "fillRandom", sol::overload(
@@ -1143,11 +1150,7 @@ void Sol2QtMainWindow::initializeSol2()
 
     // CORRECTED Vector math functions
     lua->set_function("vector_norm", [](const std::vector<double>& v) -> double {
-        double sum = 0.0;
-        for (const double& x : v) {
-            sum += x * x;
-        }
-        return std::sqrt(sum);
+        return std::sqrt(MatrixKernels::sumOfSquares(v.size(), v.data()));
     });
     
     lua->set_function("vector_normalize", [](std::vector<double>& v) -> double {
@@ -1169,11 +1172,7 @@ void Sol2QtMainWindow::initializeSol2()
         if (a.size() != b.size()) {
             throw std::invalid_argument("Vectors must be same size for dot product");
         }
-        double result = 0.0;
-        for (size_t i = 0; i < a.size(); ++i) {
-            result += a[i] * b[i];
-        }
-        return result;
+        return MatrixKernels::dot(a.size(), a.data(), b.data());
     });
     
     lua->set_function("vector_add", [](const std::vector<double>& a, const std::vector<double>& b) -> std::vector<double> {
@@ -1292,42 +1291,20 @@ void Sol2QtMainWindow::initializeSol2()
     });
     
     lua->set_function("vector_sum", [](const std::vector<double>& v) {
-        double sum = 0.0;
-        for (double x : v) sum += x;
-        return sum;
+        return MatrixKernels::sum(v.size(), v.data());
     });
     
     // Enhanced matrix operations that work with the fixed vector system
     lua->set_function("matrix_vector_multiply", [](const LuaMatrix& matrix, const std::vector<double>& vec) {
-        if (matrix.getCols() != vec.size()) {
-            throw std::invalid_argument("Matrix columns must equal vector size");
-        }
-        
-        std::vector<double> result(matrix.getRows(), 0.0);
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result[i] += matrix.get(i, j) * vec[j];
-            }
-        }
-        return result;
+        return matrix.multiplyVector(vec);
     });
     
     lua->set_function("matrix_get_row_vector", [](const LuaMatrix& matrix, size_t row) {
-        if (row >= matrix.getRows()) throw std::out_of_range("Row index out of range");
-        std::vector<double> result(matrix.getCols());
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            result[j] = matrix.get(row, j);
-        }
-        return result;
+        return matrix.getRow(row);
     });
     
     lua->set_function("matrix_get_col_vector", [](const LuaMatrix& matrix, size_t col) {
-        if (col >= matrix.getCols()) throw std::out_of_range("Column index out of range");
-        std::vector<double> result(matrix.getRows());
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            result[i] = matrix.get(i, col);
-        }
-        return result;
+        return matrix.getCol(col);
     });
     
     lua->set_function("matrix_set_row_vector", [](LuaMatrix& matrix, size_t row, const std::vector<double>& vec) {
@@ -1351,17 +1328,11 @@ void Sol2QtMainWindow::initializeSol2()
     // Vector math functions
     lua->set_function("dot_product", [](const std::vector<double>& a, const std::vector<double>& b) {
         if (a.size() != b.size()) throw std::invalid_argument("Vectors must be same size");
-        double result = 0.0;
-        for (size_t i = 0; i < a.size(); ++i) {
-            result += a[i] * b[i];
-        }
-        return result;
+        return MatrixKernels::dot(a.size(), a.data(), b.data());
     });
     
     lua->set_function("vector_norm", [](const std::vector<double>& v) {
-        double sum = 0.0;
-        for (double x : v) sum += x * x;
-        return std::sqrt(sum);
+        return std::sqrt(MatrixKernels::sumOfSquares(v.size(), v.data()));
     });
     
     lua->set_function("vector_normalize", [](std::vector<double>& v) {
@@ -1380,6 +1351,16 @@ void Sol2QtMainWindow::initializeSol2()
         ).count();
     });
 
+    // A rectangular in-place transpose re-pads the buffer and may move it,
+    // which would leave views taken from Lua pointing at freed storage; Lua
+    // only gets the square case, where the storage stays put
+    auto transposeSquareInPlace = [](auto& matrix) {
+        if (matrix.getRows() != matrix.getCols()) {
+            throw std::invalid_argument("transposeInPlace needs a square matrix; use transpose() for rectangular ones");
+        }
+        matrix.transposeInPlace();
+    };
+
     // Bind AcceleratedMatrix class for high-performance linear algebra
     lua->new_usertype<AcceleratedMatrix>("AcceleratedMatrix",
         // Constructors
@@ -1400,10 +1381,21 @@ void Sol2QtMainWindow::initializeSol2()
         "determinant", &AcceleratedMatrix::determinant,
         "norm", &AcceleratedMatrix::norm,
         
-#ifdef __APPLE__
-        // High-performance Accelerate operations
-        "multiplyAccelerate", &AcceleratedMatrix::multiplyAccelerate,
-
+        // In-place / accumulate forms (no allocation)
+        "addInPlace", &AcceleratedMatrix::addInPlace,
+        "subtractInPlace", &AcceleratedMatrix::subtractInPlace,
+        "scaleInPlace", &AcceleratedMatrix::scaleInPlace,
+        "axpy", &AcceleratedMatrix::axpy,
+        "gemm", [](AcceleratedMatrix& c, double alpha, const AcceleratedMatrix& a, const AcceleratedMatrix& b, double beta) {
+            c.gemm(alpha, a, b, beta);
+        },
+        "multiplyInto", &AcceleratedMatrix::multiplyInto,
+        "transposeInto", &AcceleratedMatrix::transposeInto,
+        "transposeInPlace", [transposeSquareInPlace](AcceleratedMatrix& m) { transposeSquareInPlace(m); },
+        "copyFrom", &AcceleratedMatrix::copyFrom,
+        "lazy", sol::policies([](const AcceleratedMatrix& m) { return MatrixExpression(m); },
+                              sol::stack_dependencies(-1, 1)),
+        
     // Replace the multiplyVector binding with this version:
     "multiplyVector", [this](const AcceleratedMatrix& matrix, const sol::table& vec_table) -> sol::table {
 	try {
@@ -1430,9 +1422,70 @@ void Sol2QtMainWindow::initializeSol2()
 	    return lua->create_table();  // Return empty table on error
 	}
     },
+
+        // LU-based operations (LAPACK or the built-in blocked LU)
+        "inverse", &AcceleratedMatrix::inverse,
+        "luFactorization", &AcceleratedMatrix::luFactorization,
+
+// Quick fix for linear solve binding in initializeSol2()
+
+// Replace the solve binding with this version that handles Lua tables:
+
+    "solve", [this](const AcceleratedMatrix& matrix, const sol::table& b_table) -> sol::table {
+	try {
+	    // Convert Lua table to std::vector<double>
+	    std::vector<double> b_vector;
+	    b_vector.reserve(b_table.size());
+
+	    for (size_t i = 1; i <= b_table.size(); ++i) {  // Lua 1-based indexing
+		b_vector.push_back(b_table[i].get_or(0.0));
+	    }
+
+	    auto solution = matrix.solve(b_vector);
+
+	    sol::table result = lua->create_table();
+	    for (size_t i = 0; i < solution.size(); ++i) {
+		result[i + 1] = solution[i];  // Lua 1-based indexing
+	    }
+
+	    return result;
+
+	} catch (const std::exception& e) {
+	    outputDisplay->append("Linear solve error: " + QString::fromStdString(e.what()));
+	    return lua->create_table();  // Return empty table on error
+	}
+    },
+
+    // Multiple right-hand sides: X = A \ B with one factorization
+    "solveMany", sol::resolve<AcceleratedMatrix(const AcceleratedMatrix&) const>(&AcceleratedMatrix::solve),
+
+    // Symmetric / SPD specializations (about half the flops of multiply,
+    // solve and eigenvalues). eigenSymmetric([vectors = true]) returns
+    // {values = {...} ascending, vectors = matrix of column eigenvectors}
+    "gram", &AcceleratedMatrix::gram,
+    "isSymmetric", [](const AcceleratedMatrix& matrix, sol::optional<double> tolerance) {
+        return matrix.isSymmetric(tolerance.value_or(0.0));
+    },
+    "cholesky", [](const AcceleratedMatrix& matrix) { return CholeskyFactorization(matrix); },
+    "solveSPD", sol::overload(
+        [](const AcceleratedMatrix& a, const AcceleratedMatrix& b) { return solveSPD(a, b); },
+        [](const AcceleratedMatrix& a, const std::vector<double>& b) { return sol::as_table(solveSPD(a, b)); }
+    ),
+    "eigenSymmetric", [this](const AcceleratedMatrix& matrix, sol::optional<bool> vectors) {
+        const bool computeVectors = vectors.value_or(true);
+        auto eigen = matrix.eigenSymmetric(computeVectors);
+        sol::table result = lua->create_table();
+        result["values"] = sol::as_table(eigen.first);
+        if (computeVectors) result["vectors"] = eigen.second;
+        return result;
+    },
+
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        // High-performance BLAS/LAPACK operations
+        "multiplyAccelerate", &AcceleratedMatrix::multiplyAccelerate,
+
         
         // LAPACK operations
-        "inverse", &AcceleratedMatrix::inverse,
     // Fixed eigenvalue binding that returns proper Lua table
     "eigenvalues", [this](const AcceleratedMatrix& matrix) -> sol::table {
         try {
@@ -1468,38 +1521,12 @@ void Sol2QtMainWindow::initializeSol2()
         }
     },
     
-// Quick fix for linear solve binding in initializeSol2()
-
-// Replace the solve binding with this version that handles Lua tables:
-
-    "solve", [this](const AcceleratedMatrix& matrix, const sol::table& b_table) -> sol::table {
-	try {
-	    // Convert Lua table to std::vector<double>
-	    std::vector<double> b_vector;
-	    b_vector.reserve(b_table.size());
-
-	    for (size_t i = 1; i <= b_table.size(); ++i) {  // Lua 1-based indexing
-		b_vector.push_back(b_table[i].get_or(0.0));
-	    }
-
-	    auto solution = matrix.solve(b_vector);
-
-	    sol::table result = lua->create_table();
-	    for (size_t i = 0; i < solution.size(); ++i) {
-		result[i + 1] = solution[i];  // Lua 1-based indexing
-	    }
-
-	    return result;
-
-	} catch (const std::exception& e) {
-	    outputDisplay->append("Linear solve error: " + QString::fromStdString(e.what()));
-	    return lua->create_table();  // Return empty table on error
-	}
-    },    
-    // Enhanced QR decomposition binding
-    "qrDecomposition", [this](const AcceleratedMatrix& matrix) -> sol::table {
+    // QR decomposition: A:qrDecomposition([{economy = true}]) returns
+    // {Q = ..., R = ...}; economy gives Q m x min(m, n) instead of m x m
+    "qrDecomposition", [this](const AcceleratedMatrix& matrix, sol::optional<sol::table> options) -> sol::table {
         try {
-            auto qr_result = matrix.qrDecomposition();
+            const bool economy = options ? options->get_or("economy", false) : false;
+            auto qr_result = matrix.qrDecomposition(economy);
             
             sol::table result = lua->create_table();
             result["Q"] = qr_result.first;
@@ -1515,57 +1542,24 @@ void Sol2QtMainWindow::initializeSol2()
         }
     },
     
-    // Enhanced SVD binding
-    "svd", [this](const AcceleratedMatrix& matrix) -> sol::table {
+    // SVD by divide and conquer (dgesdd): A:svd([{economy = true} | {values_only = true}])
+    // returns {U = ..., S = {...}, VT = ...}; economy gives U m x k and VT
+    // k x n for k = min(m, n), values_only just {S = {...}}
+    "svd", [this](const AcceleratedMatrix& matrix, sol::optional<sol::table> options) -> sol::table {
         try {
-	    // SVD using Accelerate LAPACK
-	    AcceleratedMatrix a_copy = matrix;
-
-	    int m = static_cast<int>(matrix.getRows());
-	    int n = static_cast<int>(matrix.getCols());
-	    int lda = m;
-	    int min_mn = std::min(m, n);
-
-	    char jobu = 'A', jobvt = 'A';  // Compute full U and VT
-
-	    AcceleratedMatrix U(m, m);
-	    AcceleratedMatrix VT(n, n);
-	    std::vector<double> S(min_mn);
-
-	    int ldu = m, ldvt = n;
-
-	    // Query optimal workspace size
-	    double work_query;
-	    int lwork = -1;
-	    int info;
-
-	    dgesvd_(&jobu, &jobvt, &m, &n, a_copy.getData(), &lda,
-		    S.data(), U.getData(), &ldu, VT.getData(), &ldvt,
-		    &work_query, &lwork, &info);
-
-	    // Perform SVD
-	    lwork = static_cast<int>(work_query);
-	    std::vector<double> work(lwork);
-
-	    dgesvd_(&jobu, &jobvt, &m, &n, a_copy.getData(), &lda,
-		    S.data(), U.getData(), &ldu, VT.getData(), &ldvt,
-		    work.data(), &lwork, &info);
-
-	    if (info < 0) {
-		throw std::runtime_error("LAPACK dgesvd: illegal parameter at position " + std::to_string(-info));
-	    } else if (info > 0) {
-		throw std::runtime_error("SVD failed to converge");
-	    }
+            auto mode = AcceleratedMatrix::SVDMode::Full;
+            if (options && options->get_or("values_only", false)) {
+                mode = AcceleratedMatrix::SVDMode::ValuesOnly;
+            } else if (options && options->get_or("economy", false)) {
+                mode = AcceleratedMatrix::SVDMode::Economy;
+            }
+            auto svd = matrix.svd(mode);
             
             sol::table result = lua->create_table();
-            result["U"] = U;
-            result["S"] = lua->create_table();
-            result["VT"] = VT;
-            
-            // Fill singular values table
-            sol::table S_table = result["S"];
-            for (size_t i = 0; i < S.size(); ++i) {
-                S_table[i + 1] = S[i];
+            result["S"] = sol::as_table(svd.singularValues);
+            if (mode != AcceleratedMatrix::SVDMode::ValuesOnly) {
+                result["U"] = svd.U;
+                result["VT"] = svd.VT;
             }
             
             return result;
@@ -1575,10 +1569,24 @@ void Sol2QtMainWindow::initializeSol2()
             return lua->create_table();
         }
     },
-        "luFactorization", &AcceleratedMatrix::luFactorization,
-        "qrDecomposition", &AcceleratedMatrix::qrDecomposition,
-//        "svd", &AcceleratedMatrix::svd,
 #endif
+        // Zero-copy views; each view keeps its matrix alive
+        "view", sol::overload(
+            sol::policies([](AcceleratedMatrix& m) { return m.view(); }, sol::self_dependency()),
+            sol::policies([](AcceleratedMatrix& m, size_t r0, size_t c0, size_t nr, size_t nc) {
+                return m.view(r0, c0, nr, nc);
+            }, sol::self_dependency())
+        ),
+        "row", sol::policies([](AcceleratedMatrix& m, size_t r) { return m.row(r); }, sol::self_dependency()),
+        "col", sol::policies([](AcceleratedMatrix& m, size_t c) { return m.column(c); }, sol::self_dependency()),
+        "toLuaMatrix", [](const AcceleratedMatrix& m) { return LuaMatrix(m.view()); },
+        "toFloat32", [](const AcceleratedMatrix& m) { return AcceleratedMatrixF32(m); },
+        "toComplex", [](const AcceleratedMatrix& m) { return ComplexMatrix(m); },
+        "toSparse", sol::overload(
+            [](const AcceleratedMatrix& m) { return SparseMatrix::fromDense(m); },
+            [](const AcceleratedMatrix& m, double dropTolerance) { return SparseMatrix::fromDense(m, dropTolerance); }
+        ),
+        
         // Utility functions
         "fillRandom", sol::overload(
             [](AcceleratedMatrix& m) { m.fillRandom(); },
@@ -1588,11 +1596,333 @@ void Sol2QtMainWindow::initializeSol2()
         "toString", &AcceleratedMatrix::toString
     );
     
+    // Single-precision matrices: half the memory traffic and twice the SIMD
+    // lanes of AcceleratedMatrix, for workloads that tolerate ~7 digits
+    lua->new_usertype<AcceleratedMatrixF32>("AcceleratedMatrixF32",
+        sol::constructors<AcceleratedMatrixF32(size_t, size_t)>(),
+        
+        "get", &AcceleratedMatrixF32::get,
+        "set", &AcceleratedMatrixF32::set,
+        "getRows", &AcceleratedMatrixF32::getRows,
+        "getCols", &AcceleratedMatrixF32::getCols,
+        
+        "multiply", &AcceleratedMatrixF32::multiply,
+        "add", &AcceleratedMatrixF32::add,
+        "subtract", &AcceleratedMatrixF32::subtract,
+        "transpose", &AcceleratedMatrixF32::transpose,
+        "scale", &AcceleratedMatrixF32::scale,
+        "determinant", &AcceleratedMatrixF32::determinant,
+        "norm", &AcceleratedMatrixF32::norm,
+        
+        "addInPlace", &AcceleratedMatrixF32::addInPlace,
+        "subtractInPlace", &AcceleratedMatrixF32::subtractInPlace,
+        "scaleInPlace", &AcceleratedMatrixF32::scaleInPlace,
+        "axpy", &AcceleratedMatrixF32::axpy,
+        "gemm", [](AcceleratedMatrixF32& c, float alpha, const AcceleratedMatrixF32& a, const AcceleratedMatrixF32& b, float beta) {
+            c.gemm(alpha, a, b, beta);
+        },
+        "multiplyInto", &AcceleratedMatrixF32::multiplyInto,
+        "transposeInto", &AcceleratedMatrixF32::transposeInto,
+        "transposeInPlace", [transposeSquareInPlace](AcceleratedMatrixF32& m) { transposeSquareInPlace(m); },
+        "copyFrom", &AcceleratedMatrixF32::copyFrom,
+        
+        "multiplyVector", [](const AcceleratedMatrixF32& m, const std::vector<float>& x) {
+            return sol::as_table(m.multiplyVector(x));
+        },
+        "inverse", &AcceleratedMatrixF32::inverse,
+        "solve", [](const AcceleratedMatrixF32& m, const std::vector<float>& b) {
+            return sol::as_table(m.solve(b));
+        },
+        "solveMany", sol::resolve<AcceleratedMatrixF32(const AcceleratedMatrixF32&) const>(&AcceleratedMatrixF32::solve),
+        
+        "toFloat64", [](const AcceleratedMatrixF32& m) { return AcceleratedMatrix(m); },
+        "fillRandom", sol::overload(
+            [](AcceleratedMatrixF32& m) { m.fillRandom(); },
+            [](AcceleratedMatrixF32& m, double min, double max) { m.fillRandom(min, max); }
+        ),
+        "fillIdentity", &AcceleratedMatrixF32::fillIdentity,
+        "toString", &AcceleratedMatrixF32::toString
+    );
+    
+    // Complex matrices; complex scalars cross into Lua as (re, im) pairs
+    lua->new_usertype<ComplexMatrix>("ComplexMatrix",
+        sol::constructors<ComplexMatrix(size_t, size_t),
+                          ComplexMatrix(const AcceleratedMatrix&),
+                          ComplexMatrix(const AcceleratedMatrix&, const AcceleratedMatrix&)>(),
+        
+        "get", [](const ComplexMatrix& m, size_t r, size_t c) {
+            const ComplexMatrix::Complex z = m.get(r, c);
+            return std::make_tuple(z.real(), z.imag());
+        },
+        "set", sol::overload(
+            [](ComplexMatrix& m, size_t r, size_t c, double re) { m.set(r, c, {re, 0.0}); },
+            [](ComplexMatrix& m, size_t r, size_t c, double re, double im) { m.set(r, c, {re, im}); }
+        ),
+        "getRows", &ComplexMatrix::getRows,
+        "getCols", &ComplexMatrix::getCols,
+        
+        // Parts as AcceleratedMatrix
+        "real", &ComplexMatrix::real,
+        "imag", &ComplexMatrix::imag,
+        "abs", &ComplexMatrix::abs,
+        "arg", &ComplexMatrix::arg,
+        
+        "add", &ComplexMatrix::add,
+        "subtract", &ComplexMatrix::subtract,
+        "multiply", sol::overload(
+            &ComplexMatrix::multiply,
+            [](const ComplexMatrix& a, const AcceleratedMatrix& b) { return a.multiply(ComplexMatrix(b)); }
+        ),
+        "scale", sol::overload(
+            [](const ComplexMatrix& m, double re) { return m.scale({re, 0.0}); },
+            [](const ComplexMatrix& m, double re, double im) { return m.scale({re, im}); }
+        ),
+        "transpose", &ComplexMatrix::transpose,
+        "conjugate", &ComplexMatrix::conjugate,
+        "adjoint", &ComplexMatrix::adjoint,
+        "norm", &ComplexMatrix::norm,
+        
+        // zgesv-class: right-hand sides are ComplexMatrix columns
+        "solve", sol::resolve<ComplexMatrix(const ComplexMatrix&) const>(&ComplexMatrix::solve),
+        "inverse", &ComplexMatrix::inverse,
+        "determinant", [](const ComplexMatrix& m) {
+            const ComplexMatrix::Complex det = m.determinant();
+            return std::make_tuple(det.real(), det.imag());
+        },
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        // Eigenvalues as an n x 1 ComplexMatrix; eigenvectors adds the
+        // right eigenvectors as columns: {values = ..., vectors = ...}
+        "eigenvalues", [](const ComplexMatrix& m) {
+            const std::vector<ComplexMatrix::Complex> w = m.eigenvalues();
+            ComplexMatrix values(w.size(), 1);
+            std::copy(w.begin(), w.end(), values.getData());
+            return values;
+        },
+        "eigenvectors", [this](const ComplexMatrix& m) {
+            auto eigen = m.eigenvectors();
+            ComplexMatrix values(eigen.first.size(), 1);
+            std::copy(eigen.first.begin(), eigen.first.end(), values.getData());
+            sol::table result = lua->create_table();
+            result["values"] = values;
+            result["vectors"] = eigen.second;
+            return result;
+        },
+#endif
+        "fillIdentity", &ComplexMatrix::fillIdentity,
+        "toString", &ComplexMatrix::toString
+    );
+    
+    // Sparse matrices: assemble triplets with a SparseBuilder, then multiply
+    // in O(nnz). Formats are named "csr" / "csc" on the Lua side.
+    auto sparseFormat = [](const std::string& name) {
+        if (name == "csr" || name == "CSR") return SparseMatrix::Format::CSR;
+        if (name == "csc" || name == "CSC") return SparseMatrix::Format::CSC;
+        throw std::invalid_argument("Unknown sparse format '" + name + "' (expected csr or csc)");
+    };
+    
+    lua->new_usertype<SparseBuilder>("SparseBuilder",
+        sol::constructors<SparseBuilder(size_t, size_t)>(),
+        "add", &SparseBuilder::add,
+        "size", &SparseBuilder::size,
+        "reserve", &SparseBuilder::reserve,
+        "clear", &SparseBuilder::clear,
+        "getRows", &SparseBuilder::getRows,
+        "getCols", &SparseBuilder::getCols,
+        "build", sol::overload(
+            [](const SparseBuilder& b) { return b.build(); },
+            [sparseFormat](const SparseBuilder& b, const std::string& format) { return b.build(sparseFormat(format)); }
+        )
+    );
+    
+    lua->new_usertype<SparseMatrix>("SparseMatrix",
+        sol::constructors<SparseMatrix(size_t, size_t)>(),
+        "get", &SparseMatrix::get,
+        "getRows", &SparseMatrix::getRows,
+        "getCols", &SparseMatrix::getCols,
+        "nonZeros", &SparseMatrix::nonZeros,
+        "density", &SparseMatrix::density,
+        "isSymmetric", &SparseMatrix::isSymmetric,
+        "format", [](const SparseMatrix& m) {
+            return std::string(m.getFormat() == SparseMatrix::Format::CSR ? "csr" : "csc");
+        },
+        "toCSR", &SparseMatrix::toCSR,
+        "toCSC", &SparseMatrix::toCSC,
+        "toDense", &SparseMatrix::toDense,
+        "transpose", &SparseMatrix::transpose,
+        "scale", &SparseMatrix::scale,
+        
+        // SpMV / SpMM, multithreaded
+        "multiplyVector", [](const SparseMatrix& m, const std::vector<double>& x) {
+            return sol::as_table(m.multiplyVector(x));
+        },
+        "multiplyTransposeVector", [](const SparseMatrix& m, const std::vector<double>& x) {
+            return sol::as_table(m.multiplyTransposeVector(x));
+        },
+        "multiply", sol::resolve<AcceleratedMatrix(const AcceleratedMatrix&) const>(&SparseMatrix::multiply),
+        "multiplyTranspose", sol::resolve<AcceleratedMatrix(const AcceleratedMatrix&) const>(&SparseMatrix::multiplyTranspose),
+        "toString", &SparseMatrix::toString
+    );
+    
+    lua->set_function("create_sparse_builder", [](size_t rows, size_t cols) {
+        return SparseBuilder(rows, cols);
+    });
+
+    // 5-point Laplacian on a g x g grid; convection makes it nonsymmetric
+    lua->set_function("create_laplacian_2d", [](size_t grid, sol::optional<double> convection) {
+        return SparseMatrix::laplacian2d(grid, convection.value_or(0.0));
+    });
+    
+    lua->set_function("sparse_from_dense", sol::overload(
+        [](const AcceleratedMatrix& a) { return SparseMatrix::fromDense(a); },
+        [](const AcceleratedMatrix& a, double dropTolerance) { return SparseMatrix::fromDense(a, dropTolerance); },
+        [sparseFormat](const AcceleratedMatrix& a, double dropTolerance, const std::string& format) {
+            return SparseMatrix::fromDense(a, dropTolerance, sparseFormat(format));
+        }
+    ));
+    
+    // Strided views into AcceleratedMatrix storage (blocks, rows, columns, transposes)
+    lua->new_usertype<MatrixView>("MatrixView",
+        sol::no_constructor,
+        "get", &MatrixView::get,
+        "set", [](MatrixView& v, size_t r, size_t c, double value) { v.set(r, c, value); },
+        "getRows", &MatrixView::getRows,
+        "getCols", &MatrixView::getCols,
+        "isContiguous", &MatrixView::isContiguous,
+        
+        // Sub-views share the parent's storage and keep it alive
+        "view", sol::policies(&MatrixView::block, sol::self_dependency()),
+        "row", sol::policies(&MatrixView::row, sol::self_dependency()),
+        "col", sol::policies(&MatrixView::column, sol::self_dependency()),
+        "transpose", sol::policies(&MatrixView::transposed, sol::self_dependency()),
+        
+        // Kernels operating directly on the viewed elements
+        "toMatrix", [](const MatrixView& v) { return AcceleratedMatrix(v); },
+        "copyFrom", sol::overload(
+            [](MatrixView& v, const MatrixView& src) { MatrixKernels::copy(src, v); },
+            [](MatrixView& v, const AcceleratedMatrix& src) { MatrixKernels::copy(src.view(), v); }
+        ),
+        "fill", [](MatrixView& v, double value) { MatrixKernels::fill(v, value); },
+        "scale", [](MatrixView& v, double factor) { MatrixKernels::scale(v, factor); },
+        "multiply", sol::overload(
+            [](const MatrixView& a, const MatrixView& b) {
+                AcceleratedMatrix result(a.getRows(), b.getCols());
+                AcceleratedMatrix::gemm(1.0, a, b, 0.0, result.view());
+                return result;
+            },
+            [](const MatrixView& a, const AcceleratedMatrix& b) {
+                AcceleratedMatrix result(a.getRows(), b.getCols());
+                AcceleratedMatrix::gemm(1.0, a, b.view(), 0.0, result.view());
+                return result;
+            }
+        ),
+        "multiplyVector", [](const MatrixView& a, const std::vector<double>& x) {
+            if (x.size() != a.getCols()) throw std::invalid_argument("Vector size incompatible with matrix columns");
+            std::vector<double> y(a.getRows());
+            MatrixKernels::gemv(a, x.data(), y.data());
+            return sol::as_table(y);
+        },
+        "toString", [](const MatrixView& v) { return AcceleratedMatrix(v).toString(); }
+    );
+    
+    // Lazy element-wise expressions, evaluated in one fused pass. Every
+    // expression keeps the matrices and sub-expressions it reads alive.
+    lua->new_usertype<MatrixExpression>("MatrixExpression",
+        sol::no_constructor,
+        "getRows", &MatrixExpression::getRows,
+        "getCols", &MatrixExpression::getCols,
+        "add", sol::overload(
+            sol::policies([](const MatrixExpression& e, const MatrixExpression& o) { return e.add(o); }, sol::stack_dependencies(-1, 1, 2)),
+            sol::policies([](const MatrixExpression& e, const AcceleratedMatrix& m) { return e.add(m); }, sol::stack_dependencies(-1, 1, 2))
+        ),
+        "subtract", sol::overload(
+            sol::policies([](const MatrixExpression& e, const MatrixExpression& o) { return e.subtract(o); }, sol::stack_dependencies(-1, 1, 2)),
+            sol::policies([](const MatrixExpression& e, const AcceleratedMatrix& m) { return e.subtract(m); }, sol::stack_dependencies(-1, 1, 2))
+        ),
+        "multiply", sol::overload(
+            sol::policies([](const MatrixExpression& e, const MatrixExpression& o) { return e.multiply(o); }, sol::stack_dependencies(-1, 1, 2)),
+            sol::policies([](const MatrixExpression& e, const AcceleratedMatrix& m) { return e.multiply(m); }, sol::stack_dependencies(-1, 1, 2))
+        ),
+        "scale", sol::policies(&MatrixExpression::scale, sol::stack_dependencies(-1, 1)),
+        "addScalar", sol::policies(&MatrixExpression::addScalar, sol::stack_dependencies(-1, 1)),
+        "evaluate", &MatrixExpression::evaluate,
+        "evaluateInto", &MatrixExpression::evaluateInto
+    );
+    
+    lua->set_function("lazy", sol::policies([](const AcceleratedMatrix& m) { return MatrixExpression(m); },
+                                            sol::stack_dependencies(-1, 1)));
+    
     // Factory functions for accelerated matrices
     lua->set_function("create_accelerated_matrix", [](size_t rows, size_t cols) {
         return AcceleratedMatrix(rows, cols);
     });
     
+    lua->set_function("create_accelerated_matrix_f32", [](size_t rows, size_t cols) {
+        return AcceleratedMatrixF32(rows, cols);
+    });
+    
+    lua->set_function("create_complex_matrix", [](size_t rows, size_t cols) {
+        return ComplexMatrix(rows, cols);
+    });
+    
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+    // Eigenvalues of a real matrix (dgeev) as an n x 1 ComplexMatrix
+    lua->set_function("complex_eigenvalues", [](const AcceleratedMatrix& a) {
+        const auto eigen = a.eigenvalues();
+        return ComplexMatrix::fromParts(eigen.first, eigen.second);
+    });
+#endif
+
+    // eig(A [, {vectors = true, range = {k_low, k_high}, symmetric = bool}])
+    // Symmetric A (detected unless symmetric is given) returns
+    // {values = {...} ascending, vectors = AcceleratedMatrix, symmetric = true};
+    // range picks eigenpairs k_low..k_high (1-based, ascending) through the
+    // MRRR driver. Other matrices (LAPACK only, no range) return
+    // {real = {...}, imag = {...}, vectors = ComplexMatrix, symmetric = false}.
+    lua->set_function("eig", [this](const AcceleratedMatrix& a, sol::optional<sol::table> options) {
+        bool computeVectors = true;
+        sol::optional<bool> symmetric;
+        sol::optional<sol::table> range;
+        if (options) {
+            computeVectors = options->get_or("vectors", true);
+            symmetric = options->get<sol::optional<bool>>("symmetric");
+            range = options->get<sol::optional<sol::table>>("range");
+        }
+
+        sol::table result = lua->create_table();
+        if (symmetric.value_or(a.isSymmetric())) {
+            std::pair<std::vector<double>, AcceleratedMatrix> eigen;
+            if (range) {
+                const size_t low = (*range)[1].get_or<size_t>(0), high = (*range)[2].get_or<size_t>(0);
+                if (low < 1 || high < low) throw std::out_of_range("eig: range must be {k_low, k_high} with 1 <= k_low <= k_high");
+                eigen = a.eigenSymmetric(computeVectors, low - 1, high - 1);
+            } else {
+                eigen = a.eigenSymmetric(computeVectors);
+            }
+            result["values"] = sol::as_table(eigen.first);
+            if (computeVectors) result["vectors"] = eigen.second;
+            result["symmetric"] = true;
+            return result;
+        }
+
+        if (range) throw std::invalid_argument("eig: range requires a symmetric matrix");
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+        if (computeVectors) {
+            auto [wr, wi, packed] = a.eigenvectors();
+            result["real"] = sol::as_table(wr);
+            result["imag"] = sol::as_table(wi);
+            result["vectors"] = ComplexMatrix::fromEigenvectors(wi, packed);
+        } else {
+            auto [wr, wi] = a.eigenvalues();
+            result["real"] = sol::as_table(wr);
+            result["imag"] = sol::as_table(wi);
+        }
+        result["symmetric"] = false;
+        return result;
+#else
+        throw std::runtime_error("eig: nonsymmetric matrices need LAPACK");
+#endif
+    });
+
     lua->set_function("create_accelerated_identity", [](size_t size) {
         AcceleratedMatrix m(size, size);
         m.fillIdentity();
@@ -1605,6 +1935,394 @@ void Sol2QtMainWindow::initializeSol2()
         return m;
     });
 
+    // Reusable factorizations: factor once, then O(n^2) per right-hand side
+    lua->new_usertype<LUFactorization>("LUFactorization",
+        sol::constructors<LUFactorization(const AcceleratedMatrix&)>(),
+        "size", &LUFactorization::size,
+        "isSingular", &LUFactorization::isSingular,
+        "solve", [](const LUFactorization& f, const std::vector<double>& b) {
+            return sol::as_table(f.solve(b));
+        },
+        "solveMany", &LUFactorization::solveMany,
+        "determinant", &LUFactorization::determinant,
+        "rcond", &LUFactorization::rcond
+    );
+    
+    lua->new_usertype<CholeskyFactorization>("CholeskyFactorization",
+        sol::constructors<CholeskyFactorization(const AcceleratedMatrix&)>(),
+        "size", &CholeskyFactorization::size,
+        "isPositiveDefinite", &CholeskyFactorization::isPositiveDefinite,
+        "getL", &CholeskyFactorization::getL,
+        "solve", [](const CholeskyFactorization& f, const std::vector<double>& b) {
+            return sol::as_table(f.solve(b));
+        },
+        "solveMany", &CholeskyFactorization::solveMany,
+        "determinant", &CholeskyFactorization::determinant,
+        "rcond", &CholeskyFactorization::rcond
+    );
+    
+    lua->new_usertype<QRFactorization>("QRFactorization",
+        sol::constructors<QRFactorization(const AcceleratedMatrix&)>(),
+        "getRows", &QRFactorization::getRows,
+        "getCols", &QRFactorization::getCols,
+        "getR", &QRFactorization::getR,
+        "solve", [](const QRFactorization& f, const std::vector<double>& b) {
+            return sol::as_table(f.solve(b));
+        },
+        "solveMany", &QRFactorization::solveMany,
+        "determinant", &QRFactorization::determinant,
+        "rcond", &QRFactorization::rcond
+    );
+    
+    lua->set_function("lu_factor", [](const AcceleratedMatrix& a) {
+        return LUFactorization(a);
+    });
+    
+    lua->set_function("cholesky_factor", [](const AcceleratedMatrix& a) {
+        return CholeskyFactorization(a);
+    });
+    
+    lua->set_function("qr_factor", [](const AcceleratedMatrix& a) {
+        return QRFactorization(a);
+    });
+    
+    // Mixed-precision solve: float32 LU, float64 iterative refinement.
+    // Returns {x = {...}, iterations = n, backward_error = e, fallback = bool}
+    auto refinedTable = [this](const RefinedSolution& solution) {
+        sol::table result = lua->create_table();
+        result["x"] = sol::as_table(solution.x);
+        result["iterations"] = solution.iterations;
+        result["backward_error"] = solution.backwardError;
+        result["fallback"] = solution.usedFallback;
+        return result;
+    };
+    lua->set_function("solve_refined", sol::overload(
+        [refinedTable](const AcceleratedMatrix& a, const std::vector<double>& b) {
+            return refinedTable(solveRefined(a, b));
+        },
+        [refinedTable](const AcceleratedMatrix& a, const std::vector<double>& b, int maxIterations) {
+            return refinedTable(solveRefined(a, b, maxIterations));
+        }
+    ));
+
+    // Matrix-free operators. A Lua kernel is function(x) returning A*x on
+    // vector tables or, with batched = true, function(X) returning A*X on
+    // an AcceleratedMatrix whose columns are the vectors: one Lua call per
+    // block instead of one per vector.
+    //   linear_operator(A)                    dense or sparse matrix
+    //   linear_operator(rows, cols, f [, {transpose = ft, batched = bool}])
+    //   kronecker_operator(A, B)              A (x) B, never formed
+    auto luaVectorFunction = [this](const sol::protected_function& f, size_t inSize, size_t outSize,
+                                    const std::string& what) {
+        return [this, f, inSize, outSize, what](const double* x, double* y) {
+            sol::table input = lua->create_table(static_cast<int>(inSize), 0);
+            for (size_t i = 0; i < inSize; ++i) input[i + 1] = x[i];
+            sol::protected_function_result output = f(input);
+            if (!output.valid()) {
+                sol::error err = output;
+                throw std::runtime_error(what + " callback failed: " + err.what());
+            }
+            sol::table values = output;
+            if (values.size() != outSize) {
+                throw std::runtime_error(what + " callback returned " + std::to_string(values.size()) +
+                                         " entries, expected " + std::to_string(outSize));
+            }
+            for (size_t i = 0; i < outSize; ++i) y[i] = values[i + 1].get_or(0.0);
+        };
+    };
+
+    auto luaBatchFunction = [](const sol::protected_function& f, size_t inSize, size_t outSize,
+                               const std::string& what) {
+        return [f, inSize, outSize, what](size_t count, const double* x, double* y) {
+            AcceleratedMatrix input(inSize, count);
+            MatrixKernels::copy(ConstMatrixView::columnMajor(x, inSize, count, inSize), input.view());
+            sol::protected_function_result output = f(input);
+            if (!output.valid()) {
+                sol::error err = output;
+                throw std::runtime_error(what + " callback failed: " + err.what());
+            }
+            sol::object result = output;
+            if (!result.is<AcceleratedMatrix>()) {
+                throw std::runtime_error(what + " callback must return an AcceleratedMatrix in batched mode");
+            }
+            const AcceleratedMatrix& product = result.as<const AcceleratedMatrix&>();
+            if (product.getRows() != outSize || product.getCols() != count) {
+                throw std::runtime_error(what + " callback returned a " + std::to_string(product.getRows()) + "x" +
+                                         std::to_string(product.getCols()) + " matrix, expected " +
+                                         std::to_string(outSize) + "x" + std::to_string(count));
+            }
+            MatrixKernels::copy(product.view(), MatrixView::columnMajor(y, outSize, count, outSize));
+        };
+    };
+
+    auto luaOperator = [=](size_t rows, size_t cols, const sol::protected_function& f,
+                           const sol::optional<sol::table>& options) {
+        bool batched = false;
+        sol::optional<sol::protected_function> transpose;
+        if (options) {
+            batched = options->get_or("batched", false);
+            transpose = options->get<sol::optional<sol::protected_function>>("transpose");
+        }
+        if (batched) {
+            LinearOperator::Kernel transposeKernel;
+            if (transpose) transposeKernel = luaBatchFunction(*transpose, rows, cols, "Transpose");
+            return LinearOperator(rows, cols, luaBatchFunction(f, cols, rows, "Operator"), transposeKernel);
+        }
+        LinearOperator::VectorKernel transposeKernel;
+        if (transpose) transposeKernel = luaVectorFunction(*transpose, rows, cols, "Transpose");
+        return LinearOperator::fromVectorKernel(rows, cols, luaVectorFunction(f, cols, rows, "Operator"),
+                                                transposeKernel);
+    };
+
+    lua->new_usertype<LinearOperator>("LinearOperator",
+        sol::no_constructor,
+        "getRows", &LinearOperator::getRows,
+        "getCols", &LinearOperator::getCols,
+        "hasTranspose", &LinearOperator::hasTranspose,
+        "transpose", &LinearOperator::transpose,
+        "multiplyVector", [](const LinearOperator& a, const std::vector<double>& x) {
+            return sol::as_table(a.multiplyVector(x));
+        },
+        "multiplyTransposeVector", [](const LinearOperator& a, const std::vector<double>& x) {
+            return sol::as_table(a.multiplyTransposeVector(x));
+        },
+        "multiply", &LinearOperator::multiply,
+        "multiplyTranspose", &LinearOperator::multiplyTranspose,
+        "toDense", [](const LinearOperator& a) { return a.toDense(); },
+        "toString", &LinearOperator::toString
+    );
+
+    lua->set_function("linear_operator", sol::overload(
+        [](const AcceleratedMatrix& a) { return LinearOperator(a); },
+        [](const SparseMatrix& a) { return LinearOperator(a); },
+        [luaOperator](size_t rows, size_t cols, const sol::protected_function& f, sol::optional<sol::table> options) {
+            return luaOperator(rows, cols, f, options);
+        }
+    ));
+
+    lua->set_function("kronecker_operator", [](const AcceleratedMatrix& a, const AcceleratedMatrix& b) {
+        return LinearOperator::kronecker(a, b);
+    });
+
+    // Krylov solvers: solve_cg (SPD), solve_bicgstab and solve_gmres. A is an
+    // AcceleratedMatrix, a SparseMatrix, a LinearOperator or a function(x)
+    // returning A*x as a table. Options: tolerance, max_iterations, restart
+    // (GMRES), x0 and preconditioner = "jacobi" | "ilu0" | "ic" (matrices
+    // only) or a function(r) returning M^-1 r.
+    // Returns {x = {...}, converged = bool, iterations = n, residual = r, history = {...}}
+    auto iterativeOptions = [](const sol::optional<sol::table>& table) {
+        IterativeOptions options;
+        if (!table) return options;
+        options.tolerance = table->get_or("tolerance", options.tolerance);
+        options.maxIterations = table->get_or("max_iterations", options.maxIterations);
+        options.restart = table->get_or("restart", options.restart);
+        if (sol::optional<std::vector<double>> x0 = (*table)["x0"]) options.initialGuess = *x0;
+        return options;
+    };
+
+    // Named preconditioners are built from the matrix; copies are cheap
+    // next to the solve and keep the std::function self-contained
+    auto namedPreconditioner = [](const auto& a, const std::string& name) -> Preconditioner {
+        if (name == "none") return Preconditioner();
+        if (name == "jacobi") return JacobiPreconditioner(a);
+        if (name == "ilu0" || name == "ilu") return ILU0Preconditioner(a);
+        if (name == "ic" || name == "ic0") return IncompleteCholeskyPreconditioner(a);
+        throw std::invalid_argument("Unknown preconditioner '" + name + "' (expected jacobi, ilu0, ic or none)");
+    };
+
+    auto functionPreconditioner = [=](const sol::optional<sol::table>& table, size_t n) -> Preconditioner {
+        if (!table) return Preconditioner();
+        sol::object choice = (*table)["preconditioner"];
+        if (choice.is<sol::protected_function>()) {
+            return luaVectorFunction(choice.as<sol::protected_function>(), n, n, "Preconditioner");
+        }
+        if (choice.valid() && !(choice.is<std::string>() && choice.as<std::string>() == "none")) {
+            throw std::invalid_argument("Operators without a stored matrix take only a function preconditioner");
+        }
+        return Preconditioner();
+    };
+
+    auto matrixPreconditioner = [=](const auto& a, const sol::optional<sol::table>& table) -> Preconditioner {
+        if (table) {
+            sol::object choice = (*table)["preconditioner"];
+            if (choice.is<std::string>()) return namedPreconditioner(a, choice.as<std::string>());
+        }
+        return functionPreconditioner(table, a.getRows());
+    };
+
+    auto iterativeTable = [this](const IterativeResult& result) {
+        sol::table table = lua->create_table();
+        table["x"] = sol::as_table(result.x);
+        table["converged"] = result.converged;
+        table["iterations"] = result.iterations;
+        table["residual"] = result.residualNorm;
+        table["history"] = sol::as_table(result.residualHistory);
+        return table;
+    };
+
+    using IterativeSolver = IterativeResult (*)(size_t, const OperatorApply&, const std::vector<double>&,
+                                                const IterativeOptions&, const Preconditioner&);
+    auto bindIterativeSolver = [&](const std::string& name, IterativeSolver solver) {
+        auto run = [=](size_t n, const OperatorApply& a, const std::vector<double>& b,
+                       const sol::optional<sol::table>& table, const Preconditioner& m) {
+            return iterativeTable(solver(n, a, b, iterativeOptions(table), m));
+        };
+        lua->set_function(name, sol::overload(
+            [=](const AcceleratedMatrix& a, const std::vector<double>& b, sol::optional<sol::table> t) {
+                return run(a.getRows(), IterativeSolvers::asOperator(a), b, t, matrixPreconditioner(a, t));
+            },
+            [=](const SparseMatrix& a, const std::vector<double>& b, sol::optional<sol::table> t) {
+                return run(a.getRows(), IterativeSolvers::asOperator(a), b, t, matrixPreconditioner(a, t));
+            },
+            [=](const LinearOperator& a, const std::vector<double>& b, sol::optional<sol::table> t) {
+                return run(a.getRows(), IterativeSolvers::asOperator(a), b, t, functionPreconditioner(t, a.getRows()));
+            },
+            [=](const sol::protected_function& a, const std::vector<double>& b, sol::optional<sol::table> t) {
+                const size_t n = b.size();
+                return run(n, luaVectorFunction(a, n, n, "Operator"), b, t, functionPreconditioner(t, n));
+            }
+        ));
+    };
+    bindIterativeSolver("solve_cg", &IterativeSolvers::conjugateGradient);
+    bindIterativeSolver("solve_bicgstab", &IterativeSolvers::bicgstab);
+    bindIterativeSolver("solve_gmres", &IterativeSolvers::gmres);
+
+    // A few eigen- or singular values by restarted Lanczos / Arnoldi, for
+    // large sparse and matrix-free problems where eig() and svd() are O(n^3).
+    //   eigs(A, k [, opts])   A: AcceleratedMatrix, SparseMatrix or LinearOperator
+    //   svds(A, k [, opts])   LinearOperators need a transpose kernel
+    // Options: which = "largest" | "smallest" | "magnitude", symmetric (detected
+    // for matrices, assumed false for operators), tolerance, max_restarts,
+    // subspace (Krylov dimension), v0 (start vector).
+    // eigs returns {values, vectors, converged, restarts, applications} for
+    // symmetric A, or {real, imag, vectors = ComplexMatrix, ...} otherwise
+    // (LAPACK only); svds returns {values, U, V, converged, restarts, applications}.
+    auto eigenOptions = [](const sol::optional<sol::table>& table) {
+        EigenSolvers::Options options;
+        if (!table) return options;
+        const std::string which = table->get_or("which", std::string("largest"));
+        if (which == "largest") options.which = EigenSolvers::Which::Largest;
+        else if (which == "smallest") options.which = EigenSolvers::Which::Smallest;
+        else if (which == "magnitude") options.which = EigenSolvers::Which::LargestMagnitude;
+        else throw std::invalid_argument("Unknown which '" + which + "' (expected largest, smallest or magnitude)");
+        options.tolerance = table->get_or("tolerance", options.tolerance);
+        options.maxRestarts = table->get_or("max_restarts", options.maxRestarts);
+        options.subspaceSize = table->get_or("subspace", options.subspaceSize);
+        if (sol::optional<std::vector<double>> v0 = (*table)["v0"]) options.initialVector = *v0;
+        return options;
+    };
+
+    auto eigsTable = [this, eigenOptions](const LinearOperator& a, size_t k, bool detectedSymmetric,
+                                           const sol::optional<sol::table>& table) {
+        bool symmetric = detectedSymmetric;
+        if (table) symmetric = table->get_or("symmetric", symmetric);
+        const EigenSolvers::Options options = eigenOptions(table);
+
+        sol::table result = lua->create_table();
+        if (symmetric) {
+            const EigenSolvers::EigenResult eigen = EigenSolvers::symmetricEigs(a, k, options);
+            result["values"] = sol::as_table(eigen.values);
+            result["vectors"] = eigen.vectors;
+            result["converged"] = eigen.converged;
+            result["restarts"] = eigen.restarts;
+            result["applications"] = eigen.operatorApplications;
+        } else {
+            const EigenSolvers::EigenResult eigen = EigenSolvers::eigs(a, k, options);
+            result["real"] = sol::as_table(eigen.values);
+            result["imag"] = sol::as_table(eigen.imag);
+            result["vectors"] = ComplexMatrix::fromEigenvectors(eigen.imag, eigen.vectors);
+            result["converged"] = eigen.converged;
+            result["restarts"] = eigen.restarts;
+            result["applications"] = eigen.operatorApplications;
+        }
+        result["symmetric"] = symmetric;
+        return result;
+    };
+
+    lua->set_function("eigs", sol::overload(
+        [eigsTable](const AcceleratedMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return eigsTable(LinearOperator::borrow(a), k, a.isSymmetric(), t);
+        },
+        [eigsTable](const SparseMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return eigsTable(LinearOperator::borrow(a), k, a.isSymmetric(), t);
+        },
+        [eigsTable](const LinearOperator& a, size_t k, sol::optional<sol::table> t) {
+            return eigsTable(a, k, false, t);
+        }
+    ));
+
+    auto svdsTable = [this, eigenOptions](const LinearOperator& a, size_t k, const sol::optional<sol::table>& table) {
+        const EigenSolvers::SingularResult svd = EigenSolvers::svds(a, k, eigenOptions(table));
+        sol::table result = lua->create_table();
+        result["values"] = sol::as_table(svd.values);
+        result["U"] = svd.u;
+        result["V"] = svd.v;
+        result["converged"] = svd.converged;
+        result["restarts"] = svd.restarts;
+        result["applications"] = svd.operatorApplications;
+        return result;
+    };
+
+    lua->set_function("svds", sol::overload(
+        [svdsTable](const AcceleratedMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return svdsTable(LinearOperator::borrow(a), k, t);
+        },
+        [svdsTable](const SparseMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return svdsTable(LinearOperator::borrow(a), k, t);
+        },
+        [svdsTable](const LinearOperator& a, size_t k, sol::optional<sol::table> t) {
+            return svdsTable(a, k, t);
+        }
+    ));
+
+    // Randomized rank-k SVD at O(m n k) cost:
+    //   svd_truncated(A, k [, {oversample = 10, power_iters = 2, seed}])
+    // returns {U = m x k, S = {...}, VT = k x n} like svd();
+    //   low_rank_approximation(A, k [, opts]) returns U diag(S) VT.
+    // A is an AcceleratedMatrix, SparseMatrix or LinearOperator with transpose.
+    auto randomizedOptions = [](const sol::optional<sol::table>& table) {
+        EigenSolvers::RandomizedOptions options;
+        if (!table) return options;
+        options.oversample = table->get_or("oversample", options.oversample);
+        options.powerIterations = table->get_or("power_iters", options.powerIterations);
+        options.seed = table->get_or("seed", options.seed);
+        return options;
+    };
+
+    auto truncatedTable = [this, randomizedOptions](const LinearOperator& a, size_t k,
+                                                     const sol::optional<sol::table>& table) {
+        const EigenSolvers::TruncatedSvd svd = EigenSolvers::randomizedSvd(a, k, randomizedOptions(table));
+        sol::table result = lua->create_table();
+        result["U"] = svd.u;
+        result["S"] = sol::as_table(svd.values);
+        result["VT"] = svd.vt;
+        return result;
+    };
+
+    lua->set_function("svd_truncated", sol::overload(
+        [truncatedTable](const AcceleratedMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return truncatedTable(LinearOperator::borrow(a), k, t);
+        },
+        [truncatedTable](const SparseMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return truncatedTable(LinearOperator::borrow(a), k, t);
+        },
+        [truncatedTable](const LinearOperator& a, size_t k, sol::optional<sol::table> t) {
+            return truncatedTable(a, k, t);
+        }
+    ));
+
+    lua->set_function("low_rank_approximation", sol::overload(
+        [randomizedOptions](const AcceleratedMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return EigenSolvers::randomizedSvd(LinearOperator::borrow(a), k, randomizedOptions(t)).approximation();
+        },
+        [randomizedOptions](const SparseMatrix& a, size_t k, sol::optional<sol::table> t) {
+            return EigenSolvers::randomizedSvd(LinearOperator::borrow(a), k, randomizedOptions(t)).approximation();
+        },
+        [randomizedOptions](const LinearOperator& a, size_t k, sol::optional<sol::table> t) {
+            return EigenSolvers::randomizedSvd(a, k, randomizedOptions(t)).approximation();
+        }
+    ));
+
     // Performance timing utilities
     lua->set_function("benchmark_matrix_multiply", [](size_t size, int iterations) {
         AcceleratedMatrix a(size, size);
@@ -1615,7 +2333,7 @@ void Sol2QtMainWindow::initializeSol2()
         auto start = std::chrono::high_resolution_clock::now();
         
         for (int i = 0; i < iterations; ++i) {
-#ifdef __APPLE__
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
             auto result = a.multiplyAccelerate(b);
 #else
             auto result = a.multiply(b);
@@ -1630,23 +2348,90 @@ void Sol2QtMainWindow::initializeSol2()
 
     // Memory usage estimation
     lua->set_function("estimate_matrix_memory", [](size_t rows, size_t cols) {
-        double bytes = rows * cols * sizeof(double);
+        double bytes = AcceleratedMatrix::paddedLeadingDimension(rows) * cols * sizeof(double);
         double mb = bytes / (1024.0 * 1024.0);
         return mb;
     });
     
     // System information
     lua->set_function("get_accelerate_info", []() -> std::string {
+        std::string info;
 #ifdef __APPLE__
-        return "macOS Accelerate Framework available\n"
+        info = "macOS Accelerate Framework available\n"
                "- Optimized BLAS/LAPACK routines\n"
                "- Multi-threaded operations\n"
                "- SIMD vectorization\n"
-               "- Apple Silicon / Intel optimized";
+               "- Apple Silicon / Intel optimized\n";
+#elif defined(ACCELERATED_MATRIX_HAS_LAPACK)
+        info = "System BLAS/LAPACK available\n"
+               "- OpenBLAS / reference LAPACK routines\n"
+               "- Full AcceleratedMatrix method set\n"
+               "- dgemm / dgemv / dgesv / dgeev / dgesdd / dsyevd\n";
 #else
-        return "Accelerate Framework not available\n"
-               "Using basic C++ implementations";
+        info = "Accelerate Framework not available\n"
+               "Using built-in C++ kernels\n";
 #endif
+        info += "- Kernel variant: " + MatrixKernels::kernelVariantName() + "\n";
+        info += "- Backend: " + std::string(MatrixBackends::active().name) + " (" +
+                MatrixBackends::active().description + ")\n";
+        info += "- Threads: " + std::to_string(MatrixThreadPool::instance().getThreadCount());
+        return info;
+    });
+    
+    // Runtime-dispatched kernel variants (generic / sse4.2 / avx2 / avx512)
+    lua->set_function("get_matrix_kernel_variant", []() {
+        return std::string(MatrixKernels::activeKernels().name);
+    });
+    
+    lua->set_function("list_matrix_kernel_variants", []() {
+        return MatrixKernels::supportedKernelVariants();
+    });
+    
+    lua->set_function("set_matrix_kernel_variant", [](const std::string& name) {
+        return MatrixKernels::setKernelVariant(name);
+    });
+    
+    // Linear algebra backend behind multiply / multiplyVector / gram / LU /
+    // solve / inverse for Matrix and AcceleratedMatrix ("naive", "builtin",
+    // "openblas" or "accelerate", "eigen"; see list_matrix_backends())
+    lua->set_function("list_matrix_backends", []() {
+        return MatrixBackends::available();
+    });
+    
+    lua->set_function("get_matrix_backend", []() {
+        return std::string(MatrixBackends::active().name);
+    });
+    
+    lua->set_function("set_matrix_backend", [](const std::string& name) {
+        return MatrixBackends::setActive(name);
+    });
+    
+    // Thread pool used by the built-in matrix kernels
+    lua->set_function("set_matrix_threads", [](size_t count) {
+        MatrixThreadPool::instance().setThreadCount(count);
+        return MatrixThreadPool::instance().getThreadCount();
+    });
+    
+    lua->set_function("get_matrix_threads", []() {
+        return MatrixThreadPool::instance().getThreadCount();
+    });
+    
+    lua->set_function("set_matrix_serial_cutoff", [](size_t work) {
+        MatrixThreadPool::instance().setSerialCutoff(work);
+    });
+    
+    lua->set_function("get_matrix_serial_cutoff", []() {
+        return MatrixThreadPool::instance().getSerialCutoff();
+    });
+    
+    // Matrices whose buffer reaches this many bytes are backed by huge pages
+    // where the OS supports it (0 disables)
+    lua->set_function("set_matrix_huge_page_threshold", [](size_t bytes) {
+        setMatrixHugePageThreshold(bytes);
+    });
+    
+    lua->set_function("get_matrix_huge_page_threshold", []() {
+        return getMatrixHugePageThreshold();
     });
     
     // FLOPS calculation utilities
@@ -1658,48 +2443,11 @@ void Sol2QtMainWindow::initializeSol2()
 
     // Condition number estimation
     lua->set_function("estimate_condition_number", [](const AcceleratedMatrix& matrix) -> double {
-#ifdef __APPLE__
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
         try {
-	    // SVD using Accelerate LAPACK
-	    AcceleratedMatrix a_copy = matrix;
-
-	    int m = static_cast<int>(matrix.getRows());
-	    int n = static_cast<int>(matrix.getCols());
-	    int lda = m;
-	    int min_mn = std::min(m, n);
-
-	    char jobu = 'A', jobvt = 'A';  // Compute full U and VT
-
-	    AcceleratedMatrix U(m, m);
-	    AcceleratedMatrix VT(n, n);
-	    std::vector<double> S(min_mn);
-
-	    int ldu = m, ldvt = n;
-
-	    // Query optimal workspace size
-	    double work_query;
-	    int lwork = -1;
-	    int info;
-
-	    dgesvd_(&jobu, &jobvt, &m, &n, a_copy.getData(), &lda,
-		    S.data(), U.getData(), &ldu, VT.getData(), &ldvt,
-		    &work_query, &lwork, &info);
-
-	    // Perform SVD
-	    lwork = static_cast<int>(work_query);
-	    std::vector<double> work(lwork);
-
-	    dgesvd_(&jobu, &jobvt, &m, &n, a_copy.getData(), &lda,
-		    S.data(), U.getData(), &ldu, VT.getData(), &ldvt,
-		    work.data(), &lwork, &info);
-
-	    if (info < 0) {
-		throw std::runtime_error("LAPACK dgesvd: illegal parameter at position " + std::to_string(-info));
-	    } else if (info > 0) {
-		throw std::runtime_error("SVD failed to converge");
-	    }
-        
-            const auto& singular_values = S;
+            // Singular values only: no U / VT factors are formed
+            const std::vector<double> singular_values =
+                matrix.svd(AcceleratedMatrix::SVDMode::ValuesOnly).singularValues;
             if (singular_values.empty()) return -1.0;
             
             double max_sv = *std::max_element(singular_values.begin(), singular_values.end());
@@ -1783,50 +2531,49 @@ void Sol2QtMainWindow::initializeSol2()
     });
     
     // Specialized linear algebra functions
-    lua->set_function("solve_least_squares", [](const AcceleratedMatrix& A, const std::vector<double>& b) {
-#ifdef __APPLE__
-        // Use QR decomposition for least squares: A = QR, then solve Rx = Q^T b
-        try {
-            auto [Q, R] = A.qrDecomposition();
-            auto QT_b = Q.transpose().multiplyVector(b);
-            
-            // Back-substitution for upper triangular R
-            size_t n = R.getCols();
-            std::vector<double> x(n, 0.0);
-            
-            for (int i = n - 1; i >= 0; --i) {
-                double sum = QT_b[i];
-                for (size_t j = i + 1; j < n; ++j) {
-                    sum -= R.get(i, j) * x[j];
-                }
-                x[i] = sum / R.get(i, i);
+    // Dense A: QR, or the minimum-norm SVD solution when A is wide or
+    // numerically rank deficient. Sparse A or a LinearOperator with a
+    // transpose kernel: CGLS, never forming A^T A; takes the iterative
+    // solver options table.
+    lua->set_function("solve_least_squares", sol::overload(
+        [iterativeOptions](const SparseMatrix& A, const std::vector<double>& b, sol::optional<sol::table> options) {
+            return IterativeSolvers::leastSquares(LinearOperator::borrow(A), b, iterativeOptions(options)).x;
+        },
+        [iterativeOptions](const LinearOperator& A, const std::vector<double>& b, sol::optional<sol::table> options) {
+            return IterativeSolvers::leastSquares(A, b, iterativeOptions(options)).x;
+        },
+        [](const AcceleratedMatrix& A, const std::vector<double>& b) {
+            if (b.size() != A.getRows()) {
+                throw std::invalid_argument("Right-hand side size does not match the matrix rows");
             }
-            
-            return x;
-        } catch (...) {
-            // Fallback to normal equations
-            auto AT = A.transpose();
-            auto ATA = AT.multiplyAccelerate(A);
-            auto ATb = AT.multiplyVector(b);
-            return ATA.solve(ATb);
-        }
+            const double tolerance = static_cast<double>(std::max(A.getRows(), A.getCols())) *
+                                     std::numeric_limits<double>::epsilon();
+            if (A.getRows() >= A.getCols()) {
+                // Householder QR: Q^T b by reflectors (dormqr), then R x = Q^T b
+                // (dtrtrs); Q itself is never formed
+                QRFactorization qr(A);
+                if (qr.rcond() > tolerance) return qr.solve(b);
+            }
+            // Wide or numerically rank deficient: minimum-norm solution by SVD
+#ifdef ACCELERATED_MATRIX_HAS_LAPACK
+            return A.solveMinimumNorm(b);
 #else
-        // Normal equations: (A^T A) x = A^T b
-        auto AT = A.transpose();
-        auto ATA = AT.multiply(A);
-        auto ATb = AT.multiplyVector(b);
-        return ATA.solve(ATb);
+            throw std::runtime_error("solve_least_squares: wide or rank-deficient matrices need the "
+                                     "SVD, which requires LAPACK");
 #endif
-    });
+        }
+    ));
     
     // ... rest of existing initializeSol2() code ...
     
     outputDisplay->append("Accelerated matrix processing ready!");
-    outputDisplay->append("macOS Accelerate Framework: " + 
+    outputDisplay->append("Linear algebra backend: " + 
 #ifdef __APPLE__
-                         QString("Available")
+                         QString("macOS Accelerate Framework")
+#elif defined(ACCELERATED_MATRIX_HAS_LAPACK)
+                         QString("System BLAS/LAPACK")
 #else
-                         QString("Not Available")
+                         QString("Basic C++ (no BLAS/LAPACK)")
 #endif
     );
 
@@ -34,6 +34,13 @@
 #include <sol/sol.hpp>
 #include <sol/types.hpp>
 #include "AcceleratedMatrix.hpp"
+#include "MatrixFactorizations.hpp"
+#include "MatrixExpression.hpp"
+#include "ComplexMatrix.hpp"
+#include "SparseMatrix.hpp"
+#include "LinearOperator.hpp"
+#include "IterativeSolvers.hpp"
+#include "EigenSolvers.hpp"
 
 // Forward declarations
 class LuaWindowFactory;
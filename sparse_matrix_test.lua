@@ -0,0 +1,48 @@
+-- sparse_matrix_test.lua - SparseMatrix assembly and SpMV against dense storage
+
+print("=== SparseMatrix Test ===")
+
+-- Test 1: Small matrix round trip
+print("\n1. Builder and Conversion:")
+local builder = create_sparse_builder(3, 3)
+builder:add(0, 0, 1)
+builder:add(2, 1, 2)
+builder:add(2, 1, 3)  -- Duplicates are summed
+builder:add(1, 2, -1)
+local S = builder:build()
+print(S:toString())
+print("S[2,1] = " .. S:get(2, 1) .. " (expect 5)")
+print("Format after toCSC(): " .. S:toCSC():format())
+
+-- Test 2: SpMV vs dense multiplyVector
+print("\n2. SpMV vs Dense:")
+print("Unknowns | Nonzeros | Sparse (ms) | Dense (ms)")
+print("---------|----------|-------------|-----------")
+
+for _, g in ipairs({10, 20, 40, 300}) do
+    local A = create_laplacian_2d(g)
+    local n = A:getRows()
+    local x = {}
+    for i = 1, n do x[i] = 1.0 end
+
+    local start = get_time_ms()
+    local y = A:multiplyVector(x)
+    local sparse_time = get_time_ms() - start
+
+    -- Dense storage is n^2 doubles: only compare while it stays small
+    local dense_time = "-"
+    if n <= 1600 then
+        local D = A:toDense()
+        start = get_time_ms()
+        D:multiplyVector(x)
+        dense_time = tostring(get_time_ms() - start)
+    end
+
+    -- Row sums of the Laplacian: 0 inside, positive on the boundary
+    local sum = 0
+    for i = 1, n do sum = sum + y[i] end
+    print(string.format("%8d | %8d | %11d | %9s   (sum %.0f, expect %d)",
+          n, A:nonZeros(), sparse_time, dense_time, sum, 4 * g))
+end
+
+return "SparseMatrix test completed"
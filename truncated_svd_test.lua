@@ -0,0 +1,74 @@
+-- truncated_svd_test.lua - Randomized rank-k SVD and low-rank approximation
+
+print("=== Truncated SVD Test ===")
+
+-- Rank-r matrix with decaying singular values plus small noise
+local function low_rank_matrix(m, n, r, noise)
+    local L = create_accelerated_matrix(m, r)
+    local R = create_accelerated_matrix(r, n)
+    L:fillRandom(-1, 1)
+    R:fillRandom(-1, 1)
+    for i = 0, r-1 do
+        for j = 0, n-1 do R:set(i, j, R:get(i, j) * 0.8^i) end
+    end
+    local N = create_accelerated_matrix(m, n)
+    N:fillRandom(-noise, noise)
+    return L:multiply(R):add(N)
+end
+
+-- Test 1: Accuracy against the exact spectrum of A^T A
+print("\n1. Singular Values (5000 x 300, rank 20 + noise, k = 10):")
+local A = low_rank_matrix(5000, 300, 20, 1e-3)
+local exact = A:gram():eigenSymmetric(false).values
+
+print("power_iters | Time (ms) | Max rel. error | ||A - A_k|| / ||A||")
+print("------------|-----------|----------------|--------------------")
+for _, q in ipairs({0, 1, 2}) do
+    local start = get_time_ms()
+    local svd = svd_truncated(A, 10, {power_iters = q})
+    local time = get_time_ms() - start
+    local worst = 0
+    for i = 1, 10 do
+        local reference = math.sqrt(exact[301 - i])
+        worst = math.max(worst, math.abs(svd.S[i] - reference) / reference)
+    end
+    local approximation = low_rank_approximation(A, 10, {power_iters = q})
+    print(string.format("%11d | %9d | %14.3e | %.6f", q, time, worst,
+          approximation:subtract(A):norm() / A:norm()))
+end
+
+-- Test 2: Factor shapes and orthonormality
+print("\n2. Factors:")
+local svd = svd_truncated(A, 8)
+print(string.format("U %dx%d, VT %dx%d", svd.U:getRows(), svd.U:getCols(), svd.VT:getRows(), svd.VT:getCols()))
+local identity = create_accelerated_identity(8)
+print(string.format("||U^T U - I|| = %.2e, ||V^T V - I|| = %.2e",
+      svd.U:gram():subtract(identity):norm(),
+      svd.VT:transpose():gram():subtract(identity):norm()))
+
+-- Test 3: Full svd for comparison (LAPACK builds)
+local ok, full_time = pcall(function()
+    local start = get_time_ms()
+    A:svd()
+    return get_time_ms() - start
+end)
+if ok then
+    print(string.format("\n3. Full svd of the same matrix: %d ms", full_time))
+end
+
+-- Test 4: Sparse input through block products
+print("\n4. Sparse (2000 x 2000 tridiagonal, k = 5):")
+local builder = create_sparse_builder(2000, 2000)
+for i = 0, 1999 do
+    builder:add(i, i, 2)
+    if i > 0 then builder:add(i, i - 1, -1) end
+    if i < 1999 then builder:add(i, i + 1, -1) end
+end
+local T = builder:build()
+local sparse = svd_truncated(T, 5, {power_iters = 4, oversample = 20})
+for i = 1, 5 do
+    local exact_value = 2 + 2 * math.cos(math.pi * i / 2001)
+    print(string.format("  sigma_%d = %.8f (exact %.8f)", i, sparse.S[i], exact_value))
+end
+
+print("\n=== Truncated SVD Test Complete ===")